@@ -0,0 +1,694 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <limits.h>
+
+/*
+   Sparse LU solver for large, mostly-zero systems A x = b.
+
+   Pipeline:
+     1. Read A from a Matrix Market file into compressed-column (CSC) form.
+     2. Fill-reducing ordering: approximate minimum degree on the pattern
+        of A + A^T (quotient graph with element absorption).
+     3. Symbolic factorization: elimination tree and column counts of the
+        permuted matrix, used to size L and U before the numeric phase.
+     4. Numeric factorization: left-looking (Gilbert-Peierls) LU with
+        threshold partial pivoting. Each column is a sparse triangular
+        solve, so work is proportional to the flops, not n^2.
+     5. Forward/back substitution with the permutations.
+
+   Usage:
+     Sparse_LU matrix.mtx          solve A x = A*1 and report the residual
+     Sparse_LU --grid N            use an N x N convection-diffusion grid
+*/
+
+#define PIVOT_TOL 0.1   // prefer the diagonal if |a_kk| >= PIVOT_TOL * max
+
+/* Compressed sparse column matrix */
+typedef struct {
+    int n, m;        // rows, columns
+    int nzmax;       // allocated entries
+    int *colptr;     // column pointers (m+1)
+    int *rowind;     // row indices (nzmax)
+    double *val;     // values (nzmax)
+} CscMatrix;
+
+/* ---------- Allocation ---------- */
+CscMatrix *csc_alloc(int n, int m, int nzmax) {
+    CscMatrix *A = (CscMatrix *)malloc(sizeof(CscMatrix));
+    A->n = n;
+    A->m = m;
+    A->nzmax = nzmax > 0 ? nzmax : 1;
+    A->colptr = (int *)calloc(m + 1, sizeof(int));
+    A->rowind = (int *)malloc(A->nzmax * sizeof(int));
+    A->val = (double *)malloc(A->nzmax * sizeof(double));
+    return A;
+}
+
+void csc_free(CscMatrix *A) {
+    if (A == NULL) return;
+    free(A->colptr);
+    free(A->rowind);
+    free(A->val);
+    free(A);
+}
+
+/* Grow storage of a matrix being filled column by column */
+void csc_grow(CscMatrix *A, int nzmax) {
+    A->nzmax = nzmax;
+    A->rowind = (int *)realloc(A->rowind, nzmax * sizeof(int));
+    A->val = (double *)realloc(A->val, nzmax * sizeof(double));
+}
+
+/* Build CSC from triplets, summing duplicates */
+CscMatrix *csc_from_triplets(int n, int m, int nz, const int *ti, const int *tj, const double *tx) {
+    CscMatrix *A = csc_alloc(n, m, nz);
+    int *w = (int *)calloc(m, sizeof(int));
+    for (int k = 0; k < nz; k++) w[tj[k]]++;
+    for (int j = 0; j < m; j++) A->colptr[j + 1] = A->colptr[j] + w[j];
+    for (int j = 0; j < m; j++) w[j] = A->colptr[j];
+    for (int k = 0; k < nz; k++) {
+        int p = w[tj[k]]++;
+        A->rowind[p] = ti[k];
+        A->val[p] = tx[k];
+    }
+    free(w);
+
+    // sum duplicates in place
+    int *last = (int *)malloc(n * sizeof(int));
+    for (int i = 0; i < n; i++) last[i] = -1;
+    int out = 0;
+    for (int j = 0; j < m; j++) {
+        int start = out;
+        for (int p = A->colptr[j]; p < A->colptr[j + 1]; p++) {
+            int i = A->rowind[p];
+            if (last[i] >= start) {
+                A->val[last[i]] += A->val[p];
+            } else {
+                last[i] = out;
+                A->rowind[out] = i;
+                A->val[out] = A->val[p];
+                out++;
+            }
+        }
+        A->colptr[j] = start;
+    }
+    A->colptr[m] = out;
+    free(last);
+    return A;
+}
+
+/* ---------- Matrix Market reader ---------- */
+CscMatrix *read_matrix_market(const char *path) {
+    FILE *fp = fopen(path, "r");
+    if (fp == NULL) {
+        printf("Cannot open %s\n", path);
+        return NULL;
+    }
+
+    char line[1024];
+    if (fgets(line, sizeof(line), fp) == NULL || strncmp(line, "%%MatrixMarket", 14) != 0) {
+        printf("%s is not a Matrix Market file\n", path);
+        fclose(fp);
+        return NULL;
+    }
+    for (char *c = line; *c; c++)
+        if (*c >= 'A' && *c <= 'Z') *c += 'a' - 'A';
+    if (strstr(line, "coordinate") == NULL || strstr(line, "complex") != NULL) {
+        printf("Only real/integer/pattern coordinate matrices are supported\n");
+        fclose(fp);
+        return NULL;
+    }
+    int pattern = strstr(line, "pattern") != NULL;
+    int symmetric = strstr(line, "symmetric") != NULL;
+    int skew = strstr(line, "skew-symmetric") != NULL;
+
+    do {
+        if (fgets(line, sizeof(line), fp) == NULL) {
+            fclose(fp);
+            return NULL;
+        }
+    } while (line[0] == '%');
+
+    int n, m, nz;
+    if (sscanf(line, "%d %d %d", &n, &m, &nz) != 3 || n <= 0 || m <= 0 || nz < 0 || nz > INT_MAX / 2) {
+        printf("%s: bad size line\n", path);
+        fclose(fp);
+        return NULL;
+    }
+
+    int cap = (symmetric || skew) ? 2 * nz : nz;
+    int *ti = (int *)malloc(cap * sizeof(int));
+    int *tj = (int *)malloc(cap * sizeof(int));
+    double *tx = (double *)malloc(cap * sizeof(double));
+    int k = 0;
+    for (int e = 0; e < nz; e++) {
+        int i, j;
+        double v = 1.0;
+        if (fscanf(fp, "%d %d", &i, &j) != 2) break;
+        if (!pattern && fscanf(fp, "%lf", &v) != 1) break;
+        if (i < 1 || i > n || j < 1 || j > m) {
+            printf("%s: entry (%d, %d) is outside the %d x %d matrix\n", path, i, j, n, m);
+            fclose(fp);
+            free(ti);
+            free(tj);
+            free(tx);
+            return NULL;
+        }
+        i--; j--;
+        ti[k] = i; tj[k] = j; tx[k] = v; k++;
+        if ((symmetric || skew) && i != j) {
+            ti[k] = j; tj[k] = i; tx[k] = skew ? -v : v; k++;
+        }
+    }
+    fclose(fp);
+
+    CscMatrix *A = csc_from_triplets(n, m, k, ti, tj, tx);
+    free(ti);
+    free(tj);
+    free(tx);
+    return A;
+}
+
+/* Convection-diffusion on an N x N grid: 5-point stencil, unsymmetric */
+CscMatrix *grid_matrix(int N) {
+    int n = N * N;
+    int cap = 5 * n;
+    int *ti = (int *)malloc(cap * sizeof(int));
+    int *tj = (int *)malloc(cap * sizeof(int));
+    double *tx = (double *)malloc(cap * sizeof(double));
+    int k = 0;
+    for (int y = 0; y < N; y++) {
+        for (int x = 0; x < N; x++) {
+            int i = y * N + x;
+            ti[k] = i; tj[k] = i; tx[k] = 4.0; k++;
+            if (x > 0)     { ti[k] = i; tj[k] = i - 1; tx[k] = -1.3; k++; }
+            if (x < N - 1) { ti[k] = i; tj[k] = i + 1; tx[k] = -0.7; k++; }
+            if (y > 0)     { ti[k] = i; tj[k] = i - N; tx[k] = -1.1; k++; }
+            if (y < N - 1) { ti[k] = i; tj[k] = i + N; tx[k] = -0.9; k++; }
+        }
+    }
+    CscMatrix *A = csc_from_triplets(n, n, k, ti, tj, tx);
+    free(ti);
+    free(tj);
+    free(tx);
+    return A;
+}
+
+/* ---------- Approximate minimum degree ordering ---------- */
+
+/* Growable list of ints */
+typedef struct {
+    int *v;
+    int len, cap;
+} IntList;
+
+void list_push(IntList *l, int x) {
+    if (l->len == l->cap) {
+        l->cap = l->cap ? 2 * l->cap : 4;
+        l->v = (int *)realloc(l->v, l->cap * sizeof(int));
+    }
+    l->v[l->len++] = x;
+}
+
+void list_free(IntList *l) {
+    free(l->v);
+    l->v = NULL;
+    l->len = l->cap = 0;
+}
+
+/* Degree buckets: doubly linked lists indexed by degree */
+typedef struct {
+    int *head, *next, *prev, *deg;
+    int mindeg;
+} DegreeLists;
+
+void degree_insert(DegreeLists *d, int i, int deg) {
+    d->deg[i] = deg;
+    d->prev[i] = -1;
+    d->next[i] = d->head[deg];
+    if (d->head[deg] >= 0) d->prev[d->head[deg]] = i;
+    d->head[deg] = i;
+    if (deg < d->mindeg) d->mindeg = deg;
+}
+
+void degree_remove(DegreeLists *d, int i) {
+    if (d->prev[i] >= 0) d->next[d->prev[i]] = d->next[i];
+    else d->head[d->deg[i]] = d->next[i];
+    if (d->next[i] >= 0) d->prev[d->next[i]] = d->prev[i];
+}
+
+/*
+   Minimum degree on the quotient graph of A + A^T. Eliminated variables
+   become elements; a variable's neighbourhood is its remaining variable
+   neighbours plus the union of its adjacent elements. Degrees use the
+   AMD upper bound |A_i| + |L_p \ i| + sum |L_e \ L_p|, so no explicit
+   fill graph is ever formed. Returns perm[k] = k-th pivot.
+*/
+int *amd_order(const CscMatrix *A) {
+    int n = A->n;
+    IntList *adj = (IntList *)calloc(n, sizeof(IntList));   // variable neighbours
+    IntList *elem = (IntList *)calloc(n, sizeof(IntList));  // adjacent elements
+    IntList *Le = (IntList *)calloc(n, sizeof(IntList));    // element patterns
+    char *state = (char *)calloc(n, 1);                     // 0 var, 1 element, 2 absorbed
+    int *mark = (int *)calloc(n, sizeof(int));
+    int *w = (int *)malloc(n * sizeof(int));
+    int *wmark = (int *)calloc(n, sizeof(int));
+    int *perm = (int *)malloc(n * sizeof(int));
+    int stamp = 0;
+
+    // pattern of A + A^T without the diagonal, duplicates removed
+    for (int j = 0; j < A->m; j++) {
+        for (int p = A->colptr[j]; p < A->colptr[j + 1]; p++) {
+            int i = A->rowind[p];
+            if (i == j) continue;
+            list_push(&adj[i], j);
+            list_push(&adj[j], i);
+        }
+    }
+    for (int i = 0; i < n; i++) {
+        stamp++;
+        int out = 0;
+        for (int t = 0; t < adj[i].len; t++) {
+            int j = adj[i].v[t];
+            if (mark[j] != stamp) {
+                mark[j] = stamp;
+                adj[i].v[out++] = j;
+            }
+        }
+        adj[i].len = out;
+    }
+
+    DegreeLists d;
+    d.head = (int *)malloc((n + 1) * sizeof(int));
+    d.next = (int *)malloc(n * sizeof(int));
+    d.prev = (int *)malloc(n * sizeof(int));
+    d.deg = (int *)malloc(n * sizeof(int));
+    d.mindeg = n;
+    for (int i = 0; i <= n; i++) d.head[i] = -1;
+    for (int i = 0; i < n; i++) degree_insert(&d, i, adj[i].len);
+
+    for (int k = 0; k < n; k++) {
+        while (d.head[d.mindeg] < 0) d.mindeg++;
+        int p = d.head[d.mindeg];
+        degree_remove(&d, p);
+        perm[k] = p;
+        state[p] = 1;
+
+        // L_p = (A_p union all L_e, e in E_p) minus p; absorb those elements
+        stamp++;
+        mark[p] = stamp;
+        IntList Lp = {NULL, 0, 0};
+        for (int t = 0; t < adj[p].len; t++) {
+            int j = adj[p].v[t];
+            if (state[j] == 0 && mark[j] != stamp) {
+                mark[j] = stamp;
+                list_push(&Lp, j);
+            }
+        }
+        for (int t = 0; t < elem[p].len; t++) {
+            int e = elem[p].v[t];
+            if (state[e] != 1) continue;
+            for (int s = 0; s < Le[e].len; s++) {
+                int j = Le[e].v[s];
+                if (state[j] == 0 && mark[j] != stamp) {
+                    mark[j] = stamp;
+                    list_push(&Lp, j);
+                }
+            }
+            state[e] = 2;
+            list_free(&Le[e]);
+        }
+        list_free(&adj[p]);
+        list_free(&elem[p]);
+        Le[p] = Lp;
+
+        // w(e) = |L_e \ L_p| for every element touching L_p
+        for (int t = 0; t < Lp.len; t++) {
+            int i = Lp.v[t];
+            for (int s = 0; s < elem[i].len; s++) {
+                int e = elem[i].v[s];
+                if (state[e] != 1) continue;
+                if (wmark[e] != stamp) {
+                    wmark[e] = stamp;
+                    w[e] = Le[e].len;
+                }
+                w[e]--;
+            }
+        }
+
+        // update each variable of L_p
+        int remaining = n - k - 1;
+        for (int t = 0; t < Lp.len; t++) {
+            int i = Lp.v[t];
+            degree_remove(&d, i);
+
+            int out = 0;
+            int deg = Lp.len - 1;
+            for (int s = 0; s < elem[i].len; s++) {
+                int e = elem[i].v[s];
+                if (state[e] != 1) continue;
+                if (wmark[e] == stamp && w[e] == 0) {
+                    // aggressive absorption: L_e is a subset of L_p
+                    state[e] = 2;
+                    list_free(&Le[e]);
+                    continue;
+                }
+                deg += (wmark[e] == stamp) ? w[e] : Le[e].len;
+                elem[i].v[out++] = e;
+            }
+            elem[i].len = out;
+            list_push(&elem[i], p);
+
+            out = 0;
+            for (int s = 0; s < adj[i].len; s++) {
+                int j = adj[i].v[s];
+                if (state[j] != 0 || mark[j] == stamp) continue; // covered by element p
+                adj[i].v[out++] = j;
+            }
+            adj[i].len = out;
+            deg += out;
+
+            if (deg > remaining - 1) deg = remaining - 1;
+            if (deg < 0) deg = 0;
+            degree_insert(&d, i, deg);
+        }
+    }
+
+    for (int i = 0; i < n; i++) {
+        list_free(&adj[i]);
+        list_free(&elem[i]);
+        list_free(&Le[i]);
+    }
+    free(adj); free(elem); free(Le);
+    free(state); free(mark); free(w); free(wmark);
+    free(d.head); free(d.next); free(d.prev); free(d.deg);
+    return perm;
+}
+
+/* ---------- Symbolic factorization ---------- */
+
+/*
+   Elimination tree and column counts of chol(C), C = P(A + A^T)P^T.
+   Without pivoting, the patterns of L and U^T are contained in that of
+   chol(C), so these counts size the numeric factors up front.
+   Returns the predicted nnz(L) including the diagonal.
+*/
+long symbolic_analysis(const CscMatrix *A, const int *perm, int *parent, int *colcount) {
+    int n = A->n;
+    int *pinv = (int *)malloc(n * sizeof(int));
+    int *ancestor = (int *)malloc(n * sizeof(int));
+    int *visited = (int *)malloc(n * sizeof(int));
+    for (int k = 0; k < n; k++) pinv[perm[k]] = k;
+
+    // pattern of the permuted A + A^T as row lists of the lower triangle
+    IntList *rows = (IntList *)calloc(n, sizeof(IntList));
+    for (int j = 0; j < A->m; j++) {
+        for (int p = A->colptr[j]; p < A->colptr[j + 1]; p++) {
+            int a = pinv[A->rowind[p]], b = pinv[j];
+            if (a == b) continue;
+            if (a > b) list_push(&rows[a], b);
+            else list_push(&rows[b], a);
+        }
+    }
+
+    // elimination tree (Liu's algorithm with path compression)
+    for (int k = 0; k < n; k++) {
+        parent[k] = -1;
+        ancestor[k] = -1;
+        for (int t = 0; t < rows[k].len; t++) {
+            int i = rows[k].v[t];
+            while (i != -1 && i < k) {
+                int next = ancestor[i];
+                ancestor[i] = k;
+                if (next == -1) parent[i] = k;
+                i = next;
+            }
+        }
+    }
+
+    // column counts by walking each row subtree (cost is O(nnz(L)))
+    long total = 0;
+    for (int k = 0; k < n; k++) {
+        colcount[k] = 1;
+        visited[k] = -1;
+    }
+    for (int k = 0; k < n; k++) {
+        visited[k] = k;
+        for (int t = 0; t < rows[k].len; t++) {
+            for (int i = rows[k].v[t]; i != -1 && visited[i] != k; i = parent[i]) {
+                visited[i] = k;
+                colcount[i]++;
+            }
+        }
+    }
+    for (int k = 0; k < n; k++) total += colcount[k];
+
+    for (int i = 0; i < n; i++) list_free(&rows[i]);
+    free(rows);
+    free(pinv);
+    free(ancestor);
+    free(visited);
+    return total;
+}
+
+/* ---------- Numeric factorization ---------- */
+
+/* Non-recursive depth-first search from node j in the graph of L */
+int dfs_reach(int j, const CscMatrix *L, int top, int *xi, int *pstack, const int *pinv, char *seen) {
+    int head = 0;
+    xi[0] = j;
+    while (head >= 0) {
+        j = xi[head];
+        int jnew = pinv[j];
+        if (!seen[j]) {
+            seen[j] = 1;
+            pstack[head] = (jnew < 0) ? 0 : L->colptr[jnew] + 1;  // skip unit diagonal
+        }
+        int done = 1;
+        int pend = (jnew < 0) ? 0 : L->colptr[jnew + 1];
+        for (int p = pstack[head]; p < pend; p++) {
+            int i = L->rowind[p];
+            if (seen[i]) continue;
+            pstack[head] = p + 1;
+            xi[++head] = i;
+            done = 0;
+            break;
+        }
+        if (done) {
+            head--;
+            xi[--top] = j;
+        }
+    }
+    return top;
+}
+
+/*
+   LU factorization of A(:,q) with threshold partial pivoting.
+   L is unit lower triangular, U is upper triangular, both in CSC with
+   row indices in pivot order. pinv[i] = k means row i is the k-th pivot.
+   Returns 0, -1 if A is singular, or -2 if L or U would hold more than
+   INT_MAX nonzeros (the int column pointers cannot address them).
+*/
+int sparse_lu(const CscMatrix *A, const int *q, long lnz, long unz,
+              CscMatrix **Lout, CscMatrix **Uout, int *pinv) {
+    int n = A->n;
+    if (lnz > INT_MAX || unz > INT_MAX)
+        return -2;
+    CscMatrix *L = csc_alloc(n, n, (int)lnz);
+    CscMatrix *U = csc_alloc(n, n, (int)unz);
+    double *x = (double *)calloc(n, sizeof(double));
+    int *xi = (int *)malloc(2 * n * sizeof(int));
+    char *seen = (char *)calloc(n, 1);
+    for (int i = 0; i < n; i++) pinv[i] = -1;
+    int lp = 0, up = 0;
+
+    for (int k = 0; k < n; k++) {
+        L->colptr[k] = lp;
+        U->colptr[k] = up;
+        if ((long)lp + n > INT_MAX || (long)up + n > INT_MAX) {
+            free(x); free(xi); free(seen);
+            csc_free(L); csc_free(U);
+            return -2;
+        }
+        if (lp + n > L->nzmax) csc_grow(L, (int)(2L * L->nzmax + n < INT_MAX ? 2L * L->nzmax + n : INT_MAX));
+        if (up + n > U->nzmax) csc_grow(U, (int)(2L * U->nzmax + n < INT_MAX ? 2L * U->nzmax + n : INT_MAX));
+
+        // x = L \ A(:,col): sparse triangular solve over the reach of A(:,col)
+        int col = q[k];
+        int top = n;
+        for (int p = A->colptr[col]; p < A->colptr[col + 1]; p++) {
+            if (!seen[A->rowind[p]])
+                top = dfs_reach(A->rowind[p], L, top, xi, xi + n, pinv, seen);
+        }
+        for (int p = top; p < n; p++) seen[xi[p]] = 0;
+        for (int p = top; p < n; p++) x[xi[p]] = 0;
+        for (int p = A->colptr[col]; p < A->colptr[col + 1]; p++)
+            x[A->rowind[p]] = A->val[p];
+        for (int px = top; px < n; px++) {
+            int j = xi[px];
+            int J = pinv[j];
+            if (J < 0) continue;
+            for (int p = L->colptr[J] + 1; p < L->colptr[J + 1]; p++)
+                x[L->rowind[p]] -= L->val[p] * x[j];
+        }
+
+        // pivot search among rows not yet pivotal
+        int ipiv = -1;
+        double amax = -1;
+        for (int px = top; px < n; px++) {
+            int i = xi[px];
+            if (pinv[i] < 0) {
+                double t = fabs(x[i]);
+                if (t > amax) { amax = t; ipiv = i; }
+            } else {
+                U->rowind[up] = pinv[i];
+                U->val[up++] = x[i];
+            }
+        }
+        if (ipiv == -1 || amax <= 0) {
+            free(x); free(xi); free(seen);
+            csc_free(L); csc_free(U);
+            return -1;  // structurally or numerically singular
+        }
+        if (pinv[col] < 0 && fabs(x[col]) >= amax * PIVOT_TOL) ipiv = col;
+
+        double pivot = x[ipiv];
+        U->rowind[up] = k;
+        U->val[up++] = pivot;
+        pinv[ipiv] = k;
+        L->rowind[lp] = ipiv;
+        L->val[lp++] = 1.0;
+        for (int px = top; px < n; px++) {
+            int i = xi[px];
+            if (pinv[i] < 0) {
+                L->rowind[lp] = i;
+                L->val[lp++] = x[i] / pivot;
+            }
+            x[i] = 0;
+        }
+    }
+    L->colptr[n] = lp;
+    U->colptr[n] = up;
+    for (int p = 0; p < lp; p++) L->rowind[p] = pinv[L->rowind[p]];
+    csc_grow(L, lp > 0 ? lp : 1);
+    csc_grow(U, up > 0 ? up : 1);
+
+    free(x);
+    free(xi);
+    free(seen);
+    *Lout = L;
+    *Uout = U;
+    return 0;
+}
+
+/* ---------- Solve ---------- */
+void sparse_lu_solve(const CscMatrix *L, const CscMatrix *U, const int *pinv, const int *q,
+                     const double *b, double *x) {
+    int n = L->n;
+    double *y = (double *)malloc(n * sizeof(double));
+    for (int i = 0; i < n; i++) y[pinv[i]] = b[i];
+
+    // L y = P b (unit diagonal stored first in each column)
+    for (int j = 0; j < n; j++)
+        for (int p = L->colptr[j] + 1; p < L->colptr[j + 1]; p++)
+            y[L->rowind[p]] -= L->val[p] * y[j];
+
+    // U z = y (diagonal stored last in each column)
+    for (int j = n - 1; j >= 0; j--) {
+        y[j] /= U->val[U->colptr[j + 1] - 1];
+        for (int p = U->colptr[j]; p < U->colptr[j + 1] - 1; p++)
+            y[U->rowind[p]] -= U->val[p] * y[j];
+    }
+
+    for (int k = 0; k < n; k++) x[q[k]] = y[k];
+    free(y);
+}
+
+/* y = A x */
+void csc_matvec(const CscMatrix *A, const double *x, double *y) {
+    for (int i = 0; i < A->n; i++) y[i] = 0;
+    for (int j = 0; j < A->m; j++)
+        for (int p = A->colptr[j]; p < A->colptr[j + 1]; p++)
+            y[A->rowind[p]] += A->val[p] * x[j];
+}
+
+double elapsed(clock_t start) {
+    return (double)(clock() - start) / CLOCKS_PER_SEC;
+}
+
+int main(int argc, char **argv) {
+    CscMatrix *A;
+    char path[512];
+
+    if (argc >= 3 && strcmp(argv[1], "--grid") == 0) {
+        A = grid_matrix(atoi(argv[2]));
+    } else {
+        if (argc >= 2) {
+            snprintf(path, sizeof(path), "%s", argv[1]);
+        } else {
+            printf("Enter path of Matrix Market file: ");
+            if (scanf("%511s", path) != 1) return 1;
+        }
+        A = read_matrix_market(path);
+    }
+    if (A == NULL) return 1;
+    if (A->n != A->m) {
+        printf("Matrix must be square.\n");
+        csc_free(A);
+        return 1;
+    }
+
+    int n = A->n;
+    printf("n = %d, nnz(A) = %d\n", n, A->colptr[n]);
+
+    clock_t t = clock();
+    int *q = amd_order(A);
+    printf("Ordering:     %8.3f s\n", elapsed(t));
+
+    t = clock();
+    int *parent = (int *)malloc(n * sizeof(int));
+    int *colcount = (int *)malloc(n * sizeof(int));
+    long lnz = symbolic_analysis(A, q, parent, colcount);
+    printf("Symbolic:     %8.3f s  (predicted nnz(L) = %ld)\n", elapsed(t), lnz);
+
+    t = clock();
+    CscMatrix *L, *U;
+    int *pinv = (int *)malloc(n * sizeof(int));
+    int status = sparse_lu(A, q, lnz, lnz, &L, &U, pinv);
+    if (status != 0) {
+        printf(status == -1 ? "Matrix is singular!\n" : "Factors have more than INT_MAX nonzeros.\n");
+        free(q); free(parent); free(colcount); free(pinv);
+        csc_free(A);
+        return 1;
+    }
+    printf("Numeric LU:   %8.3f s  (nnz(L) = %d, nnz(U) = %d)\n", elapsed(t),
+           L->colptr[n], U->colptr[n]);
+
+    // b = A * ones, so the exact solution is all ones
+    double *ones = (double *)calloc(n, sizeof(double));
+    double *b = (double *)calloc(n, sizeof(double));
+    double *x = (double *)calloc(n, sizeof(double));
+    double *r = (double *)calloc(n, sizeof(double));
+    for (int i = 0; i < n; i++) ones[i] = 1.0;
+    csc_matvec(A, ones, b);
+
+    t = clock();
+    sparse_lu_solve(L, U, pinv, q, b, x);
+    printf("Solve:        %8.3f s\n", elapsed(t));
+
+    csc_matvec(A, x, r);
+    double rnorm = 0, bnorm = 0;
+    for (int i = 0; i < n; i++) {
+        rnorm = fmax(rnorm, fabs(r[i] - b[i]));
+        bnorm = fmax(bnorm, fabs(b[i]));
+    }
+    printf("Residual ||Ax - b||_inf / ||b||_inf = %.3e\n", bnorm > 0 ? rnorm / bnorm : rnorm);
+
+    free(ones); free(b); free(x); free(r);
+    free(q); free(parent); free(colcount); free(pinv);
+    csc_free(L); csc_free(U); csc_free(A);
+    return 0;
+}
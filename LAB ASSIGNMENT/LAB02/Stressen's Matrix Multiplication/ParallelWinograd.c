@@ -0,0 +1,237 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include <unistd.h>
+#include "../../common/dense_kernels.h"
+
+/*
+   Task-parallel Strassen-Winograd multiplication C = A * B.
+
+   - Winograd's form of Strassen: 7 products and 15 additions per level
+     instead of 18.
+   - At the top levels the 7 products run as separate threads. The number
+     of parallel levels is the smallest d with 7^d >= number of cores.
+   - Any m x k times k x n shape works. Odd dimensions are handled by dynamic
+     peeling: the even part is multiplied recursively, and the leftover
+     row/column is fixed up with a rank-1 update and two thin products.
+     There is no padding to a power of 2.
+*/
+
+#define CUTOFF 64    // below this the classical kernel is used
+
+int PARALLEL_DEPTH = 0;
+
+// Matrix view: element (i, j) is p[i*ld + j]
+typedef struct {
+    int *p;
+    int ld;
+} View;
+
+View sub(View v, int r, int c) {
+    View s = { v.p + (size_t)r * v.ld + c, v.ld };
+    return s;
+}
+
+View newBlock(int rows, int cols) {
+    View v = { (int*)malloc((size_t)rows * cols * sizeof(int)), cols };
+    return v;
+}
+
+// C = A + B and C = A - B on m x n views
+void addView(View A, View B, View C, int m, int n) {
+    for (int i = 0; i < m; i++)
+        for (int j = 0; j < n; j++)
+            C.p[i*C.ld + j] = A.p[i*A.ld + j] + B.p[i*B.ld + j];
+}
+
+void subView(View A, View B, View C, int m, int n) {
+    for (int i = 0; i < m; i++)
+        for (int j = 0; j < n; j++)
+            C.p[i*C.ld + j] = A.p[i*A.ld + j] - B.p[i*B.ld + j];
+}
+
+// Classical C (+)= A*B via the shared blocked kernel; accumulate = 0 overwrites C
+void classicMultiply(View A, View B, View C, int m, int k, int n, int accumulate) {
+    dk_igemm(m, n, k, A.p, A.ld, B.p, B.ld, C.p, C.ld, accumulate);
+}
+
+void winograd(View A, View B, View C, int m, int k, int n, int depth);
+
+// One product task for a worker thread
+typedef struct {
+    View A, B, C;
+    int m, k, n, depth;
+} Task;
+
+void *runTask(void *arg) {
+    Task *t = (Task*)arg;
+    winograd(t->A, t->B, t->C, t->m, t->k, t->n, t->depth);
+    return NULL;
+}
+
+// Strassen-Winograd on even m, k, n
+void winogradEven(View A, View B, View C, int m, int k, int n, int depth) {
+    int m2 = m/2, k2 = k/2, n2 = n/2;
+    View A11 = A, A12 = sub(A, 0, k2), A21 = sub(A, m2, 0), A22 = sub(A, m2, k2);
+    View B11 = B, B12 = sub(B, 0, n2), B21 = sub(B, k2, 0), B22 = sub(B, k2, n2);
+    View C11 = C, C12 = sub(C, 0, n2), C21 = sub(C, m2, 0), C22 = sub(C, m2, n2);
+
+    View S1 = newBlock(m2, k2), S2 = newBlock(m2, k2), S3 = newBlock(m2, k2), S4 = newBlock(m2, k2);
+    View T1 = newBlock(k2, n2), T2 = newBlock(k2, n2), T3 = newBlock(k2, n2), T4 = newBlock(k2, n2);
+
+    // 8 operand additions
+    addView(A21, A22, S1, m2, k2);   // S1 = A21 + A22
+    subView(S1, A11, S2, m2, k2);    // S2 = S1 - A11
+    subView(A11, A21, S3, m2, k2);   // S3 = A11 - A21
+    subView(A12, S2, S4, m2, k2);    // S4 = A12 - S2
+    subView(B12, B11, T1, k2, n2);   // T1 = B12 - B11
+    subView(B22, T1, T2, k2, n2);    // T2 = B22 - T1
+    subView(B22, B12, T3, k2, n2);   // T3 = B22 - B12
+    subView(T2, B21, T4, k2, n2);    // T4 = T2 - B21
+
+    // P1 goes to C11 and P5 to C22 directly; the rest need their own blocks
+    View P2 = newBlock(m2, n2), P3 = newBlock(m2, n2), P4 = newBlock(m2, n2);
+    View P6 = newBlock(m2, n2), P7 = newBlock(m2, n2);
+
+    Task tasks[7] = {
+        { A11, B11, C11, m2, k2, n2, depth + 1 },   // P1 = A11 * B11
+        { A12, B21, P2,  m2, k2, n2, depth + 1 },   // P2 = A12 * B21
+        { S4,  B22, P3,  m2, k2, n2, depth + 1 },   // P3 = S4 * B22
+        { A22, T4,  P4,  m2, k2, n2, depth + 1 },   // P4 = A22 * T4
+        { S1,  T1,  C22, m2, k2, n2, depth + 1 },   // P5 = S1 * T1
+        { S2,  T2,  P6,  m2, k2, n2, depth + 1 },   // P6 = S2 * T2
+        { S3,  T3,  P7,  m2, k2, n2, depth + 1 },   // P7 = S3 * T3
+    };
+
+    if (depth < PARALLEL_DEPTH) {
+        pthread_t tid[7];
+        int spawned[7] = {0};
+        for (int i = 1; i < 7; i++)
+            spawned[i] = pthread_create(&tid[i], NULL, runTask, &tasks[i]) == 0;
+        runTask(&tasks[0]);
+        for (int i = 1; i < 7; i++) {
+            if (spawned[i]) pthread_join(tid[i], NULL);
+            else runTask(&tasks[i]);
+        }
+    } else {
+        for (int i = 0; i < 7; i++)
+            runTask(&tasks[i]);
+    }
+
+    // 7 result additions (C11 holds P1, C22 holds P5)
+    View U2 = P6;
+    addView(C11, P6, U2, m2, n2);    // U2 = P1 + P6
+    addView(C11, P2, C11, m2, n2);   // C11 = U1 = P1 + P2
+    View U3 = P7;
+    addView(U2, P7, U3, m2, n2);     // U3 = U2 + P7
+    addView(U2, C22, U2, m2, n2);    // U4 = U2 + P5
+    addView(U2, P3, C12, m2, n2);    // C12 = U5 = U4 + P3
+    subView(U3, P4, C21, m2, n2);    // C21 = U6 = U3 - P4
+    addView(U3, C22, C22, m2, n2);   // C22 = U7 = U3 + P5
+
+    free(S1.p); free(S2.p); free(S3.p); free(S4.p);
+    free(T1.p); free(T2.p); free(T3.p); free(T4.p);
+    free(P2.p); free(P3.p); free(P4.p); free(P6.p); free(P7.p);
+}
+
+// C = A * B for any m x k times k x n
+void winograd(View A, View B, View C, int m, int k, int n, int depth) {
+    if (m <= CUTOFF || k <= CUTOFF || n <= CUTOFF) {
+        classicMultiply(A, B, C, m, k, n, 0);
+        return;
+    }
+
+    // Dynamic peeling: recurse on the even part
+    int me = m & ~1, ke = k & ~1, ne = n & ~1;
+    winogradEven(A, B, C, me, ke, ne, depth);
+
+    // k odd: C[0:me, 0:ne] += A[0:me, ke] * B[ke, 0:ne]
+    if (ke < k)
+        classicMultiply(sub(A, 0, ke), sub(B, ke, 0), C, me, 1, ne, 1);
+    // n odd: last column C[0:me, ne] = A[0:me, :] * B[:, ne]
+    if (ne < n)
+        classicMultiply(A, sub(B, 0, ne), sub(C, 0, ne), me, k, 1, 0);
+    // m odd: last row C[me, :] = A[me, :] * B
+    if (me < m)
+        classicMultiply(sub(A, me, 0), B, sub(C, me, 0), 1, k, n, 0);
+}
+
+// Smallest d with 7^d >= cores
+int parallelDepth(void) {
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    int d = 0;
+    for (long p = 1; p < cores; p *= 7)
+        d++;
+    return d;
+}
+
+double wallTime(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// Times sequential and parallel runs on an n x n random problem and checks them
+void benchmark(int n) {
+    View A = newBlock(n, n), B = newBlock(n, n), C = newBlock(n, n), R = newBlock(n, n);
+    for (long i = 0; i < (long)n * n; i++) {
+        A.p[i] = rand() % 10;
+        B.p[i] = rand() % 10;
+    }
+
+    double t = wallTime();
+    classicMultiply(A, B, R, n, n, n, 0);
+    printf("Classical:          %.3f s\n", wallTime() - t);
+
+    int depth = PARALLEL_DEPTH;
+    PARALLEL_DEPTH = 0;
+    t = wallTime();
+    winograd(A, B, C, n, n, n, 0);
+    printf("Winograd (1 thread): %.3f s, %s\n", wallTime() - t,
+           memcmp(C.p, R.p, (size_t)n * n * sizeof(int)) ? "MISMATCH" : "correct");
+
+    PARALLEL_DEPTH = depth;
+    t = wallTime();
+    winograd(A, B, C, n, n, n, 0);
+    printf("Winograd (depth %d): %.3f s, %s\n", depth, wallTime() - t,
+           memcmp(C.p, R.p, (size_t)n * n * sizeof(int)) ? "MISMATCH" : "correct");
+
+    free(A.p); free(B.p); free(C.p); free(R.p);
+}
+
+int main(int argc, char **argv) {
+    PARALLEL_DEPTH = parallelDepth();
+
+    if (argc > 2 && strcmp(argv[1], "--bench") == 0) {
+        benchmark(atoi(argv[2]));
+        return 0;
+    }
+
+    int n;
+    printf("Enter order of square matrix: ");
+    scanf("%d", &n);
+
+    View A = newBlock(n, n), B = newBlock(n, n), C = newBlock(n, n);
+
+    printf("Enter matrix A (%dx%d):\n", n, n);
+    for (int i = 0; i < n * n; i++)
+        scanf("%d", &A.p[i]);
+
+    printf("Enter matrix B (%dx%d):\n", n, n);
+    for (int i = 0; i < n * n; i++)
+        scanf("%d", &B.p[i]);
+
+    winograd(A, B, C, n, n, n, 0);
+
+    printf("\nStrassen-Winograd Multiplication Result:\n");
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < n; j++)
+            printf("%4d ", C.p[i*n + j]);
+        printf("\n");
+    }
+
+    free(A.p); free(B.p); free(C.p);
+    return 0;
+}
@@ -1,15 +1,33 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <math.h>
+#include <time.h>
+#include "../../common/dense_kernels.h"
 
-// Function to allocate a matrix
+// Below this order the classical blocked kernel is faster than recursing.
+// Default from `--tune` runs. `--cutoff N` sets it for one run, and `--tune`
+// measures it on this machine and then uses the result for the run.
+int STRASSEN_CUTOFF = 64;
+
+#define TUNE_SAMPLES 5      // timings per size; the fastest one counts
+#define TUNE_MARGIN 0.95    // Strassen must be at least 5% faster to win
+
+// Function to allocate a matrix: one contiguous block plus row pointers,
+// so any submatrix is a (pointer, leading dimension) view
 int** allocateMatrix(int n) {
     int **mat = (int**)malloc(n * sizeof(int*));
-    for(int i=0; i<n; i++)
-        mat[i] = (int*)calloc(n, sizeof(int));
+    mat[0] = (int*)calloc((size_t)n * n, sizeof(int));
+    for(int i=1; i<n; i++)
+        mat[i] = mat[0] + (size_t)i * n;
     return mat;
 }
 
+void freeMatrix(int **mat) {
+    free(mat[0]);
+    free(mat);
+}
+
 // Print matrix
 void printMatrix(int **A, int n) {
     for(int i=0; i<n; i++) {
@@ -19,108 +37,131 @@ void printMatrix(int **A, int n) {
     }
 }
 
+// ---------------- Arena for temporaries ----------------
+// Every recursion level takes 3 k x k blocks (two operand sums and one
+// product), so the whole recursion needs at most n*n/4 * 4/3 * 3 = n*n ints.
+typedef struct {
+    int *base;
+    size_t size, top;
+} Arena;
+
+size_t arenaSize(int n) {
+    size_t total = 0;
+    while(n > STRASSEN_CUTOFF && n % 2 == 0) {
+        n /= 2;
+        total += 3 * (size_t)n * n;
+    }
+    return total;
+}
+
+int* arenaAlloc(Arena *a, size_t count) {
+    int *p = a->base + a->top;
+    a->top += count;
+    return p;
+}
 
+// ---------------- Strided kernels ----------------
+// All kernels take (pointer, leading dimension) views instead of copies.
 
-void addMatrix(int **A, int **B, int **C, int n) {
+void addMatrix(const int *A, int lda, const int *B, int ldb, int *C, int ldc, int n) {
     for(int i=0; i<n; i++)
         for(int j=0; j<n; j++)
-            C[i][j] = A[i][j] + B[i][j];
+            C[i*ldc + j] = A[i*lda + j] + B[i*ldb + j];
 }
 
-void subMatrix(int **A, int **B, int **C, int n) {
+void subMatrix(const int *A, int lda, const int *B, int ldb, int *C, int ldc, int n) {
     for(int i=0; i<n; i++)
         for(int j=0; j<n; j++)
-            C[i][j] = A[i][j] - B[i][j];
+            C[i*ldc + j] = A[i*lda + j] - B[i*ldb + j];
 }
 
+// C (+/-)= P, sign is +1, -1, or 0 to assign
+void accumulate(int *C, int ldc, const int *P, int ldp, int n, int sign) {
+    for(int i=0; i<n; i++) {
+        int *c = C + (size_t)i*ldc;
+        const int *p = P + (size_t)i*ldp;
+        if(sign == 0)       for(int j=0; j<n; j++) c[j] = p[j];
+        else if(sign > 0)   for(int j=0; j<n; j++) c[j] += p[j];
+        else                for(int j=0; j<n; j++) c[j] -= p[j];
+    }
+}
 
-void strassenMultiply(int **A, int **B, int **C, int n) {
-    if(n == 1) {
-        C[0][0] = A[0][0] * B[0][0];
+// Classical C = A*B via the shared blocked kernel
+void classicMultiply(const int *A, int lda, const int *B, int ldb, int *C, int ldc, int n) {
+    dk_igemm(n, n, n, A, lda, B, ldb, C, ldc, 0);
+}
+
+// Strassen on views; temporaries come from the arena and are released on return
+void strassenView(const int *A, int lda, const int *B, int ldb, int *C, int ldc, int n, Arena *arena) {
+    if(n <= STRASSEN_CUTOFF || n % 2 != 0) {
+        classicMultiply(A, lda, B, ldb, C, ldc, n);
         return;
     }
 
     int k = n/2;
-    int **A11 = allocateMatrix(k), **A12 = allocateMatrix(k);
-    int **A21 = allocateMatrix(k), **A22 = allocateMatrix(k);
-    int **B11 = allocateMatrix(k), **B12 = allocateMatrix(k);
-    int **B21 = allocateMatrix(k), **B22 = allocateMatrix(k);
-    int **M1 = allocateMatrix(k), **M2 = allocateMatrix(k), **M3 = allocateMatrix(k),
-         **M4 = allocateMatrix(k), **M5 = allocateMatrix(k), **M6 = allocateMatrix(k), **M7 = allocateMatrix(k);
-    int **T1 = allocateMatrix(k), **T2 = allocateMatrix(k);
-    int **C11 = allocateMatrix(k), **C12 = allocateMatrix(k),
-         **C21 = allocateMatrix(k), **C22 = allocateMatrix(k);
-
-    // Divide matrices
-    for(int i=0; i<k; i++) {
-        for(int j=0; j<k; j++) {
-            A11[i][j] = A[i][j];
-            A12[i][j] = A[i][j+k];
-            A21[i][j] = A[i+k][j];
-            A22[i][j] = A[i+k][j+k];
-            B11[i][j] = B[i][j];
-            B12[i][j] = B[i][j+k];
-            B21[i][j] = B[i+k][j];
-            B22[i][j] = B[i+k][j+k];
-        }
-    }
+    size_t mark = arena->top;
+    int *T1 = arenaAlloc(arena, (size_t)k*k);
+    int *T2 = arenaAlloc(arena, (size_t)k*k);
+    int *P  = arenaAlloc(arena, (size_t)k*k);
 
-    // M1 = (A11+A22)(B11+B22)
-    addMatrix(A11, A22, T1, k);
-    addMatrix(B11, B22, T2, k);
-    strassenMultiply(T1, T2, M1, k);
-
-    // M2 = (A21+A22)B11
-    addMatrix(A21, A22, T1, k);
-    strassenMultiply(T1, B11, M2, k);
-
-    // M3 = A11(B12-B22)
-    subMatrix(B12, B22, T1, k);
-    strassenMultiply(A11, T1, M3, k);
-
-    // M4 = A22(B21-B11)
-    subMatrix(B21, B11, T1, k);
-    strassenMultiply(A22, T1, M4, k);
-
-    // M5 = (A11+A12)B22
-    addMatrix(A11, A12, T1, k);
-    strassenMultiply(T1, B22, M5, k);
-
-    // M6 = (A21-A11)(B11+B12)
-    subMatrix(A21, A11, T1, k);
-    addMatrix(B11, B12, T2, k);
-    strassenMultiply(T1, T2, M6, k);
-
-    // M7 = (A12-A22)(B21+B22)
-    subMatrix(A12, A22, T1, k);
-    addMatrix(B21, B22, T2, k);
-    strassenMultiply(T1, T2, M7, k);
-
-    // C11 = M1+M4-M5+M7
-    addMatrix(M1, M4, T1, k);
-    subMatrix(T1, M5, T2, k);
-    addMatrix(T2, M7, C11, k);
-
-    // C12 = M3+M5
-    addMatrix(M3, M5, C12, k);
-
-    // C21 = M2+M4
-    addMatrix(M2, M4, C21, k);
-
-    // C22 = M1-M2+M3+M6
-    subMatrix(M1, M2, T1, k);
-    addMatrix(T1, M3, T2, k);
-    addMatrix(T2, M6, C22, k);
-
-    // Combine results
-    for(int i=0; i<k; i++) {
-        for(int j=0; j<k; j++) {
-            C[i][j] = C11[i][j];
-            C[i][j+k] = C12[i][j];
-            C[i+k][j] = C21[i][j];
-            C[i+k][j+k] = C22[i][j];
-        }
-    }
+    // Quadrant views (no copies)
+    const int *A11 = A, *A12 = A + k, *A21 = A + (size_t)k*lda, *A22 = A21 + k;
+    const int *B11 = B, *B12 = B + k, *B21 = B + (size_t)k*ldb, *B22 = B21 + k;
+    int *C11 = C, *C12 = C + k, *C21 = C + (size_t)k*ldc, *C22 = C21 + k;
+
+    // M1 = (A11+A22)(B11+B22) -> C11 = M1, C22 = M1
+    addMatrix(A11, lda, A22, lda, T1, k, k);
+    addMatrix(B11, ldb, B22, ldb, T2, k, k);
+    strassenView(T1, k, T2, k, P, k, k, arena);
+    accumulate(C11, ldc, P, k, k, 0);
+    accumulate(C22, ldc, P, k, k, 0);
+
+    // M2 = (A21+A22)B11 -> C21 = M2, C22 -= M2
+    addMatrix(A21, lda, A22, lda, T1, k, k);
+    strassenView(T1, k, B11, ldb, P, k, k, arena);
+    accumulate(C21, ldc, P, k, k, 0);
+    accumulate(C22, ldc, P, k, k, -1);
+
+    // M3 = A11(B12-B22) -> C12 = M3, C22 += M3
+    subMatrix(B12, ldb, B22, ldb, T2, k, k);
+    strassenView(A11, lda, T2, k, P, k, k, arena);
+    accumulate(C12, ldc, P, k, k, 0);
+    accumulate(C22, ldc, P, k, k, 1);
+
+    // M4 = A22(B21-B11) -> C11 += M4, C21 += M4
+    subMatrix(B21, ldb, B11, ldb, T2, k, k);
+    strassenView(A22, lda, T2, k, P, k, k, arena);
+    accumulate(C11, ldc, P, k, k, 1);
+    accumulate(C21, ldc, P, k, k, 1);
+
+    // M5 = (A11+A12)B22 -> C11 -= M5, C12 += M5
+    addMatrix(A11, lda, A12, lda, T1, k, k);
+    strassenView(T1, k, B22, ldb, P, k, k, arena);
+    accumulate(C11, ldc, P, k, k, -1);
+    accumulate(C12, ldc, P, k, k, 1);
+
+    // M6 = (A21-A11)(B11+B12) -> C22 += M6
+    subMatrix(A21, lda, A11, lda, T1, k, k);
+    addMatrix(B11, ldb, B12, ldb, T2, k, k);
+    strassenView(T1, k, T2, k, P, k, k, arena);
+    accumulate(C22, ldc, P, k, k, 1);
+
+    // M7 = (A12-A22)(B21+B22) -> C11 += M7
+    subMatrix(A12, lda, A22, lda, T1, k, k);
+    addMatrix(B21, ldb, B22, ldb, T2, k, k);
+    strassenView(T1, k, T2, k, P, k, k, arena);
+    accumulate(C11, ldc, P, k, k, 1);
+
+    arena->top = mark;
+}
+
+void strassenMultiply(int **A, int **B, int **C, int n) {
+    Arena arena;
+    arena.size = arenaSize(n);
+    arena.base = (int*)malloc((arena.size ? arena.size : 1) * sizeof(int));
+    arena.top = 0;
+    strassenView(A[0], n, B[0], n, C[0], n, n, &arena);
+    free(arena.base);
 }
 
 // ---------------- Helper for padding ----------------
@@ -130,7 +171,68 @@ int nextPowerOf2(int n) {
     return p;
 }
 
-int main() {
+// ---------------- Cutoff tuning ----------------
+double wallTime(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// Best time per multiply over TUNE_SAMPLES samples. Small orders repeat the
+// multiply inside a sample so that each one lasts long enough to measure.
+double timeMultiply(int **A, int **B, int **C, int n, int cutoff) {
+    int repeats = (int)((1L << 26) / ((long)n * n * n)) + 1;
+    double best = 0;
+    STRASSEN_CUTOFF = cutoff;
+    for(int s=0; s<TUNE_SAMPLES; s++) {
+        double start = wallTime();
+        for(int r=0; r<repeats; r++)
+            strassenMultiply(A, B, C, n);
+        double t = (wallTime() - start) / repeats;
+        if(s == 0 || t < best)
+            best = t;
+    }
+    return best;
+}
+
+// Finds the smallest order from which one Strassen level keeps beating the
+// classical kernel by TUNE_MARGIN; a win followed by a loss does not count
+int tuneCutoff(void) {
+    int best = 0;
+    printf("%6s %12s %12s\n", "n", "classic(s)", "strassen(s)");
+    for(int n=32; n<=1024; n*=2) {
+        int **A = allocateMatrix(n), **B = allocateMatrix(n), **C = allocateMatrix(n);
+        for(int i=0; i<n; i++)
+            for(int j=0; j<n; j++) {
+                A[i][j] = rand() % 10;
+                B[i][j] = rand() % 10;
+            }
+        double classic = timeMultiply(A, B, C, n, n);
+        double oneLevel = timeMultiply(A, B, C, n, n/2);
+        printf("%6d %12.6f %12.6f\n", n, classic, oneLevel);
+        freeMatrix(A); freeMatrix(B); freeMatrix(C);
+        if(oneLevel < classic * TUNE_MARGIN) {
+            if(best == 0)
+                best = n/2;
+        } else {
+            best = 0;
+        }
+    }
+    if(best == 0)
+        best = 1024;    // Strassen never won: stay classical at every tested order
+    printf("Chosen cutoff = %d\n", best);
+    return best;
+}
+
+int main(int argc, char **argv) {
+    // --tune, --cutoff N: set STRASSEN_CUTOFF for this run
+    for(int i=1; i<argc; i++) {
+        if(strcmp(argv[i], "--tune") == 0)
+            STRASSEN_CUTOFF = tuneCutoff();
+        else if(strcmp(argv[i], "--cutoff") == 0 && i + 1 < argc && atoi(argv[i + 1]) > 0)
+            STRASSEN_CUTOFF = atoi(argv[++i]);
+    }
+
     int n;
     printf("Enter order of square matrix: ");
     scanf("%d", &n);
@@ -158,5 +260,8 @@ int main() {
     printf("\nStrassen Multiplication Result:\n");
     printMatrix(C,n);
 
+    freeMatrix(A);
+    freeMatrix(B);
+    freeMatrix(C);
     return 0;
 }
@@ -1,99 +1,115 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include "../../common/node_pool.h"
+
+// Nodes live in a slab pool and link to each other by 32-bit handles,
+// so a node (12 bytes of fields) takes a 16-byte slot instead of a 24-byte
+// malloc block, and freed nodes are reused.
+typedef uint32_t NodeRef;
+#define NIL NP_NULL
 
 // Structure for a BST Node
 typedef struct Node {
     int data;
-    struct Node *left, *right;
+    NodeRef left, right;
 } Node;
 
+NodePool pool;
+
+#define N(ref) ((Node*)np_at(&pool, (ref)))
+
 // Function to create a new node
-Node* createNode(int data) {
-    Node* newNode = (Node*)malloc(sizeof(Node));
+NodeRef createNode(int data) {
+    NodeRef ref = np_alloc_handle(&pool, sizeof(Node));
+    if (ref == NIL) {
+        printf("Memory allocation failed\n");
+        exit(1);
+    }
+    Node* newNode = N(ref);
     newNode->data = data;
-    newNode->left = newNode->right = NULL;
-    return newNode;
+    newNode->left = newNode->right = NIL;
+    return ref;
 }
 
 // Function to insert a node
-Node* insert(Node* root, int data) {
-    if (root == NULL) {
+NodeRef insert(NodeRef root, int data) {
+    if (root == NIL) {
         return createNode(data);
     }
-    if (data < root->data)
-        root->left = insert(root->left, data);
-    else if (data > root->data)
-        root->right = insert(root->right, data);
+    if (data < N(root)->data)
+        N(root)->left = insert(N(root)->left, data);
+    else if (data > N(root)->data)
+        N(root)->right = insert(N(root)->right, data);
 
     return root;
 }
 
 // Function to find the minimum node in a tree
-Node* findMin(Node* root) {
-    while (root && root->left != NULL)
-        root = root->left;
+NodeRef findMin(NodeRef root) {
+    while (root != NIL && N(root)->left != NIL)
+        root = N(root)->left;
     return root;
 }
 
 // Function to delete a node
-Node* deleteNode(Node* root, int data) {
-    if (root == NULL) return root;
+NodeRef deleteNode(NodeRef root, int data) {
+    if (root == NIL) return root;
 
-    if (data < root->data) {
-        root->left = deleteNode(root->left, data);
+    if (data < N(root)->data) {
+        N(root)->left = deleteNode(N(root)->left, data);
     } 
-    else if (data > root->data) {
-        root->right = deleteNode(root->right, data);
+    else if (data > N(root)->data) {
+        N(root)->right = deleteNode(N(root)->right, data);
     } 
     else {
         // Node found
-        if (root->left == NULL) {
-            Node* temp = root->right;
-            free(root);
+        if (N(root)->left == NIL) {
+            NodeRef temp = N(root)->right;
+            np_free_handle(&pool, root);
             return temp;
         }
-        else if (root->right == NULL) {
-            Node* temp = root->left;
-            free(root);
+        else if (N(root)->right == NIL) {
+            NodeRef temp = N(root)->left;
+            np_free_handle(&pool, root);
             return temp;
         }
         // Two children
-        Node* temp = findMin(root->right);
-        root->data = temp->data;
-        root->right = deleteNode(root->right, temp->data);
+        NodeRef temp = findMin(N(root)->right);
+        N(root)->data = N(temp)->data;
+        N(root)->right = deleteNode(N(root)->right, N(temp)->data);
     }
     return root;
 }
 
 // Inorder Traversal
-void inorder(Node* root) {
-    if (root != NULL) {
-        inorder(root->left);
-        printf("%d ", root->data);
-        inorder(root->right);
+void inorder(NodeRef root) {
+    if (root != NIL) {
+        inorder(N(root)->left);
+        printf("%d ", N(root)->data);
+        inorder(N(root)->right);
     }
 }
 
 // Preorder Traversal
-void preorder(Node* root) {
-    if (root != NULL) {
-        printf("%d ", root->data);
-        preorder(root->left);
-        preorder(root->right);
+void preorder(NodeRef root) {
+    if (root != NIL) {
+        printf("%d ", N(root)->data);
+        preorder(N(root)->left);
+        preorder(N(root)->right);
     }
 }
 
 // Postorder Traversal
-void postorder(Node* root) {
-    if (root != NULL) {
-        postorder(root->left);
-        postorder(root->right);
-        printf("%d ", root->data);
+void postorder(NodeRef root) {
+    if (root != NIL) {
+        postorder(N(root)->left);
+        postorder(N(root)->right);
+        printf("%d ", N(root)->data);
     }
 }
 
 // Print as list (Inorder gives sorted list)
-void printList(Node* root) {
+void printList(NodeRef root) {
     printf("List: ");
     inorder(root);
     printf("\n");
@@ -101,9 +117,11 @@ void printList(Node* root) {
 
 // Main program
 int main() {
-    Node* root = NULL;
+    NodeRef root = NIL;
     int choice, val;
 
+    np_init(&pool, 0);
+
     while (1) {
         printf("\n--- Binary Search Tree Operations ---\n");
         printf("1. Insert\n2. Delete\n3. Inorder Traversal\n");
@@ -141,6 +159,7 @@ int main() {
                 printList(root);
                 break;
             case 7:
+                np_destroy(&pool);
                 exit(0);
             default:
                 printf("Invalid choice!\n");
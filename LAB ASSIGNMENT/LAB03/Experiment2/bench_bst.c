@@ -0,0 +1,69 @@
+/*
+   Ordered index benchmark for the binary search tree (see common/index_bench.h).
+   The tree is not balanced, so the ascending-key workloads are limited to
+   20000 keys; beyond that the recursive insert would run for O(n^2) time.
+
+   Usage:
+       gcc -O2 bench_bst.c -o bench_bst -lm
+       ./bench_bst [--n 1000,100000,1000000] [--ops N] [--workload ...]
+*/
+#define main bst_main
+#include "BinarySearchTree.c"
+#undef main
+#include "../../common/index_bench.h"
+
+NodeRef root = NIL;
+
+void ib_reset(void) {
+    np_destroy(&pool);
+    np_init(&pool, 0);
+    root = NIL;
+}
+
+void ib_insert(int key) { root = insert(root, key); }
+
+void ib_erase(int key) { root = deleteNode(root, key); }
+
+int ib_find(int key) {
+    NodeRef n = root;
+    while (n != NIL && N(n)->data != key)
+        n = key < N(n)->data ? N(n)->left : N(n)->right;
+    return n != NIL;
+}
+
+// In-order walk of [lo, hi) with an explicit stack, skipping subtrees
+// that lie outside the range
+long ib_range(int lo, int hi) {
+    static NodeRef* stack = NULL;
+    static int cap = 0;
+    int top = 0;
+    long count = 0;
+    NodeRef n = root;
+    while (1) {
+        while (n != NIL) {
+            if (N(n)->data < lo) {
+                n = N(n)->right;
+                continue;
+            }
+            if (top == cap) {
+                cap = cap ? 2 * cap : 64;
+                stack = (NodeRef*)realloc(stack, cap * sizeof(NodeRef));
+            }
+            stack[top++] = n;
+            n = N(n)->left;
+        }
+        if (top == 0)
+            break;
+        n = stack[--top];
+        if (N(n)->data >= hi)
+            break;
+        count++;
+        n = N(n)->right;
+    }
+    return count;
+}
+
+int main(int argc, char** argv) {
+    np_init(&pool, 0);
+    return ib_main(argc, argv, "BST", 20000);
+}
@@ -1,14 +1,26 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include <unistd.h>
+#include "../../common/node_pool.h"
 
-// Node structure for AVL tree
+// Node structure for AVL tree (the two ints sit together, so a node is 24 bytes)
 struct Node {
     int key;
+    int height;
     struct Node* left;
     struct Node* right;
-    int height;
 };
 
+// All nodes come from this pool and are released together on exit.
+// It is thread-safe because the parallel union frees duplicate keys.
+NodePool pool;
+
+int PARALLEL_DEPTH = 0;           // fork-join levels used by unionTrees
+#define PARALLEL_MIN_HEIGHT 12    // subtrees smaller than this are not forked
+
 // Function to get height of the tree
 int height(struct Node* N) {
     if (N == NULL)
@@ -23,7 +35,11 @@ int max(int a, int b) {
 
 // Allocate new node
 struct Node* newNode(int key) {
-    struct Node* node = (struct Node*)malloc(sizeof(struct Node));
+    struct Node* node = (struct Node*)np_alloc(&pool, sizeof(struct Node));
+    if (node == NULL) {
+        printf("Memory allocation failed\n");
+        exit(1);
+    }
     node->key   = key;
     node->left   = NULL;
     node->right  = NULL;
@@ -137,7 +153,7 @@ struct Node* deleteNode(struct Node* root, int key) {
                 root = NULL;
             } else
                 *root = *temp;
-            free(temp);
+            np_free(&pool, temp, sizeof(struct Node));
         } else {
             struct Node* temp = minValueNode(root->right);
             root->key = temp->key;
@@ -170,6 +186,191 @@ struct Node* deleteNode(struct Node* root, int key) {
     return root;
 }
 
+// ---------- Bulk operations ----------
+
+// Builds a perfectly balanced tree from sorted distinct keys[lo..hi) in O(n)
+struct Node* buildFromSorted(int keys[], int lo, int hi) {
+    if (lo >= hi)
+        return NULL;
+    int mid = lo + (hi - lo) / 2;
+    struct Node* node = newNode(keys[mid]);
+    node->left = buildFromSorted(keys, lo, mid);
+    node->right = buildFromSorted(keys, mid + 1, hi);
+    node->height = 1 + max(height(node->left), height(node->right));
+    return node;
+}
+
+// Makes k the parent of l and r and fixes its height
+struct Node* linkNode(struct Node* l, struct Node* k, struct Node* r) {
+    k->left = l;
+    k->right = r;
+    k->height = 1 + max(height(l), height(r));
+    return k;
+}
+
+// Join when tl is taller: descend tl's right spine until the heights match,
+// attach there and rebalance on the way up (Blelloch, Ferizovic and Sun)
+struct Node* joinRight(struct Node* tl, struct Node* k, struct Node* tr) {
+    struct Node* c = tl->right;
+    if (height(c) <= height(tr) + 1) {
+        struct Node* t = linkNode(c, k, tr);
+        if (height(t) <= height(tl->left) + 1)
+            return linkNode(tl->left, tl, t);
+        return leftRotate(linkNode(tl->left, tl, rightRotate(t)));
+    }
+    struct Node* t = joinRight(c, k, tr);
+    linkNode(tl->left, tl, t);
+    if (height(t) <= height(tl->left) + 1)
+        return tl;
+    return leftRotate(tl);
+}
+
+// Mirror image of joinRight, for a taller tr
+struct Node* joinLeft(struct Node* tl, struct Node* k, struct Node* tr) {
+    struct Node* c = tr->left;
+    if (height(c) <= height(tl) + 1) {
+        struct Node* t = linkNode(tl, k, c);
+        if (height(t) <= height(tr->right) + 1)
+            return linkNode(t, tr, tr->right);
+        return rightRotate(linkNode(leftRotate(t), tr, tr->right));
+    }
+    struct Node* t = joinLeft(tl, k, c);
+    linkNode(t, tr, tr->right);
+    if (height(t) <= height(tr->right) + 1)
+        return tr;
+    return rightRotate(tr);
+}
+
+// All keys of tl < k->key < all keys of tr. O(|height(tl) - height(tr)|).
+struct Node* join(struct Node* tl, struct Node* k, struct Node* tr) {
+    if (height(tl) > height(tr) + 1)
+        return joinRight(tl, k, tr);
+    if (height(tr) > height(tl) + 1)
+        return joinLeft(tl, k, tr);
+    return linkNode(tl, k, tr);
+}
+
+// Splits t into keys < key (*l) and keys > key (*r). A node holding key
+// itself is detached and returned in *match.
+void split(struct Node* t, int key, struct Node** l, struct Node** r, struct Node** match) {
+    if (t == NULL) {
+        *l = *r = *match = NULL;
+        return;
+    }
+    struct Node* left = t->left;
+    struct Node* right = t->right;
+    if (key == t->key) {
+        *l = left;
+        *r = right;
+        *match = t;
+    } else if (key < t->key) {
+        struct Node* rr;
+        split(left, key, l, &rr, match);
+        *r = join(rr, t, right);
+    } else {
+        struct Node* ll;
+        split(right, key, &ll, r, match);
+        *l = join(left, t, ll);
+    }
+}
+
+struct Node* unionTrees(struct Node* t1, struct Node* t2, int depth);
+
+typedef struct {
+    struct Node *a, *b, *result;
+    int depth;
+} UnionTask;
+
+void* unionTask(void* arg) {
+    UnionTask* t = (UnionTask*)arg;
+    t->result = unionTrees(t->a, t->b, t->depth);
+    np_thread_flush(&pool);
+    return NULL;
+}
+
+// Union of two trees; duplicate keys of t2 are freed. Work is
+// O(m log(n/m + 1)) for sizes m <= n. The two recursive unions are
+// independent, so the top PARALLEL_DEPTH levels run them in parallel.
+struct Node* unionTrees(struct Node* t1, struct Node* t2, int depth) {
+    if (t1 == NULL) return t2;
+    if (t2 == NULL) return t1;
+
+    struct Node *l2, *r2, *dup;
+    split(t2, t1->key, &l2, &r2, &dup);
+    if (dup != NULL)
+        np_free(&pool, dup, sizeof(struct Node));
+
+    struct Node* l1 = t1->left;
+    struct Node* r1 = t1->right;
+    struct Node *l, *r;
+
+    pthread_t tid;
+    UnionTask task = { l1, l2, NULL, depth + 1 };
+    if (depth < PARALLEL_DEPTH && height(t1) >= PARALLEL_MIN_HEIGHT &&
+        pthread_create(&tid, NULL, unionTask, &task) == 0) {
+        r = unionTrees(r1, r2, depth + 1);
+        pthread_join(tid, NULL);
+        l = task.result;
+    } else {
+        l = unionTrees(l1, l2, depth + 1);
+        r = unionTrees(r1, r2, depth + 1);
+    }
+    return join(l, t1, r);
+}
+
+int compareInts(const void* a, const void* b) {
+    int x = *(const int*)a, y = *(const int*)b;
+    return (x > y) - (x < y);
+}
+
+// Inserts n keys at once: sort, drop duplicates, build a tree, then union
+struct Node* insertBatch(struct Node* root, int keys[], int n) {
+    qsort(keys, n, sizeof(int), compareInts);
+    int m = 0;
+    for (int i = 0; i < n; i++)
+        if (m == 0 || keys[i] != keys[m - 1])
+            keys[m++] = keys[i];
+    return unionTrees(root, buildFromSorted(keys, 0, m), 0);
+}
+
+// ---------- Range iterator over [lo, hi) ----------
+
+// The stack holds the nodes whose keys are still to be returned along the
+// current path. AVL height is below 1.45 log2(n + 2), so 64 entries suffice.
+typedef struct {
+    struct Node* stack[64];
+    int top;
+    int hi;
+} RangeIter;
+
+void rangeBegin(RangeIter* it, struct Node* root, int lo, int hi) {
+    it->top = 0;
+    it->hi = hi;
+    while (root != NULL) {
+        if (root->key >= lo) {
+            it->stack[it->top++] = root;
+            root = root->left;
+        } else {
+            root = root->right;
+        }
+    }
+}
+
+// Stores the next key in *key; returns 0 when the range is exhausted
+int rangeNext(RangeIter* it, int* key) {
+    if (it->top == 0)
+        return 0;
+    struct Node* n = it->stack[--it->top];
+    if (n->key >= it->hi) {
+        it->top = 0;
+        return 0;
+    }
+    *key = n->key;
+    for (struct Node* c = n->right; c != NULL; c = c->left)
+        it->stack[it->top++] = c;
+    return 1;
+}
+
 // Traversals
 void preOrder(struct Node* root) {
     if(root != NULL) {
@@ -187,18 +388,100 @@ void inOrder(struct Node* root) {
     }
 }
 
+// Returns the height if root is a valid AVL search tree, -1 otherwise
+int checkAVL(struct Node* root, long lo, long hi) {
+    if (root == NULL)
+        return 0;
+    if (root->key <= lo || root->key >= hi)
+        return -1;
+    int hl = checkAVL(root->left, lo, root->key);
+    int hr = checkAVL(root->right, root->key, hi);
+    if (hl < 0 || hr < 0 || hl - hr > 1 || hr - hl > 1 || root->height != 1 + max(hl, hr))
+        return -1;
+    return root->height;
+}
+
+double wallTime(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// Compares one-at-a-time inserts with the bulk operations on n random keys
+void benchmark(int n) {
+    int* keys = (int*)malloc(n * sizeof(int));
+    int* batch = (int*)malloc((n / 10 + 1) * sizeof(int));
+    srand(1);
+    for (int i = 0; i < n; i++)
+        keys[i] = rand();
+
+    double t = wallTime();
+    struct Node* a = NULL;
+    for (int i = 0; i < n; i++)
+        a = insert(a, keys[i]);
+    printf("Insert %d keys one by one:     %.3f s\n", n, wallTime() - t);
+
+    t = wallTime();
+    struct Node* b = insertBatch(NULL, keys, n);
+    printf("Sort + build from sorted:      %.3f s\n", wallTime() - t);
+
+    int m = n / 10;
+    for (int i = 0; i < m; i++)
+        batch[i] = rand();
+
+    t = wallTime();
+    for (int i = 0; i < m; i++)
+        a = insert(a, batch[i]);
+    printf("Insert %d more one by one:     %.3f s\n", m, wallTime() - t);
+
+    t = wallTime();
+    b = insertBatch(b, batch, m);
+    printf("Batch insert (union, depth %d): %.3f s\n", PARALLEL_DEPTH, wallTime() - t);
+
+    // Both trees must hold the same keys; compare them with range iterators
+    RangeIter ia, ib;
+    int ka, kb, same = 1;
+    long count = 0;
+    t = wallTime();
+    rangeBegin(&ia, a, 0, RAND_MAX);
+    rangeBegin(&ib, b, 0, RAND_MAX);
+    while (rangeNext(&ia, &ka)) {
+        if (!rangeNext(&ib, &kb) || ka != kb) same = 0;
+        count++;
+    }
+    if (rangeNext(&ib, &kb)) same = 0;
+    printf("Range scan of %ld keys:     %.3f s\n", count, wallTime() - t);
+    printf("Trees %s, batch tree %s\n", same ? "match" : "DIFFER",
+           checkAVL(b, -1L, (long)RAND_MAX + 1) >= 0 ? "is a valid AVL tree" : "is INVALID");
+
+    free(keys);
+    free(batch);
+}
+
 // Driver program with user input
-int main() {
+int main(int argc, char** argv) {
     struct Node* root = NULL;
     int choice, val;
 
+    np_init(&pool, 1);
+    for (long p = 1; p < sysconf(_SC_NPROCESSORS_ONLN); p *= 2)
+        PARALLEL_DEPTH++;
+
+    if (argc > 2 && strcmp(argv[1], "--bench") == 0) {
+        benchmark(atoi(argv[2]));
+        np_destroy(&pool);
+        return 0;
+    }
+
     while (1) {
         printf("\n\n--- AVL Tree Menu ---\n");
         printf("1. Insert\t");
         printf("2. Delete\t");
         printf("3. Preorder Traversal\t");
         printf("4. Inorder Traversal\t");
-        printf("5. Exit\n");
+        printf("5. Batch Insert\t");
+        printf("6. Range Query\t");
+        printf("7. Exit\n");
         printf("Enter choice: ");
         scanf("%d", &choice);
 
@@ -227,7 +510,36 @@ int main() {
                 printf("\n");
                 break;
 
-            case 5:
+            case 5: {
+                int n;
+                printf("Enter number of values: ");
+                scanf("%d", &n);
+                if (n <= 0)
+                    break;
+                int* keys = (int*)malloc(n * sizeof(int));
+                printf("Enter %d values: ", n);
+                for (int i = 0; i < n; i++)
+                    scanf("%d", &keys[i]);
+                root = insertBatch(root, keys, n);
+                free(keys);
+                break;
+            }
+
+            case 6: {
+                int lo, hi, key;
+                RangeIter it;
+                printf("Enter range [lo, hi): ");
+                scanf("%d %d", &lo, &hi);
+                printf("Keys: ");
+                rangeBegin(&it, root, lo, hi);
+                while (rangeNext(&it, &key))
+                    printf("%d ", key);
+                printf("\n");
+                break;
+            }
+
+            case 7:
+                np_destroy(&pool);
                 exit(0);
 
             default:
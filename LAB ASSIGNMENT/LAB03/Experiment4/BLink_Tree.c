@@ -0,0 +1,693 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+#include <time.h>
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+
+/*
+   Concurrent B-link tree (uint64 keys -> uint64 values) after Lehman and
+   Yao, "Efficient Locking for Concurrent Operations on B-Trees", with
+   optimistic lock coupling for readers.
+
+   - Every node has a high key and a right link. A node holds keys smaller
+     than its high key, and a search that arrives at a node with
+     key >= high key simply follows the right link. A split therefore never
+     needs to lock the parent first: the new right half is reachable
+     through the link as soon as the split is published.
+   - Each node has a version counter that is odd while a writer holds the
+     node. Readers take no locks: they read the version, read the node,
+     and check that the version is still the same. If it changed, they
+     re-read that node (never the whole path, since nodes are not freed).
+   - Writers lock only the leaf. Moving right, or going up after a split,
+     locks the next node before releasing the current one, so a writer never
+     holds more than two latches. Locks are always taken left to right
+     within a level and bottom-up across levels, which rules out deadlock.
+   - Deletes remove the key from its leaf without merging (as in the
+     original B-link tree), so nodes are never freed while the tree is in use.
+
+   Usage:
+     BLink_Tree                         interactive menu
+     BLink_Tree --stress [T] [N]        T threads insert / delete N keys each, then check
+     BLink_Tree --bench [T] [sec] [keys] YCSB-style workloads for 1..T threads
+*/
+
+#define NODE_KEYS   32
+#define MAX_LEVELS  32
+#define KEY_MAX     UINT64_MAX     // reserved: high key of the rightmost nodes
+#define MAX_THREADS 64
+
+#define LOAD(x)      __atomic_load_n(&(x), __ATOMIC_ACQUIRE)
+#define STORE(x, v)  __atomic_store_n(&(x), (v), __ATOMIC_RELEASE)
+
+typedef struct Node {
+    uint64_t version;         // odd while locked
+    int level;                // 0 = leaf
+    int count;                // number of keys
+    uint64_t highKey;         // all keys in the node are < highKey
+    struct Node* next;        // right sibling on the same level
+    uint64_t keys[NODE_KEYS];
+    uintptr_t slot[NODE_KEYS + 1];  // leaf: value of keys[i]; inner: child i
+    struct Node* allNext;     // list of every node, for teardown
+} Node;
+
+typedef struct {
+    Node* root;
+    Node* all;
+} Tree;
+
+/* ---------- Nodes and versions ---------- */
+Node* newNode(Tree* t, int level) {
+    Node* n = (Node*)aligned_alloc(64, (sizeof(Node) + 63) & ~(size_t)63);
+    memset(n, 0, sizeof(Node));
+    n->level = level;
+    n->highKey = KEY_MAX;
+    Node* head = LOAD(t->all);
+    do {
+        n->allNext = head;
+    } while (!__atomic_compare_exchange_n(&t->all, &head, n, 1, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE));
+    return n;
+}
+
+void cpuRelax(int* spins) {
+    if (++*spins > 100) {
+        sched_yield();
+        *spins = 0;
+    }
+}
+
+// Waits until no writer holds n and returns its version
+uint64_t readLock(Node* n) {
+    int spins = 0;
+    uint64_t v;
+    while ((v = LOAD(n->version)) & 1)
+        cpuRelax(&spins);
+    return v;
+}
+
+// True if n did not change since readLock returned v
+int validate(Node* n, uint64_t v) {
+    return LOAD(n->version) == v;
+}
+
+void writeLock(Node* n) {
+    int spins = 0;
+    while (1) {
+        uint64_t v = LOAD(n->version);
+        if (!(v & 1) && __atomic_compare_exchange_n(&n->version, &v, v + 1, 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+            return;
+        cpuRelax(&spins);
+    }
+}
+
+void writeUnlock(Node* n) {
+    STORE(n->version, LOAD(n->version) + 1);
+}
+
+void initTree(Tree* t) {
+    t->all = NULL;
+    t->root = newNode(t, 0);
+}
+
+void destroyTree(Tree* t) {
+    Node* n = t->all;
+    while (n) {
+        Node* next = n->allNext;
+        free(n);
+        n = next;
+    }
+    t->root = t->all = NULL;
+}
+
+/* ---------- Searching inside a node ---------- */
+
+// Number of keys < key (count may come from an unvalidated read)
+int lowerBound(Node* n, int count, uint64_t key) {
+    int lo = 0, hi = count;
+    while (lo < hi) {
+        int mid = (lo + hi) / 2;
+        if (LOAD(n->keys[mid]) < key) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo;
+}
+
+// Number of keys <= key: the child of an inner node to follow
+int upperBound(Node* n, int count, uint64_t key) {
+    int lo = 0, hi = count;
+    while (lo < hi) {
+        int mid = (lo + hi) / 2;
+        if (LOAD(n->keys[mid]) <= key) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo;
+}
+
+int nodeCount(Node* n) {
+    int c = LOAD(n->count);
+    return c < 0 ? 0 : c > NODE_KEYS ? NODE_KEYS : c;
+}
+
+// Optimistically finds the node on `level` whose range holds key. Records
+// the last node visited on every level above in path (if given).
+Node* descend(Tree* t, uint64_t key, int level, Node** path, uint64_t* version) {
+    Node* n = LOAD(t->root);
+    while (1) {
+        uint64_t v = readLock(n);
+        if (key >= LOAD(n->highKey)) {
+            Node* right = LOAD(n->next);
+            if (validate(n, v))
+                n = right;
+            continue;
+        }
+        if (n->level == level) {
+            *version = v;
+            return n;
+        }
+        Node* child = (Node*)LOAD(n->slot[upperBound(n, nodeCount(n), key)]);
+        if (!validate(n, v))
+            continue;
+        if (path)
+            path[n->level] = n;
+        n = child;
+    }
+}
+
+// Locks the node on n's level whose range holds key, moving right if needed
+Node* lockCovering(Node* n, uint64_t key) {
+    writeLock(n);
+    while (key >= n->highKey) {
+        Node* right = n->next;
+        writeLock(right);
+        writeUnlock(n);
+        n = right;
+    }
+    return n;
+}
+
+/* ---------- Updates (caller holds the node's lock) ---------- */
+
+// Inserts key at pos; its slot goes to pos in a leaf and pos + 1 in an inner node
+void insertAt(Node* n, int pos, uint64_t key, uintptr_t slot) {
+    int c = n->count, off = n->level > 0;
+    for (int i = c; i > pos; i--)
+        STORE(n->keys[i], n->keys[i - 1]);
+    for (int i = c + off; i > pos + off; i--)
+        STORE(n->slot[i], n->slot[i - 1]);
+    STORE(n->keys[pos], key);
+    STORE(n->slot[pos + off], slot);
+    STORE(n->count, c + 1);
+}
+
+// n is full: merges (key, slot) in at pos, moves the upper half to a new
+// right sibling and returns it. *sep is the separator for the parent.
+Node* splitInsert(Tree* t, Node* n, int pos, uint64_t key, uintptr_t slot, uint64_t* sep) {
+    uint64_t tk[NODE_KEYS + 1];
+    uintptr_t ts[NODE_KEYS + 2];
+    int off = n->level > 0, total = NODE_KEYS + 1;
+    memcpy(tk, n->keys, pos * sizeof(uint64_t));
+    tk[pos] = key;
+    memcpy(tk + pos + 1, n->keys + pos, (NODE_KEYS - pos) * sizeof(uint64_t));
+    memcpy(ts, n->slot, (pos + off) * sizeof(uintptr_t));
+    ts[pos + off] = slot;
+    memcpy(ts + pos + off + 1, n->slot + pos + off, (NODE_KEYS - pos) * sizeof(uintptr_t));
+
+    // the right node is built completely before anything links to it
+    Node* right = newNode(t, n->level);
+    int half = total / 2, leftCount, rightStart;
+    if (n->level == 0) {
+        leftCount = half;                 // leaves: the separator stays in the right half
+        rightStart = half;
+        *sep = tk[half];
+        memcpy(right->slot, ts + half, (total - half) * sizeof(uintptr_t));
+    } else {
+        leftCount = half;                 // inner nodes: the separator moves up
+        rightStart = half + 1;
+        *sep = tk[half];
+        memcpy(right->slot, ts + half + 1, (total - half) * sizeof(uintptr_t));
+    }
+    right->count = total - rightStart;
+    memcpy(right->keys, tk + rightStart, right->count * sizeof(uint64_t));
+    right->highKey = n->highKey;
+    right->next = n->next;
+
+    for (int i = 0; i < leftCount; i++)
+        STORE(n->keys[i], tk[i]);
+    for (int i = 0; i < leftCount + off; i++)
+        STORE(n->slot[i], ts[i]);
+    STORE(n->count, leftCount);
+    STORE(n->highKey, *sep);
+    STORE(n->next, right);
+    return right;
+}
+
+/* ---------- Operations ---------- */
+
+// Returns 1 and sets *value if key is present
+int lookup(Tree* t, uint64_t key, uint64_t* value) {
+    uint64_t v;
+    Node* n = descend(t, key, 0, NULL, &v);
+    while (1) {
+        if (key >= LOAD(n->highKey)) {
+            Node* right = LOAD(n->next);
+            if (validate(n, v))
+                n = right;
+            v = readLock(n);
+            continue;
+        }
+        int count = nodeCount(n);
+        int i = lowerBound(n, count, key);
+        int found = i < count && LOAD(n->keys[i]) == key;
+        uint64_t val = found ? (uint64_t)LOAD(n->slot[i]) : 0;
+        if (validate(n, v)) {
+            if (found) *value = val;
+            return found;
+        }
+        v = readLock(n);
+    }
+}
+
+// Inserts or updates key (< KEY_MAX); returns 1 if the key is new
+int insert(Tree* t, uint64_t key, uint64_t value) {
+    Node* path[MAX_LEVELS] = { 0 };
+    uint64_t v;
+    Node* n = lockCovering(descend(t, key, 0, path, &v), key);
+
+    int i = lowerBound(n, n->count, key);
+    if (i < n->count && n->keys[i] == key) {
+        STORE(n->slot[i], value);
+        writeUnlock(n);
+        return 0;
+    }
+    if (n->count < NODE_KEYS) {
+        insertAt(n, i, key, value);
+        writeUnlock(n);
+        return 1;
+    }
+
+    uint64_t sep;
+    Node* right = splitInsert(t, n, i, key, value, &sep);
+    while (1) {
+        // n is locked and was just split into n and right
+        int level = n->level;
+        Node* parent = path[level + 1];
+        if (parent == NULL) {
+            if (LOAD(t->root) == n) {
+                Node* root = newNode(t, level + 1);
+                root->keys[0] = sep;
+                root->slot[0] = (uintptr_t)n;
+                root->slot[1] = (uintptr_t)right;
+                root->count = 1;
+                STORE(t->root, root);
+                writeUnlock(n);
+                return 1;
+            }
+            // the tree grew above n after we passed: find the parent again
+            parent = descend(t, sep, level + 1, NULL, &v);
+        }
+        parent = lockCovering(parent, sep);
+        writeUnlock(n);
+        n = parent;
+
+        int pos = upperBound(n, n->count, sep);
+        if (n->count < NODE_KEYS) {
+            insertAt(n, pos, sep, (uintptr_t)right);
+            writeUnlock(n);
+            return 1;
+        }
+        uint64_t upSep;
+        right = splitInsert(t, n, pos, sep, (uintptr_t)right, &upSep);
+        sep = upSep;
+    }
+}
+
+// Removes key from its leaf; returns 1 if it was present
+int removeKey(Tree* t, uint64_t key) {
+    uint64_t v;
+    Node* n = lockCovering(descend(t, key, 0, NULL, &v), key);
+    int c = n->count;
+    int i = lowerBound(n, c, key);
+    int found = i < c && n->keys[i] == key;
+    if (found) {
+        for (int j = i; j < c - 1; j++) {
+            STORE(n->keys[j], n->keys[j + 1]);
+            STORE(n->slot[j], n->slot[j + 1]);
+        }
+        STORE(n->count, c - 1);
+    }
+    writeUnlock(n);
+    return found;
+}
+
+// Copies up to max keys >= start, in order, into out; returns how many
+int scan(Tree* t, uint64_t start, int max, uint64_t* out) {
+    uint64_t v, from = start;
+    Node* n = descend(t, start, 0, NULL, &v);
+    int got = 0;
+    while (got < max) {
+        uint64_t buf[NODE_KEYS];
+        int count = nodeCount(n), k = 0;
+        for (int i = lowerBound(n, count, from); i < count && got + k < max; i++)
+            buf[k++] = LOAD(n->keys[i]);
+        uint64_t high = LOAD(n->highKey);
+        Node* right = LOAD(n->next);
+        if (!validate(n, v)) {
+            v = readLock(n);
+            continue;
+        }
+        memcpy(out + got, buf, k * sizeof(uint64_t));
+        got += k;
+        if (right == NULL)
+            break;
+        from = high;                  // everything below high was in n
+        n = right;
+        v = readLock(n);
+    }
+    return got;
+}
+
+/* ---------- Checks ---------- */
+
+// Walks every level along the right links (single-threaded). Checks key
+// order, high keys and child ranges; returns the number of keys or -1.
+long checkTree(Tree* t) {
+    long keys = 0;
+    Node* first = t->root;
+    while (1) {
+        for (Node* n = first; n; n = n->next) {
+            for (int i = 0; i < n->count; i++) {
+                if ((i > 0 && n->keys[i - 1] >= n->keys[i]) || n->keys[i] >= n->highKey)
+                    return -1;
+                if (n->level > 0 && ((Node*)n->slot[i + 1])->level != n->level - 1)
+                    return -1;
+            }
+            if (n->next == NULL ? n->highKey != KEY_MAX : n->next->level != n->level)
+                return -1;
+            if (n->level == 0)
+                keys += n->count;
+        }
+        if (first->level == 0)
+            return keys;
+        first = (Node*)first->slot[0];
+    }
+}
+
+/* ---------- Random numbers and time ---------- */
+unsigned long long nextRandom(unsigned long long* s) {
+    *s ^= *s << 13;
+    *s ^= *s >> 7;
+    *s ^= *s << 17;
+    return *s;
+}
+
+double wallTime(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// Spreads record numbers over the key space, as YCSB does
+uint64_t recordKey(uint64_t r) {
+    r += 0x9E3779B97F4A7C15ULL;
+    r = (r ^ (r >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    r = (r ^ (r >> 27)) * 0x94D049BB133111EBULL;
+    return (r ^ (r >> 31)) % (KEY_MAX - 1);
+}
+
+/* ---------- Stress test ---------- */
+typedef struct {
+    Tree* tree;
+    int id, threads;
+    long n, errors;
+} StressArg;
+
+// Thread id owns keys k with k % threads == id. It inserts them, checks
+// each one right away, deletes every third one and runs scans in between.
+void* stressWorker(void* p) {
+    StressArg* a = (StressArg*)p;
+    uint64_t out[64];
+    for (long i = 0; i < a->n; i++) {
+        uint64_t key = (uint64_t)(i * a->threads + a->id) * 7919 % 100000007ULL * a->threads + a->id;
+        uint64_t v;
+        insert(a->tree, key, key + 1);
+        if (!lookup(a->tree, key, &v) || v != key + 1)
+            a->errors++;
+        if (i % 3 == 0 && !removeKey(a->tree, key))
+            a->errors++;
+        if (i % 64 == 0) {
+            int got = scan(a->tree, key, 64, out);
+            for (int j = 1; j < got; j++)
+                if (out[j - 1] >= out[j])
+                    a->errors++;
+        }
+    }
+    return NULL;
+}
+
+int stressTest(int threads, long n) {
+    Tree tree;
+    initTree(&tree);
+    StressArg args[MAX_THREADS];
+    pthread_t tid[MAX_THREADS];
+    double s = wallTime();
+    for (int i = 0; i < threads; i++) {
+        args[i] = (StressArg){ &tree, i, threads, n, 0 };
+        pthread_create(&tid[i], NULL, stressWorker, &args[i]);
+    }
+    long errors = 0;
+    for (int i = 0; i < threads; i++) {
+        pthread_join(tid[i], NULL);
+        errors += args[i].errors;
+    }
+    s = wallTime() - s;
+
+    long expected = 0, missing = 0;
+    for (int id = 0; id < threads; id++)
+        for (long i = 0; i < n; i++) {
+            uint64_t key = (uint64_t)(i * threads + id) * 7919 % 100000007ULL * threads + id, v;
+            int present = lookup(&tree, key, &v);
+            if (i % 3 != 0) {
+                expected++;
+                missing += !present || v != key + 1;
+            } else {
+                missing += present;
+            }
+        }
+    long count = checkTree(&tree);
+    printf("%d threads x %ld keys in %.2f s: %ld errors during the run, %ld wrong keys after, tree %s (%ld keys, expected %ld)\n",
+           threads, n, s, errors, missing, count == expected ? "ok" : "INVALID", count, expected);
+    destroyTree(&tree);
+    return errors == 0 && missing == 0 && count == expected;
+}
+
+/* ---------- YCSB-style benchmark ----------
+   Records are preloaded, then each workload runs for a fixed time.
+   Requests pick records with YCSB's Zipfian distribution (theta 0.99).
+     A: 50% read, 50% update           (update heavy)
+     B: 95% read,  5% update           (read heavy)
+     C: 100% read                      (read only)
+     E: 95% scan of 1-100 keys, 5% insert of a new record
+*/
+typedef struct {
+    long n;
+    double theta, alpha, zetan, eta;
+} Zipf;
+
+void zipfInit(Zipf* z, long n, double theta) {
+    double zeta2 = 1 + pow(0.5, theta);
+    z->n = n;
+    z->theta = theta;
+    z->zetan = 0;
+    for (long i = 1; i <= n; i++)
+        z->zetan += 1 / pow((double)i, theta);
+    z->alpha = 1 / (1 - theta);
+    z->eta = (1 - pow(2.0 / n, 1 - theta)) / (1 - zeta2 / z->zetan);
+}
+
+long zipfNext(Zipf* z, unsigned long long* seed) {
+    double u = (nextRandom(seed) >> 11) * (1.0 / 9007199254740992.0);
+    double uz = u * z->zetan;
+    if (uz < 1) return 0;
+    if (uz < 1 + pow(0.5, z->theta)) return 1;
+    long r = (long)(z->n * pow(z->eta * u - z->eta + 1, z->alpha));
+    return r < z->n ? r : z->n - 1;
+}
+
+typedef struct {
+    Tree* tree;
+    Zipf* zipf;
+    int id, workload;
+    long* nextRecord;
+    volatile int* stop;
+    long ops;
+} BenchArg;
+
+void* benchWorker(void* p) {
+    BenchArg* a = (BenchArg*)p;
+    unsigned long long seed = 0x9E3779B97F4A7C15ULL ^ (unsigned long long)(a->id + 1) * 1000003ULL;
+    uint64_t out[100], v;
+    long ops = 0;
+    while (!LOAD(*a->stop)) {
+        for (int i = 0; i < 64; i++) {
+            int pct = (int)(nextRandom(&seed) % 100);
+            uint64_t key = recordKey((uint64_t)zipfNext(a->zipf, &seed));
+            switch (a->workload) {
+                case 'A':
+                    if (pct < 50) lookup(a->tree, key, &v);
+                    else insert(a->tree, key, (uint64_t)pct);
+                    break;
+                case 'B':
+                    if (pct < 95) lookup(a->tree, key, &v);
+                    else insert(a->tree, key, (uint64_t)pct);
+                    break;
+                case 'C':
+                    lookup(a->tree, key, &v);
+                    break;
+                default:
+                    if (pct < 95) {
+                        scan(a->tree, key, 1 + (int)(nextRandom(&seed) % 100), out);
+                    } else {
+                        long r = __atomic_fetch_add(a->nextRecord, 1, __ATOMIC_RELAXED);
+                        insert(a->tree, recordKey((uint64_t)r), (uint64_t)r);
+                    }
+            }
+        }
+        ops += 64;
+    }
+    a->ops = ops;
+    return NULL;
+}
+
+double runBench(Tree* tree, Zipf* zipf, long* nextRecord, int threads, int workload, double seconds) {
+    volatile int stop = 0;
+    BenchArg args[MAX_THREADS];
+    pthread_t tid[MAX_THREADS];
+    for (int i = 0; i < threads; i++) {
+        args[i] = (BenchArg){ tree, zipf, i, workload, nextRecord, &stop, 0 };
+        pthread_create(&tid[i], NULL, benchWorker, &args[i]);
+    }
+
+    double t = wallTime();
+    usleep((useconds_t)(seconds * 1e6));
+    STORE(stop, 1);
+    long total = 0;
+    for (int i = 0; i < threads; i++) {
+        pthread_join(tid[i], NULL);
+        total += args[i].ops;
+    }
+    t = wallTime() - t;
+    return total / t / 1e6;
+}
+
+void benchmark(int maxThreads, double seconds, long records) {
+    const char workloads[] = "ABCE";
+    if (maxThreads > MAX_THREADS) maxThreads = MAX_THREADS;
+
+    Tree tree;
+    initTree(&tree);
+    for (long r = 0; r < records; r++)
+        insert(&tree, recordKey((uint64_t)r), (uint64_t)r);
+    long nextRecord = records;
+    Zipf zipf;
+    zipfInit(&zipf, records, 0.99);
+
+    printf("%ld records, Zipfian requests, %.1f s per run, Mops/s\n", records, seconds);
+    printf("Threads  A (50/50)  B (95/5)  C (read)  E (scan)\n");
+    for (int t = 1; t <= maxThreads; t *= 2) {
+        printf("%7d", t);
+        for (int w = 0; w < 4; w++) {
+            printf("  %8.2f", runBench(&tree, &zipf, &nextRecord, t, workloads[w], seconds));
+            fflush(stdout);
+        }
+        printf("\n");
+        if (t < maxThreads && t * 2 > maxThreads) t = maxThreads / 2;   // always end at maxThreads
+    }
+    printf("Tree after the runs: %s\n", checkTree(&tree) >= records ? "ok" : "INVALID");
+    destroyTree(&tree);
+}
+
+/* ---------- Driver ---------- */
+int main(int argc, char** argv) {
+    int cores = (int)sysconf(_SC_NPROCESSORS_ONLN);
+
+    if (argc > 1 && strcmp(argv[1], "--stress") == 0) {
+        int threads = argc > 2 ? atoi(argv[2]) : (cores < 8 ? 8 : cores);
+        long n = argc > 3 ? atol(argv[3]) : 200000;
+        if (threads > MAX_THREADS) threads = MAX_THREADS;
+        return stressTest(threads, n) ? 0 : 1;
+    }
+    if (argc > 1 && strcmp(argv[1], "--bench") == 0) {
+        int threads = argc > 2 ? atoi(argv[2]) : cores;
+        double seconds = argc > 3 ? atof(argv[3]) : 1.0;
+        long records = argc > 4 ? atol(argv[4]) : 1000000;
+        benchmark(threads, seconds, records);
+        return 0;
+    }
+
+    Tree tree;
+    initTree(&tree);
+    int choice, count;
+    unsigned long long key, value;
+    uint64_t v, out[1000];
+
+    while (1) {
+        printf("\n\n--- B-link Tree Menu ---\n");
+        printf("1. Insert\t");
+        printf("2. Delete\t");
+        printf("3. Search\t");
+        printf("4. Scan\t");
+        printf("5. Exit\n");
+        printf("Enter choice: ");
+        if (scanf("%d", &choice) != 1)
+            break;
+
+        switch(choice) {
+            case 1:
+                printf("Enter key and value: ");
+                scanf("%llu %llu", &key, &value);
+                if (key == KEY_MAX)
+                    printf("Key %llu is reserved\n", key);
+                else
+                    insert(&tree, key, value);
+                break;
+
+            case 2:
+                printf("Enter key to delete: ");
+                scanf("%llu", &key);
+                if (!removeKey(&tree, key))
+                    printf("%llu not found\n", key);
+                break;
+
+            case 3:
+                printf("Enter key to search: ");
+                scanf("%llu", &key);
+                if (lookup(&tree, key, &v))
+                    printf("%llu -> %llu\n", key, (unsigned long long)v);
+                else
+                    printf("%llu not found\n", key);
+                break;
+
+            case 4:
+                printf("Enter start key and count: ");
+                scanf("%llu %d", &key, &count);
+                if (count > 1000) count = 1000;
+                count = scan(&tree, key, count, out);
+                for (int i = 0; i < count; i++)
+                    printf("%llu ", (unsigned long long)out[i]);
+                printf("\n");
+                break;
+
+            case 5:
+                destroyTree(&tree);
+                exit(0);
+
+            default:
+                printf("Invalid choice!\n");
+        }
+    }
+    destroyTree(&tree);
+    return 0;
+}
@@ -0,0 +1,878 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <signal.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+
+/*
+   Disk-backed B+-tree (int64 keys -> int64 values) stored in one data file.
+
+   - Fixed-size pages (PAGE_SIZE, 4-16 KiB). Keys, values and child page
+     numbers are stored inline in the page. All values are in the leaves,
+     and leaves are linked left to right for range scans.
+   - A buffer pool of POOL_PAGES frames caches pages. It reads and writes
+     them with pread/pwrite and evicts with the CLOCK algorithm.
+   - Crash safety comes from a write-ahead log next to the data file
+     (<file>.wal). Operations are committed in groups (every operation in
+     the menu, up to 10000 in the benchmark). At commit, the full image of
+     every page changed since the last commit is appended to the log with a
+     CRC32 checksum, the last record is flagged, and the log is fsync'ed.
+     Pages changed by an uncommitted group stay pinned, so they never reach
+     the data file before their log records. Because of that pinning, a
+     group also commits early once it has changed half of the buffer pool:
+     a group holds at most poolPages / 2 changed pages, so with random keys
+     over a tree much larger than the pool the pool size, not commitEvery,
+     sets the number of operations per fsync. On open, the log is replayed
+     up to the last complete group, so a crash never leaves a half-done split.
+     A checkpoint writes all dirty pages, fsyncs the data file and empties
+     the log.
+   - Deletes remove the key from its leaf and do not merge pages (lazy
+     deletion), so leaves may be less than half full.
+
+   Usage:
+     BPlus_Tree_Disk [file]                     interactive menu
+     BPlus_Tree_Disk --bench file N [poolPages] I/O counts for N random keys
+     BPlus_Tree_Disk --crash-test file          kill a writer, then recover
+*/
+
+#ifndef PAGE_SIZE
+#define PAGE_SIZE 8192
+#endif
+#if PAGE_SIZE < 4096 || PAGE_SIZE > 16384
+#error "PAGE_SIZE must be between 4 KiB and 16 KiB"
+#endif
+
+#define POOL_PAGES   1024                 // default buffer pool size (8 MiB)
+#define MAX_HEIGHT   16
+#define MAX_OP_PAGES (3 * MAX_HEIGHT + 2)  // pages one operation can change
+#define MIN_POOL     (4 * MAX_OP_PAGES)
+#define WAL_LIMIT    (64L << 20)           // checkpoint when the log is larger
+#define MAGIC        0x42504C54u           // "BPLT"
+#define WAL_MAGIC    0x57414C52u           // "WALR"
+
+enum { PAGE_META = 1, PAGE_LEAF = 2, PAGE_INNER = 3 };
+
+typedef struct {
+    uint32_t checksum;   // CRC32 of the page with this field set to 0
+    uint16_t type;
+    uint16_t count;      // number of keys
+    uint64_t lsn;        // log sequence number of the last logged change
+    uint32_t next;       // leaf: right sibling page (0 = none)
+    uint32_t pad;
+} PageHeader;
+
+typedef struct {
+    uint32_t magic, pageSize;
+    uint32_t root, height;   // height 1 = root is a leaf
+    uint32_t pageCount;
+    uint32_t pad;
+    uint64_t lastLSN;
+    uint64_t keys;
+} Meta;
+
+#define LEAF_CAP  ((PAGE_SIZE - (int)sizeof(PageHeader)) / 16)
+#define INNER_CAP ((PAGE_SIZE - (int)sizeof(PageHeader) - 4) / 12)
+
+#define HDR(p)        ((PageHeader*)(p))
+#define META(p)       ((Meta*)((p) + sizeof(PageHeader)))
+#define LEAF_KEYS(p)  ((int64_t*)((p) + sizeof(PageHeader)))
+#define LEAF_VALS(p)  (LEAF_KEYS(p) + LEAF_CAP)
+#define INNER_KEYS(p) ((int64_t*)((p) + sizeof(PageHeader)))
+#define INNER_KIDS(p) ((uint32_t*)(INNER_KEYS(p) + INNER_CAP))
+
+typedef struct {
+    uint32_t magic;
+    uint32_t crc;        // CRC32 of the rest of the header and the image
+    uint64_t lsn;
+    uint32_t pageId;
+    uint32_t last;       // 1 on the final record of an operation
+} WalHeader;
+
+typedef struct {
+    uint32_t pageId;
+    int pin, dirty, ref, inGroup;
+    int chain;           // next frame in the same hash bucket
+    char* data;
+} Frame;
+
+typedef struct {
+    int fd, walFd;
+    Frame* frames;
+    int nframes, hand;
+    int* bucket;         // page id -> first frame of its hash chain
+    int nbuckets;
+    Meta* meta;          // points into the pinned frame of page 0
+    int metaFrame;
+
+    Frame** group;       // frames changed since the last commit (pinned)
+    int groupCount, groupLimit;
+
+    char* walBuf;        // log records not yet written
+    size_t walLen, walCap;
+    long walSize;        // bytes in the log file
+    uint64_t nextLSN, flushedLSN;
+    int commitEvery, opsInGroup;
+
+    long reads, writes, syncs, commits;
+} BTree;
+
+/* ---------- CRC32 ---------- */
+uint32_t crcTable[256];
+
+void crcInit(void) {
+    for (uint32_t i = 0; i < 256; i++) {
+        uint32_t c = i;
+        for (int k = 0; k < 8; k++)
+            c = c & 1 ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+        crcTable[i] = c;
+    }
+}
+
+uint32_t crc32(uint32_t crc, const void* data, size_t n) {
+    const unsigned char* p = (const unsigned char*)data;
+    crc = ~crc;
+    while (n--)
+        crc = crcTable[(crc ^ *p++) & 0xFF] ^ (crc >> 8);
+    return ~crc;
+}
+
+uint32_t pageChecksum(char* page) {
+    uint32_t saved = HDR(page)->checksum;
+    HDR(page)->checksum = 0;
+    uint32_t c = crc32(0, page, PAGE_SIZE);
+    HDR(page)->checksum = saved;
+    return c;
+}
+
+void die(const char* msg) {
+    perror(msg);
+    exit(1);
+}
+
+/* ---------- Write-ahead log ---------- */
+void walAppend(BTree* t, Frame* f, int last) {
+    size_t need = sizeof(WalHeader) + PAGE_SIZE;
+    if (t->walLen + need > t->walCap) {
+        t->walCap = 2 * (t->walLen + need);
+        t->walBuf = (char*)realloc(t->walBuf, t->walCap);
+    }
+    WalHeader h = { WAL_MAGIC, 0, HDR(f->data)->lsn, f->pageId, (uint32_t)last };
+    h.crc = crc32(crc32(0, &h.lsn, sizeof(h) - 8), f->data, PAGE_SIZE);
+    memcpy(t->walBuf + t->walLen, &h, sizeof(h));
+    memcpy(t->walBuf + t->walLen + sizeof(h), f->data, PAGE_SIZE);
+    t->walLen += need;
+}
+
+// Writes buffered records and makes them durable
+void walFlush(BTree* t) {
+    if (t->walLen == 0)
+        return;
+    if (pwrite(t->walFd, t->walBuf, t->walLen, t->walSize) != (ssize_t)t->walLen)
+        die("wal write");
+    if (fsync(t->walFd) != 0)
+        die("wal fsync");
+    t->walSize += t->walLen;
+    t->walLen = 0;
+    t->flushedLSN = t->nextLSN;
+    t->syncs++;
+}
+
+/* ---------- Buffer pool ---------- */
+int hashPage(BTree* t, uint32_t id) {
+    return (int)((id * 2654435761u) % (uint32_t)t->nbuckets);
+}
+
+void writePage(BTree* t, Frame* f) {
+    if (HDR(f->data)->lsn > t->flushedLSN)
+        walFlush(t);                    // log before data
+    HDR(f->data)->checksum = pageChecksum(f->data);
+    if (pwrite(t->fd, f->data, PAGE_SIZE, (off_t)f->pageId * PAGE_SIZE) != PAGE_SIZE)
+        die("page write");
+    f->dirty = 0;
+    t->writes++;
+}
+
+void unchain(BTree* t, Frame* f) {
+    int* link = &t->bucket[hashPage(t, f->pageId)];
+    int idx = (int)(f - t->frames);
+    while (*link != idx)
+        link = &t->frames[*link].chain;
+    *link = f->chain;
+}
+
+// CLOCK: clear reference bits until an unpinned, unreferenced frame is found
+Frame* victim(BTree* t) {
+    for (int scanned = 0; scanned < 3 * t->nframes; scanned++) {
+        Frame* f = &t->frames[t->hand];
+        t->hand = (t->hand + 1) % t->nframes;
+        if (f->pin > 0)
+            continue;
+        if (f->ref) {
+            f->ref = 0;
+            continue;
+        }
+        if (f->pageId != UINT32_MAX) {
+            if (f->dirty)
+                writePage(t, f);
+            unchain(t, f);
+        }
+        return f;
+    }
+    fprintf(stderr, "buffer pool: all frames pinned\n");
+    exit(1);
+}
+
+Frame* lookup(BTree* t, uint32_t id) {
+    for (int i = t->bucket[hashPage(t, id)]; i >= 0; i = t->frames[i].chain)
+        if (t->frames[i].pageId == id)
+            return &t->frames[i];
+    return NULL;
+}
+
+Frame* install(BTree* t, uint32_t id) {
+    Frame* f = victim(t);
+    int b = hashPage(t, id);
+    f->pageId = id;
+    f->chain = t->bucket[b];
+    t->bucket[b] = (int)(f - t->frames);
+    f->dirty = 0;
+    f->inGroup = 0;
+    return f;
+}
+
+// Returns the page pinned; the caller must unpin it
+Frame* fetch(BTree* t, uint32_t id) {
+    Frame* f = lookup(t, id);
+    if (f == NULL) {
+        f = install(t, id);
+        if (pread(t->fd, f->data, PAGE_SIZE, (off_t)id * PAGE_SIZE) != PAGE_SIZE)
+            die("page read");
+        if (HDR(f->data)->checksum != pageChecksum(f->data)) {
+            fprintf(stderr, "page %u: checksum mismatch\n", id);
+            exit(1);
+        }
+        t->reads++;
+    }
+    f->pin++;
+    f->ref = 1;
+    return f;
+}
+
+void unpin(Frame* f) {
+    f->pin--;
+}
+
+// Records that f changed (keeps it pinned until the group is logged)
+void markDirty(BTree* t, Frame* f) {
+    f->dirty = 1;
+    if (!f->inGroup) {
+        f->inGroup = 1;
+        f->pin++;
+        t->group[t->groupCount++] = f;
+    }
+}
+
+// Allocates a new empty page at the end of the file
+Frame* allocPage(BTree* t, int type) {
+    uint32_t id = t->meta->pageCount++;
+    markDirty(t, &t->frames[t->metaFrame]);
+    Frame* f = install(t, id);
+    memset(f->data, 0, PAGE_SIZE);
+    HDR(f->data)->type = (uint16_t)type;
+    f->pin = 1;
+    f->ref = 1;
+    markDirty(t, f);
+    return f;
+}
+
+void checkpoint(BTree* t);
+
+// Logs the image of every page in the group and makes the records durable
+void logGroup(BTree* t) {
+    if (t->groupCount > 0)
+        t->commits++;
+    for (int i = 0; i < t->groupCount; i++) {
+        Frame* f = t->group[i];
+        HDR(f->data)->lsn = ++t->nextLSN;
+        walAppend(t, f, i == t->groupCount - 1);
+        f->inGroup = 0;
+        unpin(f);
+    }
+    t->groupCount = 0;
+    t->opsInGroup = 0;
+    walFlush(t);
+}
+
+// Makes every completed operation durable
+void commit(BTree* t) {
+    logGroup(t);
+    if (t->walSize > WAL_LIMIT)
+        checkpoint(t);
+}
+
+// Called after every operation; commits when the group is full
+void endOp(BTree* t) {
+    if (++t->opsInGroup >= t->commitEvery || t->groupCount > t->groupLimit)
+        commit(t);
+}
+
+void checkpoint(BTree* t) {
+    logGroup(t);
+    t->meta->lastLSN = t->nextLSN;
+    t->frames[t->metaFrame].dirty = 1;
+    for (int i = 0; i < t->nframes; i++)
+        if (t->frames[i].pageId != UINT32_MAX && t->frames[i].dirty)
+            writePage(t, &t->frames[i]);
+    if (fsync(t->fd) != 0)
+        die("data fsync");
+    if (ftruncate(t->walFd, 0) != 0 || fsync(t->walFd) != 0)
+        die("wal truncate");
+    t->walSize = 0;
+    t->syncs += 2;
+}
+
+/* ---------- Open, recovery and close ---------- */
+
+// Replays the log up to the last complete operation; returns records applied
+long recover(BTree* t) {
+    size_t recSize = sizeof(WalHeader) + PAGE_SIZE;
+    char* pending = NULL;
+    int npending = 0, cap = 0;
+    long applied = 0;
+    off_t pos = 0;
+    char* rec = (char*)malloc(recSize);
+
+    while (pread(t->walFd, rec, recSize, pos) == (ssize_t)recSize) {
+        WalHeader* h = (WalHeader*)rec;
+        if (h->magic != WAL_MAGIC ||
+            h->crc != crc32(crc32(0, &h->lsn, sizeof(WalHeader) - 8), rec + sizeof(WalHeader), PAGE_SIZE))
+            break;                       // torn or garbage tail
+        if (npending == cap) {
+            cap = cap ? 2 * cap : 64;
+            pending = (char*)realloc(pending, recSize * cap);
+        }
+        memcpy(pending + npending++ * recSize, rec, recSize);
+        if (h->last) {
+            for (int i = 0; i < npending; i++) {
+                WalHeader* ph = (WalHeader*)(pending + i * recSize);
+                char* image = pending + i * recSize + sizeof(WalHeader);
+                HDR(image)->checksum = pageChecksum(image);
+                if (pwrite(t->fd, image, PAGE_SIZE, (off_t)ph->pageId * PAGE_SIZE) != PAGE_SIZE)
+                    die("redo write");
+                if (ph->lsn > t->nextLSN)
+                    t->nextLSN = ph->lsn;
+                applied++;
+            }
+            npending = 0;
+        }
+        pos += recSize;
+    }
+
+    free(rec);
+    free(pending);
+    if (fsync(t->fd) != 0 || ftruncate(t->walFd, 0) != 0 || fsync(t->walFd) != 0)
+        die("recovery sync");
+    return applied;
+}
+
+BTree* openTree(const char* path, int poolPages) {
+    crcInit();
+    BTree* t = (BTree*)calloc(1, sizeof(BTree));
+    char walPath[4096];
+    snprintf(walPath, sizeof(walPath), "%s.wal", path);
+    t->fd = open(path, O_RDWR | O_CREAT, 0644);
+    t->walFd = open(walPath, O_RDWR | O_CREAT, 0644);
+    if (t->fd < 0 || t->walFd < 0)
+        die("open");
+
+    if (poolPages < MIN_POOL)
+        poolPages = MIN_POOL;
+    t->nframes = poolPages;
+    t->frames = (Frame*)calloc(poolPages, sizeof(Frame));
+    char* mem = (char*)aligned_alloc(4096, (size_t)poolPages * PAGE_SIZE);
+    for (int i = 0; i < poolPages; i++) {
+        t->frames[i].pageId = UINT32_MAX;
+        t->frames[i].data = mem + (size_t)i * PAGE_SIZE;
+    }
+    t->nbuckets = 2 * poolPages + 1;
+    t->bucket = (int*)malloc(t->nbuckets * sizeof(int));
+    for (int i = 0; i < t->nbuckets; i++)
+        t->bucket[i] = -1;
+    t->group = (Frame**)malloc(poolPages * sizeof(Frame*));
+    t->groupLimit = poolPages / 2;       // leaves half of the pool for eviction
+    t->commitEvery = 1;
+
+    long redo = recover(t);
+    if (redo > 0)
+        printf("Recovery: replayed %ld page images from the log\n", redo);
+
+    struct stat st;
+    fstat(t->fd, &st);
+    Frame* m;
+    if (st.st_size == 0) {
+        // new file: meta page and an empty root leaf
+        m = install(t, 0);
+        memset(m->data, 0, PAGE_SIZE);
+        HDR(m->data)->type = PAGE_META;
+        m->pin = 1;
+        t->metaFrame = (int)(m - t->frames);
+        t->meta = META(m->data);
+        *t->meta = (Meta){ MAGIC, PAGE_SIZE, 1, 1, 1, 0, 0, 0 };
+        markDirty(t, m);
+        Frame* root = allocPage(t, PAGE_LEAF);
+        unpin(root);
+        endOp(t);
+        checkpoint(t);
+    } else {
+        m = fetch(t, 0);
+        t->metaFrame = (int)(m - t->frames);
+        t->meta = META(m->data);
+        if (t->meta->magic != MAGIC || t->meta->pageSize != PAGE_SIZE) {
+            fprintf(stderr, "%s: not a B+-tree file with %d-byte pages\n", path, PAGE_SIZE);
+            exit(1);
+        }
+        if (t->meta->lastLSN > t->nextLSN)
+            t->nextLSN = t->meta->lastLSN;
+    }
+    t->flushedLSN = t->nextLSN;
+    return t;
+}
+
+void closeTree(BTree* t) {
+    checkpoint(t);
+    close(t->fd);
+    close(t->walFd);
+    free(t->frames[0].data);
+    free(t->frames);
+    free(t->bucket);
+    free(t->group);
+    free(t->walBuf);
+    free(t);
+}
+
+/* ---------- Search ---------- */
+
+// Index of the first key >= k
+int lowerBound(int64_t* keys, int n, int64_t k) {
+    int lo = 0, hi = n;
+    while (lo < hi) {
+        int mid = (lo + hi) / 2;
+        if (keys[mid] < k) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo;
+}
+
+// Child to follow in an inner page: the number of separators <= k
+int childIndex(char* page, int64_t k) {
+    int64_t* keys = INNER_KEYS(page);
+    int lo = 0, hi = HDR(page)->count;
+    while (lo < hi) {
+        int mid = (lo + hi) / 2;
+        if (keys[mid] <= k) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo;
+}
+
+// Returns the pinned leaf that would hold k; records the path if asked
+Frame* findLeaf(BTree* t, int64_t k, uint32_t* pathIds, int* pathIdx) {
+    uint32_t id = t->meta->root;
+    for (int level = 0; ; level++) {
+        Frame* f = fetch(t, id);
+        if (HDR(f->data)->type == PAGE_LEAF)
+            return f;
+        int i = childIndex(f->data, k);
+        if (pathIds) {
+            pathIds[level] = id;
+            pathIdx[level] = i;
+        }
+        id = INNER_KIDS(f->data)[i];
+        unpin(f);
+    }
+}
+
+int search(BTree* t, int64_t k, int64_t* value) {
+    Frame* leaf = findLeaf(t, k, NULL, NULL);
+    int n = HDR(leaf->data)->count;
+    int i = lowerBound(LEAF_KEYS(leaf->data), n, k);
+    int found = i < n && LEAF_KEYS(leaf->data)[i] == k;
+    if (found)
+        *value = LEAF_VALS(leaf->data)[i];
+    unpin(leaf);
+    return found;
+}
+
+// Calls visit for every key in [lo, hi) in order; returns the number visited
+long rangeScan(BTree* t, int64_t lo, int64_t hi, void (*visit)(int64_t, int64_t)) {
+    long count = 0;
+    Frame* leaf = findLeaf(t, lo, NULL, NULL);
+    int i = lowerBound(LEAF_KEYS(leaf->data), HDR(leaf->data)->count, lo);
+    while (1) {
+        int n = HDR(leaf->data)->count;
+        for (; i < n; i++) {
+            int64_t k = LEAF_KEYS(leaf->data)[i];
+            if (k >= hi) {
+                unpin(leaf);
+                return count;
+            }
+            if (visit) visit(k, LEAF_VALS(leaf->data)[i]);
+            count++;
+        }
+        uint32_t next = HDR(leaf->data)->next;
+        unpin(leaf);
+        if (next == 0)
+            return count;
+        leaf = fetch(t, next);
+        i = 0;
+    }
+}
+
+/* ---------- Insert ---------- */
+
+// Inserts separator sep with right child page right at position i of an inner page
+void innerInsert(BTree* t, uint32_t* pathIds, int* pathIdx, int level, int64_t sep, uint32_t right) {
+    while (level >= 0) {
+        Frame* f = fetch(t, pathIds[level]);
+        markDirty(t, f);
+        char* p = f->data;
+        int n = HDR(p)->count, i = pathIdx[level];
+        int64_t* keys = INNER_KEYS(p);
+        uint32_t* kids = INNER_KIDS(p);
+
+        if (n < INNER_CAP) {
+            memmove(keys + i + 1, keys + i, (n - i) * sizeof(int64_t));
+            memmove(kids + i + 2, kids + i + 1, (n - i) * sizeof(uint32_t));
+            keys[i] = sep;
+            kids[i + 1] = right;
+            HDR(p)->count++;
+            unpin(f);
+            return;
+        }
+
+        // Full: merge into temporary arrays and split around the middle key
+        int64_t tk[INNER_CAP + 1];
+        uint32_t tc[INNER_CAP + 2];
+        memcpy(tk, keys, i * sizeof(int64_t));
+        tk[i] = sep;
+        memcpy(tk + i + 1, keys + i, (n - i) * sizeof(int64_t));
+        memcpy(tc, kids, (i + 1) * sizeof(uint32_t));
+        tc[i + 1] = right;
+        memcpy(tc + i + 2, kids + i + 1, (n - i) * sizeof(uint32_t));
+
+        int total = n + 1, mid = total / 2;
+        Frame* r = allocPage(t, PAGE_INNER);
+        memcpy(keys, tk, mid * sizeof(int64_t));
+        memcpy(kids, tc, (mid + 1) * sizeof(uint32_t));
+        HDR(p)->count = (uint16_t)mid;
+        memcpy(INNER_KEYS(r->data), tk + mid + 1, (total - mid - 1) * sizeof(int64_t));
+        memcpy(INNER_KIDS(r->data), tc + mid + 1, (total - mid) * sizeof(uint32_t));
+        HDR(r->data)->count = (uint16_t)(total - mid - 1);
+
+        sep = tk[mid];            // moves up
+        right = r->pageId;
+        unpin(r);
+        unpin(f);
+        level--;
+    }
+
+    // The root split: grow the tree by one level
+    Frame* root = allocPage(t, PAGE_INNER);
+    INNER_KEYS(root->data)[0] = sep;
+    INNER_KIDS(root->data)[0] = t->meta->root;
+    INNER_KIDS(root->data)[1] = right;
+    HDR(root->data)->count = 1;
+    t->meta->root = root->pageId;
+    t->meta->height++;
+    markDirty(t, &t->frames[t->metaFrame]);
+    unpin(root);
+}
+
+// Inserts or updates k; returns 1 if the key is new
+int insert(BTree* t, int64_t k, int64_t value) {
+    uint32_t pathIds[MAX_HEIGHT];
+    int pathIdx[MAX_HEIGHT];
+    int inserted = 1;
+
+    Frame* leaf = findLeaf(t, k, pathIds, pathIdx);
+    char* p = leaf->data;
+    int n = HDR(p)->count;
+    int64_t* keys = LEAF_KEYS(p);
+    int64_t* vals = LEAF_VALS(p);
+    int i = lowerBound(keys, n, k);
+    markDirty(t, leaf);
+
+    if (i < n && keys[i] == k) {
+        vals[i] = value;
+        inserted = 0;
+    } else if (n < LEAF_CAP) {
+        memmove(keys + i + 1, keys + i, (n - i) * sizeof(int64_t));
+        memmove(vals + i + 1, vals + i, (n - i) * sizeof(int64_t));
+        keys[i] = k;
+        vals[i] = value;
+        HDR(p)->count++;
+    } else {
+        // Split the leaf: the upper half moves to a new right sibling
+        Frame* r = allocPage(t, PAGE_LEAF);
+        int mid = (n + 1) / 2;
+        int moved = n - mid;
+        memcpy(LEAF_KEYS(r->data), keys + mid, moved * sizeof(int64_t));
+        memcpy(LEAF_VALS(r->data), vals + mid, moved * sizeof(int64_t));
+        HDR(r->data)->count = (uint16_t)moved;
+        HDR(p)->count = (uint16_t)mid;
+        HDR(r->data)->next = HDR(p)->next;
+        HDR(p)->next = r->pageId;
+
+        char* target = i <= mid ? p : r->data;
+        int j = i <= mid ? i : i - mid;
+        int tn = HDR(target)->count;
+        memmove(LEAF_KEYS(target) + j + 1, LEAF_KEYS(target) + j, (tn - j) * sizeof(int64_t));
+        memmove(LEAF_VALS(target) + j + 1, LEAF_VALS(target) + j, (tn - j) * sizeof(int64_t));
+        LEAF_KEYS(target)[j] = k;
+        LEAF_VALS(target)[j] = value;
+        HDR(target)->count++;
+
+        int64_t sep = LEAF_KEYS(r->data)[0];
+        uint32_t right = r->pageId;
+        unpin(r);
+        innerInsert(t, pathIds, pathIdx, (int)t->meta->height - 2, sep, right);
+    }
+
+    if (inserted) {
+        t->meta->keys++;
+        markDirty(t, &t->frames[t->metaFrame]);
+    }
+    unpin(leaf);
+    endOp(t);
+    return inserted;
+}
+
+// Removes k from its leaf; returns 1 if it was present
+int deleteKey(BTree* t, int64_t k) {
+    Frame* leaf = findLeaf(t, k, NULL, NULL);
+    char* p = leaf->data;
+    int n = HDR(p)->count;
+    int i = lowerBound(LEAF_KEYS(p), n, k);
+    if (i == n || LEAF_KEYS(p)[i] != k) {
+        unpin(leaf);
+        return 0;
+    }
+    markDirty(t, leaf);
+    memmove(LEAF_KEYS(p) + i, LEAF_KEYS(p) + i + 1, (n - i - 1) * sizeof(int64_t));
+    memmove(LEAF_VALS(p) + i, LEAF_VALS(p) + i + 1, (n - i - 1) * sizeof(int64_t));
+    HDR(p)->count--;
+    t->meta->keys--;
+    markDirty(t, &t->frames[t->metaFrame]);
+    unpin(leaf);
+    endOp(t);
+    return 1;
+}
+
+/* ---------- Checks, benchmark and crash test ---------- */
+
+// Walks the leaf chain: keys must be strictly increasing; returns the key count or -1
+long checkLeaves(BTree* t) {
+    uint32_t id = t->meta->root;
+    for (uint32_t level = 1; level < t->meta->height; level++) {
+        Frame* f = fetch(t, id);
+        id = INNER_KIDS(f->data)[0];
+        unpin(f);
+    }
+    long count = 0;
+    int first = 1;
+    int64_t prev = 0;
+    while (id != 0) {
+        Frame* f = fetch(t, id);
+        for (int i = 0; i < HDR(f->data)->count; i++) {
+            int64_t k = LEAF_KEYS(f->data)[i];
+            if (!first && k <= prev) {
+                unpin(f);
+                return -1;
+            }
+            prev = k;
+            first = 0;
+            count++;
+        }
+        id = HDR(f->data)->next;
+        unpin(f);
+    }
+    return count;
+}
+
+double wallTime(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+uint64_t mix(uint64_t x) {
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdULL;
+    x ^= x >> 33;
+    return x;
+}
+
+void benchmark(const char* path, long n, int poolPages) {
+    char walPath[4096];
+    snprintf(walPath, sizeof(walPath), "%s.wal", path);
+    unlink(path);
+    unlink(walPath);
+
+    BTree* t = openTree(path, poolPages);
+    t->commitEvery = 10000;              // group commit, capped by the pool size
+    double s = wallTime();
+    for (long i = 0; i < n; i++)
+        insert(t, (int64_t)(mix(i) >> 1), i);
+    checkpoint(t);
+    printf("Inserted %ld keys in %.2f s (%d-byte pages, %d-page pool)\n", n, wallTime() - s, PAGE_SIZE, t->nframes);
+    printf("File: %u pages, height %u, %ld page writes, %ld fsyncs\n",
+           t->meta->pageCount, t->meta->height, t->writes, t->syncs);
+    printf("%ld commits, %.0f inserts per group (at most %d; a group may pin %d pages)\n", t->commits,
+           t->commits ? (double)n / t->commits : 0.0, t->commitEvery, t->groupLimit);
+    closeTree(t);
+
+    // Cold lookups through the small pool
+    t = openTree(path, poolPages);
+    long lookups = n < 100000 ? n : 100000, hits = 0;
+    s = wallTime();
+    for (long i = 0; i < lookups; i++) {
+        int64_t v;
+        long key = (long)(mix(i * 7919 % n) >> 1);
+        hits += search(t, key, &v) && v == i * 7919 % n;
+    }
+    printf("%ld lookups (%ld correct): %.2f us each, %.2f page reads per lookup\n",
+           lookups, hits, (wallTime() - s) / lookups * 1e6, (double)t->reads / lookups);
+
+    long before = t->reads;
+    s = wallTime();
+    long scanned = rangeScan(t, 0, INT64_MAX / 64, NULL);
+    printf("Range scan of %ld keys: %.3f s, %ld page reads\n", scanned, wallTime() - s, t->reads - before);
+    printf("Leaf chain check: %s\n", checkLeaves(t) == (long)t->meta->keys ? "ok" : "FAILED");
+    closeTree(t);
+}
+
+// A child inserts keys and reports each commit through a pipe. The parent
+// kills it at a random moment, reopens the file and checks the committed keys.
+int crashTest(const char* path) {
+    char walPath[4096];
+    snprintf(walPath, sizeof(walPath), "%s.wal", path);
+    unlink(path);
+    unlink(walPath);
+
+    int fds[2];
+    if (pipe(fds) != 0)
+        die("pipe");
+    pid_t pid = fork();
+    if (pid == 0) {
+        close(fds[0]);
+        BTree* t = openTree(path, MIN_POOL);    // small pool: forces evictions
+        t->commitEvery = 1 << 30;
+        for (long i = 0; ; i++) {
+            insert(t, (int64_t)(mix(i) >> 1), i);
+            if (i % 64 == 63) {
+                commit(t);
+                long done = i + 1;
+                if (write(fds[1], &done, sizeof(done)) != sizeof(done))
+                    _exit(1);
+            }
+        }
+    }
+    close(fds[1]);
+
+    srand((unsigned)time(NULL));
+    usleep(200000 + rand() % 800000);
+    kill(pid, SIGKILL);
+    waitpid(pid, NULL, 0);
+
+    long committed = 0, v;
+    while (read(fds[0], &v, sizeof(v)) == sizeof(v))
+        committed = v;
+    close(fds[0]);
+
+    BTree* t = openTree(path, 256);
+    long missing = 0;
+    for (long i = 0; i < committed; i++) {
+        int64_t value;
+        if (!search(t, (int64_t)(mix(i) >> 1), &value) || value != i)
+            missing++;
+    }
+    long leaves = checkLeaves(t);
+    printf("Writer killed after %ld committed inserts; file holds %llu keys\n",
+           committed, (unsigned long long)t->meta->keys);
+    printf("Committed keys missing after recovery: %ld\n", missing);
+    int consistent = leaves == (long)t->meta->keys;
+    printf("Leaf chain: %s\n", consistent ? "consistent" : "INCONSISTENT");
+    closeTree(t);
+    return missing == 0 && consistent;
+}
+
+void printEntry(int64_t k, int64_t v) {
+    printf("%lld:%lld ", (long long)k, (long long)v);
+}
+
+int main(int argc, char** argv) {
+    if (argc > 3 && strcmp(argv[1], "--bench") == 0) {
+        benchmark(argv[2], atol(argv[3]), argc > 4 ? atoi(argv[4]) : POOL_PAGES);
+        return 0;
+    }
+    if (argc > 2 && strcmp(argv[1], "--crash-test") == 0)
+        return crashTest(argv[2]) ? 0 : 1;
+
+    BTree* t = openTree(argc > 1 ? argv[1] : "bptree.db", POOL_PAGES);
+    int choice;
+    long long k, v, hi;
+
+    while (1) {
+        printf("\n--- Disk B+ Tree Menu ---\n");
+        printf("1. Insert\n2. Delete\n3. Search\n4. Range Scan\n5. Traverse\n6. Exit\n");
+        printf("Enter your choice: ");
+        if (scanf("%d", &choice) != 1)
+            break;
+
+        switch (choice) {
+            case 1:
+                printf("Enter key and value: ");
+                scanf("%lld %lld", &k, &v);
+                insert(t, k, v);
+                break;
+            case 2:
+                printf("Enter key to delete: ");
+                scanf("%lld", &k);
+                if (!deleteKey(t, k))
+                    printf("Key %lld not found\n", k);
+                break;
+            case 3: {
+                int64_t value;
+                printf("Enter key to search: ");
+                scanf("%lld", &k);
+                if (search(t, k, &value))
+                    printf("Found %lld -> %lld\n", k, (long long)value);
+                else
+                    printf("Key %lld not found\n", k);
+                break;
+            }
+            case 4:
+                printf("Enter range [lo, hi): ");
+                scanf("%lld %lld", &k, &hi);
+                printf("\n%ld keys\n", rangeScan(t, k, hi, printEntry));
+                break;
+            case 5:
+                rangeScan(t, INT64_MIN, INT64_MAX, printEntry);
+                printf("\n%llu keys, height %u, %u pages\n", (unsigned long long)t->meta->keys,
+                       t->meta->height, t->meta->pageCount);
+                break;
+            case 6:
+                closeTree(t);
+                exit(0);
+            default:
+                printf("Invalid choice!\n");
+        }
+    }
+    closeTree(t);
+    return 0;
+}
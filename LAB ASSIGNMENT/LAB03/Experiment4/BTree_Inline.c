@@ -0,0 +1,431 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <limits.h>
+#include <time.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define BT_X86 1
+#define BT_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define BT_X86 0
+#define BT_TARGET_AVX2
+#endif
+
+/*
+   In-memory B+-tree of int keys with inline, cache-line-aligned nodes.
+
+   B_tree.c keeps keys and children in separately allocated arrays, so every
+   node visit follows node->keys and node->C to other cache lines, and
+   findKey scans keys one at a time. Here:
+
+   - A node holds its keys and child pointers inline and is aligned to (and
+     padded to a multiple of) 64 bytes.
+   - The number of keys per node is a compile-time parameter:
+     DEFINE_INLINE_BTREE(NAME, KEYS) generates a tree type and its functions
+     for KEYS keys per node (a multiple of 8), in the same way
+     DK_DEFINE_BLOCKED works in common/dense_kernels.h. BTREE_KEYS selects
+     the tree used by the menu.
+   - Unused key slots hold INT_MAX, so the rank of a key in a node (the
+     number of keys below it) is found by comparing the whole node with
+     SIMD and counting the mask bits, with no branches. AVX2 compares 8 keys
+     at a time and SSE2 compares 4. AVX2 is used only if the CPU has it.
+   - All keys are in the leaves, and leaves are linked for traversal. Nodes
+     come from a bump arena that is freed all at once.
+   - Deletes remove the key from its leaf without merging nodes.
+
+   Keys must be smaller than INT_MAX (the padding value).
+
+   Usage:
+     BTree_Inline            interactive menu
+     BTree_Inline --bench N  insert and look up N random keys for several node sizes
+*/
+
+#ifndef BTREE_KEYS
+#define BTREE_KEYS 32
+#endif
+
+#define MAX_LEVELS 24
+
+/* ---------- Node search ---------- */
+
+static inline int bt_has_avx2(void) {
+#if BT_X86
+    static int cached = -1;
+    if (cached < 0) {
+        __builtin_cpu_init();
+        cached = __builtin_cpu_supports("avx2") != 0;
+    }
+    return cached;
+#else
+    return 0;
+#endif
+}
+
+// Number of keys smaller than k among nkeys sorted, INT_MAX-padded slots
+static inline int bt_rank_sse2(const int32_t* keys, int nkeys, int32_t k) {
+    int r = 0;
+#if BT_X86
+    __m128i kv = _mm_set1_epi32(k);
+    for (int i = 0; i < nkeys; i += 4) {
+        __m128i v = _mm_load_si128((const __m128i*)(keys + i));
+        r += __builtin_popcount(_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpgt_epi32(kv, v))));
+    }
+#else
+    for (int i = 0; i < nkeys; i++)
+        r += keys[i] < k;
+#endif
+    return r;
+}
+
+BT_TARGET_AVX2
+static inline int bt_rank_avx2(const int32_t* keys, int nkeys, int32_t k) {
+#if BT_X86
+    int r = 0;
+    __m256i kv = _mm256_set1_epi32(k);
+    for (int i = 0; i < nkeys; i += 8) {
+        __m256i v = _mm256_load_si256((const __m256i*)(keys + i));
+        r += __builtin_popcount(_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(kv, v))));
+    }
+    return r;
+#else
+    return bt_rank_sse2(keys, nkeys, k);
+#endif
+}
+
+/* ---------- Node arena ---------- */
+
+#define ARENA_CHUNK (1 << 20)
+
+typedef struct {
+    char* chunk;         // current chunk; its first 64 bytes link to the previous one
+    size_t used;
+    size_t bytes;        // total reserved
+} Arena;
+
+static inline void* arenaAlloc(Arena* a, size_t size) {
+    if (a->chunk == NULL || a->used + size > ARENA_CHUNK) {
+        char* c = (char*)aligned_alloc(64, ARENA_CHUNK);
+        *(char**)c = a->chunk;
+        a->chunk = c;
+        a->used = 64;
+        a->bytes += ARENA_CHUNK;
+    }
+    void* p = a->chunk + a->used;
+    a->used += size;
+    return p;
+}
+
+static inline void arenaFree(Arena* a) {
+    while (a->chunk) {
+        char* prev = *(char**)a->chunk;
+        free(a->chunk);
+        a->chunk = prev;
+    }
+    a->used = a->bytes = 0;
+}
+
+/* ---------- Tree template ---------- */
+
+// Body of the lookup, instantiated once per rank function
+#define BT_FIND_BODY(NAME, KEYS, RANK)                                           \
+    void* node = t->root;                                                        \
+    for (int level = 1; level < t->height; level++) {                            \
+        NAME##Inner* in = (NAME##Inner*)node;                                    \
+        node = in->child[RANK(in->keys, KEYS, k + 1)];                           \
+    }                                                                            \
+    NAME##Leaf* leaf = (NAME##Leaf*)node;                                        \
+    int i = RANK(leaf->keys, KEYS, k);                                           \
+    return i < leaf->n && leaf->keys[i] == k;
+
+// Body of the insert: descends with a path stack, then splits bottom-up
+#define BT_INSERT_BODY(NAME, KEYS, RANK)                                         \
+    NAME##Inner* path[MAX_LEVELS];                                               \
+    int slot[MAX_LEVELS];                                                        \
+    void* node = t->root;                                                        \
+    for (int level = 0; level < t->height - 1; level++) {                        \
+        NAME##Inner* in = (NAME##Inner*)node;                                    \
+        path[level] = in;                                                        \
+        slot[level] = RANK(in->keys, KEYS, k + 1);                               \
+        node = in->child[slot[level]];                                           \
+    }                                                                            \
+    NAME##Leaf* leaf = (NAME##Leaf*)node;                                        \
+    int i = RANK(leaf->keys, KEYS, k);                                           \
+    if (i < leaf->n && leaf->keys[i] == k)                                       \
+        return 0;                                                                \
+    t->count++;                                                                  \
+    if (leaf->n < KEYS) {                                                        \
+        memmove(leaf->keys + i + 1, leaf->keys + i, (leaf->n - i) * 4);          \
+        leaf->keys[i] = k;                                                       \
+        leaf->n++;                                                               \
+        return 1;                                                                \
+    }                                                                            \
+    /* split the leaf: the upper half moves to a new right sibling */            \
+    NAME##Leaf* right = NAME##_newLeaf(t);                                       \
+    int half = KEYS / 2;                                                         \
+    memcpy(right->keys, leaf->keys + half, (KEYS - half) * 4);                   \
+    for (int j = half; j < KEYS; j++) leaf->keys[j] = INT_MAX;                   \
+    leaf->n = half;                                                              \
+    right->n = KEYS - half;                                                      \
+    right->next = leaf->next;                                                    \
+    leaf->next = right;                                                          \
+    NAME##Leaf* target = i <= half ? leaf : right;                               \
+    int j = i <= half ? i : i - half;                                            \
+    memmove(target->keys + j + 1, target->keys + j, (target->n - j) * 4);        \
+    target->keys[j] = k;                                                         \
+    target->n++;                                                                 \
+    int32_t sep = right->keys[0];                                                \
+    void* newChild = right;                                                      \
+    for (int level = t->height - 2; level >= 0; level--) {                       \
+        NAME##Inner* in = path[level];                                           \
+        int s = slot[level];                                                     \
+        if (in->n < KEYS) {                                                      \
+            memmove(in->keys + s + 1, in->keys + s, (in->n - s) * 4);            \
+            memmove(in->child + s + 2, in->child + s + 1,                        \
+                    (in->n - s) * sizeof(void*));                                \
+            in->keys[s] = sep;                                                   \
+            in->child[s + 1] = newChild;                                         \
+            in->n++;                                                             \
+            return 1;                                                            \
+        }                                                                        \
+        /* full inner node: split around the middle key, which moves up */     \
+        int32_t tk[KEYS + 1];                                                    \
+        void* tc[KEYS + 2];                                                      \
+        memcpy(tk, in->keys, s * 4);                                             \
+        tk[s] = sep;                                                             \
+        memcpy(tk + s + 1, in->keys + s, (KEYS - s) * 4);                        \
+        memcpy(tc, in->child, (s + 1) * sizeof(void*));                          \
+        tc[s + 1] = newChild;                                                    \
+        memcpy(tc + s + 2, in->child + s + 1, (KEYS - s) * sizeof(void*));        \
+        int mid = (KEYS + 1) / 2;                                                \
+        NAME##Inner* r = NAME##_newInner(t);                                     \
+        memcpy(in->keys, tk, mid * 4);                                           \
+        for (int q = mid; q < KEYS; q++) in->keys[q] = INT_MAX;                  \
+        memcpy(in->child, tc, (mid + 1) * sizeof(void*));                        \
+        in->n = mid;                                                             \
+        r->n = KEYS - mid;                                                       \
+        memcpy(r->keys, tk + mid + 1, r->n * 4);                                 \
+        memcpy(r->child, tc + mid + 1, (r->n + 1) * sizeof(void*));              \
+        sep = tk[mid];                                                           \
+        newChild = r;                                                            \
+    }                                                                            \
+    /* the root split: the tree grows by one level */                          \
+    NAME##Inner* root = NAME##_newInner(t);                                      \
+    root->keys[0] = sep;                                                         \
+    root->child[0] = t->root;                                                    \
+    root->child[1] = newChild;                                                   \
+    root->n = 1;                                                                 \
+    t->root = root;                                                              \
+    t->height++;                                                                 \
+    return 1;
+
+#define DEFINE_INLINE_BTREE(NAME, KEYS)                                          \
+_Static_assert((KEYS) % 8 == 0 && (KEYS) >= 8, "KEYS must be a multiple of 8");  \
+typedef struct NAME##Leaf {                                                      \
+    _Alignas(64) int32_t keys[KEYS];                                             \
+    int32_t n;                                                                   \
+    struct NAME##Leaf* next;                                                     \
+} NAME##Leaf;                                                                    \
+typedef struct {                                                                 \
+    _Alignas(64) int32_t keys[KEYS];                                             \
+    int32_t n;                                                                   \
+    void* child[KEYS + 1];                                                       \
+} NAME##Inner;                                                                   \
+typedef struct {                                                                 \
+    void* root;                                                                  \
+    int height;          /* 1 = the root is a leaf */                            \
+    long count;                                                                  \
+    Arena arena;                                                                 \
+} NAME;                                                                          \
+static inline NAME##Leaf* NAME##_newLeaf(NAME* t) {                              \
+    NAME##Leaf* l = (NAME##Leaf*)arenaAlloc(&t->arena, sizeof(NAME##Leaf));      \
+    for (int i = 0; i < KEYS; i++) l->keys[i] = INT_MAX;                         \
+    l->n = 0;                                                                    \
+    l->next = NULL;                                                              \
+    return l;                                                                    \
+}                                                                                \
+static inline NAME##Inner* NAME##_newInner(NAME* t) {                            \
+    NAME##Inner* in = (NAME##Inner*)arenaAlloc(&t->arena, sizeof(NAME##Inner));  \
+    for (int i = 0; i < KEYS; i++) in->keys[i] = INT_MAX;                        \
+    in->n = 0;                                                                   \
+    return in;                                                                   \
+}                                                                                \
+static inline void NAME##_init(NAME* t) {                                        \
+    memset(t, 0, sizeof(*t));                                                    \
+    t->root = NAME##_newLeaf(t);                                                 \
+    t->height = 1;                                                               \
+}                                                                                \
+static inline void NAME##_destroy(NAME* t) {                                     \
+    arenaFree(&t->arena);                                                        \
+    t->root = NULL;                                                              \
+}                                                                                \
+static inline int NAME##_contains_sse2(const NAME* t, int32_t k) {               \
+    BT_FIND_BODY(NAME, KEYS, bt_rank_sse2)                                       \
+}                                                                                \
+BT_TARGET_AVX2                                                                   \
+static inline int NAME##_contains_avx2(const NAME* t, int32_t k) {               \
+    BT_FIND_BODY(NAME, KEYS, bt_rank_avx2)                                       \
+}                                                                                \
+/* 1 if k is in the tree */                                                      \
+static inline int NAME##_contains(const NAME* t, int32_t k) {                    \
+    if (k == INT_MAX) return 0;                                                  \
+    return bt_has_avx2() ? NAME##_contains_avx2(t, k) : NAME##_contains_sse2(t, k); \
+}                                                                                \
+static inline int NAME##_insert_sse2(NAME* t, int32_t k) {                       \
+    BT_INSERT_BODY(NAME, KEYS, bt_rank_sse2)                                     \
+}                                                                                \
+BT_TARGET_AVX2                                                                   \
+static inline int NAME##_insert_avx2(NAME* t, int32_t k) {                       \
+    BT_INSERT_BODY(NAME, KEYS, bt_rank_avx2)                                     \
+}                                                                                \
+/* Inserts k (< INT_MAX); returns 1 if it was not present */                     \
+static inline int NAME##_insert(NAME* t, int32_t k) {                            \
+    if (k == INT_MAX) return 0;                                                  \
+    return bt_has_avx2() ? NAME##_insert_avx2(t, k) : NAME##_insert_sse2(t, k);   \
+}                                                                                \
+/* Removes k from its leaf; returns 1 if it was present */                       \
+static inline int NAME##_delete(NAME* t, int32_t k) {                            \
+    if (k == INT_MAX) return 0;                                                  \
+    void* node = t->root;                                                        \
+    for (int level = 1; level < t->height; level++) {                            \
+        NAME##Inner* in = (NAME##Inner*)node;                                    \
+        node = in->child[bt_rank_sse2(in->keys, KEYS, k + 1)];                   \
+    }                                                                            \
+    NAME##Leaf* leaf = (NAME##Leaf*)node;                                        \
+    int i = bt_rank_sse2(leaf->keys, KEYS, k);                                   \
+    if (i == leaf->n || leaf->keys[i] != k)                                      \
+        return 0;                                                                \
+    memmove(leaf->keys + i, leaf->keys + i + 1, (KEYS - i - 1) * 4);             \
+    leaf->keys[KEYS - 1] = INT_MAX;                                              \
+    leaf->n--;                                                                   \
+    t->count--;                                                                  \
+    return 1;                                                                    \
+}                                                                                \
+static inline NAME##Leaf* NAME##_firstLeaf(const NAME* t) {                      \
+    void* node = t->root;                                                        \
+    for (int level = 1; level < t->height; level++)                              \
+        node = ((NAME##Inner*)node)->child[0];                                   \
+    return (NAME##Leaf*)node;                                                    \
+}                                                                                \
+/* Returns the number of keys if they are sorted along the leaf chain, else -1 */ \
+static inline long NAME##_check(const NAME* t) {                                 \
+    long count = 0;                                                              \
+    int64_t prev = INT64_MIN;                                                    \
+    for (NAME##Leaf* l = NAME##_firstLeaf(t); l; l = l->next)                    \
+        for (int i = 0; i < l->n; i++) {                                         \
+            if (l->keys[i] <= prev) return -1;                                   \
+            prev = l->keys[i];                                                   \
+            count++;                                                             \
+        }                                                                        \
+    return count;                                                                \
+}
+
+DEFINE_INLINE_BTREE(BTree, BTREE_KEYS)
+DEFINE_INLINE_BTREE(BTree16, 16)
+DEFINE_INLINE_BTREE(BTree64, 64)
+
+/* ---------- Benchmark ---------- */
+
+double wallTime(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// Random inserts, then lookups of present keys and of random (mostly absent) keys
+#define BENCH_TREE(NAME, KEYS, keys, probes, n)                                  \
+    do {                                                                         \
+        NAME t;                                                                  \
+        NAME##_init(&t);                                                         \
+        double s = wallTime();                                                   \
+        for (int i = 0; i < n; i++) NAME##_insert(&t, keys[i]);                  \
+        double ins = wallTime() - s;                                             \
+        long hits = 0;                                                           \
+        s = wallTime();                                                          \
+        for (int i = 0; i < n; i++) hits += NAME##_contains(&t, keys[n - 1 - i]); \
+        double hit = wallTime() - s;                                             \
+        s = wallTime();                                                          \
+        for (int i = 0; i < n; i++) hits += NAME##_contains(&t, probes[i]);      \
+        double miss = wallTime() - s;                                            \
+        printf("%4d keys/node (%3zu-byte leaf, %4zu-byte inner): insert %6.1f ns, " \
+               "hit %6.1f ns, random %6.1f ns, %.1f bytes/key, height %d, %s\n", \
+               KEYS, sizeof(NAME##Leaf), sizeof(NAME##Inner), ins / n * 1e9,     \
+               hit / n * 1e9, miss / n * 1e9, (double)t.arena.bytes / t.count,  \
+               t.height, NAME##_check(&t) == t.count && hits >= t.count ? "ok" : "FAILED"); \
+        NAME##_destroy(&t);                                                      \
+    } while (0)
+
+void benchmark(int n) {
+    int32_t* keys = (int32_t*)malloc(n * sizeof(int32_t));
+    int32_t* probes = (int32_t*)malloc(n * sizeof(int32_t));
+    uint64_t x = 88172645463325252ULL;
+    for (int i = 0; i < n; i++) {
+        x ^= x << 13; x ^= x >> 7; x ^= x << 17;
+        keys[i] = (int32_t)(x >> 33);
+        x ^= x << 13; x ^= x >> 7; x ^= x << 17;
+        probes[i] = (int32_t)(x >> 33);
+    }
+    printf("%d random keys, %s node search\n", n, bt_has_avx2() ? "AVX2" : "SSE2");
+    BENCH_TREE(BTree16, 16, keys, probes, n);
+    BENCH_TREE(BTree, BTREE_KEYS, keys, probes, n);
+    BENCH_TREE(BTree64, 64, keys, probes, n);
+    free(keys);
+    free(probes);
+}
+
+// Driver program with user input
+int main(int argc, char** argv) {
+    if (argc > 2 && strcmp(argv[1], "--bench") == 0) {
+        benchmark(atoi(argv[2]));
+        return 0;
+    }
+
+    BTree tree;
+    BTree_init(&tree);
+    int choice, key;
+
+    while (1) {
+        printf("\n--- Inline B+ Tree Menu (%d keys per node) ---\n", BTREE_KEYS);
+        printf("1. Insert\n2. Delete\n3. Search\n4. Traverse\n5. Exit\n");
+        printf("Enter your choice: ");
+        if (scanf("%d", &choice) != 1)
+            break;
+
+        switch (choice) {
+            case 1:
+                printf("Enter key to insert: ");
+                scanf("%d", &key);
+                if (key == INT_MAX)
+                    printf("Key %d is reserved\n", key);
+                else if (!BTree_insert(&tree, key))
+                    printf("Key %d already present\n", key);
+                break;
+            case 2:
+                printf("Enter key to delete: ");
+                scanf("%d", &key);
+                if (!BTree_delete(&tree, key))
+                    printf("Key %d not found\n", key);
+                break;
+            case 3:
+                printf("Enter key to search: ");
+                scanf("%d", &key);
+                printf(BTree_contains(&tree, key) ? "Key %d found\n" : "Key %d not found\n", key);
+                break;
+            case 4:
+                for (BTreeLeaf* l = BTree_firstLeaf(&tree); l; l = l->next)
+                    for (int i = 0; i < l->n; i++)
+                        printf("%d ", l->keys[i]);
+                printf("\n%ld keys, height %d\n", tree.count, tree.height);
+                break;
+            case 5:
+                BTree_destroy(&tree);
+                exit(0);
+            default:
+                printf("Invalid choice!\n");
+        }
+    }
+    BTree_destroy(&tree);
+    return 0;
+}
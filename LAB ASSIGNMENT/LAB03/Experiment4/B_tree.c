@@ -1,5 +1,7 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <time.h>
 
 #define MIN_DEGREE 3  // Minimum degree (t). Change as needed.
 
@@ -28,6 +30,17 @@ void fill(struct BTreeNode *root, int idx);
 void borrowFromPrev(struct BTreeNode *root, int idx);
 void borrowFromNext(struct BTreeNode *root, int idx);
 void merge(struct BTreeNode *root, int idx);
+void freeNode(struct BTreeNode *node);
+void freeTree(struct BTreeNode *root);
+struct BTreeNode *shrinkRoot(struct BTreeNode *root);
+int sortUnique(int *keys, int n);
+struct BTreeNode *bulkLoad(int *keys, int n, double fill);
+int height(struct BTreeNode *root);
+void rebalancePair(struct BTreeNode *x, int i);
+struct BTreeNode *join(struct BTreeNode *left, int k, struct BTreeNode *right);
+struct BTreeNode *join2(struct BTreeNode *left, struct BTreeNode *right);
+struct BTreeNode *deleteRun(struct BTreeNode *x, int *keys, int n);
+void deleteBatch(struct BTreeNode **root, int *keys, int n);
 
 // Create a new B-Tree node
 struct BTreeNode *createNode(int t, int leaf) {
@@ -289,17 +302,422 @@ void merge(struct BTreeNode *root, int idx) {
     child->n += sibling->n + 1;
     root->n--;
 
-    free(sibling);
+    freeNode(sibling);
+}
+
+void freeNode(struct BTreeNode *node) {
+    free(node->keys);
+    free(node->C);
+    free(node);
+}
+
+void freeTree(struct BTreeNode *root) {
+    if (root == NULL) return;
+    if (!root->leaf)
+        for (int i = 0; i <= root->n; i++)
+            freeTree(root->C[i]);
+    freeNode(root);
+}
+
+// A root left with no keys is replaced by its only child (or removed)
+struct BTreeNode *shrinkRoot(struct BTreeNode *root) {
+    while (root != NULL && root->n == 0) {
+        struct BTreeNode *child = root->leaf ? NULL : root->C[0];
+        freeNode(root);
+        root = child;
+    }
+    return root;
+}
+
+/* ---------- Bulk loading ---------- */
+
+int compareInts(const void *a, const void *b) {
+    int x = *(const int *)a, y = *(const int *)b;
+    return (x > y) - (x < y);
+}
+
+// Sorts keys and drops duplicates; returns the new count
+int sortUnique(int *keys, int n) {
+    qsort(keys, n, sizeof(int), compareInts);
+    int m = 0;
+    for (int i = 0; i < n; i++)
+        if (m == 0 || keys[i] != keys[m - 1])
+            keys[m++] = keys[i];
+    return m;
+}
+
+// Builds a tree bottom-up from n sorted, distinct keys. Nodes get at most
+// floor(fill * (2t - 1)) keys, but never fewer than t - 1; a level only goes
+// over the target when spreading its keys over fewer nodes is needed to keep
+// them t - 1 full. Each level is cut into nodes with one key between
+// neighbours, and those keys form the level above.
+struct BTreeNode *bulkLoad(int *keys, int n, double fill) {
+    int t = MIN_DEGREE;
+    if (n <= 0) return NULL;
+    // round down so fill is an upper bound; the epsilon keeps a product that
+    // should be whole (e.g. 0.6 * 5) from truncating to one less
+    int f = (int)(fill * (2 * t - 1) + 1e-9);
+    if (f < t - 1) f = t - 1;
+    if (f > 2 * t - 1) f = 2 * t - 1;
+    if (f < 1) f = 1;
+
+    int *levelKeys = (int *)malloc(n * sizeof(int));
+    memcpy(levelKeys, keys, n * sizeof(int));
+    struct BTreeNode **levelKids = NULL;
+    int m = n, leaf = 1;
+
+    while (1) {
+        // fewest nodes of at most f keys; one fewer if that would leave them underfull
+        int count = (m + 1 + f) / (f + 1);
+        if (count > 1 && m + 1 < t * count)
+            count--;
+        int inNodes = m - (count - 1);
+        struct BTreeNode **nodes = (struct BTreeNode **)malloc(count * sizeof(struct BTreeNode *));
+        int *upKeys = (int *)malloc((count > 1 ? count - 1 : 1) * sizeof(int));
+        int pos = 0, kid = 0;
+
+        for (int j = 0; j < count; j++) {
+            int c = inNodes / count + (j < inNodes % count);
+            struct BTreeNode *node = createNode(t, leaf);
+            memcpy(node->keys, levelKeys + pos, c * sizeof(int));
+            if (!leaf) {
+                memcpy(node->C, levelKids + kid, (c + 1) * sizeof(struct BTreeNode *));
+                kid += c + 1;
+            }
+            node->n = c;
+            pos += c;
+            nodes[j] = node;
+            if (j < count - 1)
+                upKeys[j] = levelKeys[pos++];
+        }
+
+        free(levelKeys);
+        free(levelKids);
+        if (count == 1) {
+            struct BTreeNode *root = nodes[0];
+            free(nodes);
+            free(upKeys);
+            return root;
+        }
+        levelKeys = upKeys;
+        levelKids = nodes;
+        m = count - 1;
+        leaf = 0;
+    }
+}
+
+/* ---------- Join and batch deletion ---------- */
+
+int height(struct BTreeNode *root) {
+    int h = 0;
+    for (; root != NULL; root = root->leaf ? NULL : root->C[0])
+        h++;
+    return h;
+}
+
+// Evens out children i and i + 1 of x, or merges them if they fit in one node
+void rebalancePair(struct BTreeNode *x, int i) {
+    struct BTreeNode *a = x->C[i], *b = x->C[i + 1];
+    int t = a->t, total = a->n + 1 + b->n;
+    if (total <= 2 * t - 1) {
+        merge(x, i);
+        return;
+    }
+
+    int keys[4 * MIN_DEGREE];
+    struct BTreeNode *kids[4 * MIN_DEGREE + 1];
+    memcpy(keys, a->keys, a->n * sizeof(int));
+    keys[a->n] = x->keys[i];
+    memcpy(keys + a->n + 1, b->keys, b->n * sizeof(int));
+    if (!a->leaf) {
+        memcpy(kids, a->C, (a->n + 1) * sizeof(struct BTreeNode *));
+        memcpy(kids + a->n + 1, b->C, (b->n + 1) * sizeof(struct BTreeNode *));
+    }
+
+    int left = (total - 1) / 2;
+    a->n = left;
+    b->n = total - left - 1;
+    memcpy(a->keys, keys, a->n * sizeof(int));
+    x->keys[i] = keys[left];
+    memcpy(b->keys, keys + left + 1, b->n * sizeof(int));
+    if (!a->leaf) {
+        memcpy(a->C, kids, (a->n + 1) * sizeof(struct BTreeNode *));
+        memcpy(b->C, kids + left + 1, (b->n + 1) * sizeof(struct BTreeNode *));
+    }
+}
+
+// Joins two trees with every key of left < k < every key of right.
+// The shorter tree is hung off the spine of the taller one at its height.
+struct BTreeNode *join(struct BTreeNode *left, int k, struct BTreeNode *right) {
+    int t = MIN_DEGREE;
+    if (left == NULL || right == NULL) {
+        struct BTreeNode *root = left ? left : right;
+        insert(&root, k);
+        return root;
+    }
+
+    int hl = height(left), hr = height(right);
+    if (hl == hr) {
+        if (left->n + 1 + right->n <= 2 * t - 1) {
+            struct BTreeNode *root = createNode(t, 0);
+            root->keys[0] = k;
+            root->C[0] = left;
+            root->C[1] = right;
+            root->n = 1;
+            merge(root, 0);
+            freeNode(root);
+            return left;
+        }
+        struct BTreeNode *root = createNode(t, 0);
+        root->keys[0] = k;
+        root->C[0] = left;
+        root->C[1] = right;
+        root->n = 1;
+        if (left->n < t - 1 || right->n < t - 1)
+            rebalancePair(root, 0);
+        return root;
+    }
+
+    int tallerIsLeft = hl > hr;
+    struct BTreeNode *root = tallerIsLeft ? left : right;
+    int h = tallerIsLeft ? hl : hr, target = (tallerIsLeft ? hr : hl) + 1;
+
+    // split full nodes on the way down so the target node has room
+    if (root->n == 2 * t - 1) {
+        struct BTreeNode *s = createNode(t, 0);
+        s->C[0] = root;
+        splitChild(s, 0, root);
+        root = s;
+        h++;
+    }
+    struct BTreeNode *x = root;
+    while (h > target) {
+        int i = tallerIsLeft ? x->n : 0;
+        if (x->C[i]->n == 2 * t - 1) {
+            splitChild(x, i, x->C[i]);
+            i = tallerIsLeft ? x->n : 0;
+        }
+        x = x->C[i];
+        h--;
+    }
+
+    if (tallerIsLeft) {
+        x->keys[x->n] = k;
+        x->C[x->n + 1] = right;
+        x->n++;
+        if (right->n < t - 1)
+            rebalancePair(x, x->n - 1);
+    } else {
+        memmove(x->keys + 1, x->keys, x->n * sizeof(int));
+        memmove(x->C + 1, x->C, (x->n + 1) * sizeof(struct BTreeNode *));
+        x->keys[0] = k;
+        x->C[0] = left;
+        x->n++;
+        if (left->n < t - 1)
+            rebalancePair(x, 0);
+    }
+    return root;
+}
+
+// Joins two trees with no key between them: the largest key of left moves up
+struct BTreeNode *join2(struct BTreeNode *left, struct BTreeNode *right) {
+    if (left == NULL) return right;
+    if (right == NULL) return left;
+    struct BTreeNode *cur = left;
+    while (!cur->leaf)
+        cur = cur->C[cur->n];
+    int k = cur->keys[cur->n - 1];
+    deleteKey(left, k);
+    return join(shrinkRoot(left), k, right);
+}
+
+// Deletes the sorted, distinct keys[0..n) from the subtree at x and returns
+// the new subtree root (NULL if empty). The result may be shorter than x
+// and its root may hold fewer than t - 1 keys; every node below the root
+// is valid. Each affected node is repaired once, after its children.
+struct BTreeNode *deleteRun(struct BTreeNode *x, int *keys, int n) {
+    int t = x->t;
+
+    if (x->leaf) {
+        int m = 0, j = 0;
+        for (int i = 0; i < x->n; i++) {
+            while (j < n && keys[j] < x->keys[i]) j++;
+            if (j == n || keys[j] != x->keys[i])
+                x->keys[m++] = x->keys[i];
+        }
+        x->n = m;
+        if (m == 0) {
+            freeNode(x);
+            return NULL;
+        }
+        return x;
+    }
+
+    // Split the run among the children and mark separators that are deleted
+    int childHeight = height(x->C[0]);
+    int dead[2 * MIN_DEGREE], anyDead = 0, intact = 1, j = 0;
+    for (int i = 0; i <= x->n; i++) {
+        int start = j;
+        while (j < n && (i == x->n || keys[j] < x->keys[i])) j++;
+        if (j > start) {
+            x->C[i] = deleteRun(x->C[i], keys + start, j - start);
+            if (x->C[i] == NULL || height(x->C[i]) != childHeight)
+                intact = 0;
+        }
+        if (i < x->n) {
+            dead[i] = j < n && keys[j] == x->keys[i];
+            if (dead[i]) {
+                j++;
+                anyDead = 1;
+            }
+        }
+    }
+
+    if (intact && !anyDead) {
+        // Only fill levels changed: even out underfull children with a neighbour
+        for (int i = 0; i <= x->n && x->n > 0;) {
+            if (x->C[i]->n >= t - 1) {
+                i++;
+                continue;
+            }
+            int pair = i < x->n ? i : i - 1, before = x->n;
+            rebalancePair(x, pair);
+            i = x->n == before ? i + 1 : pair;
+        }
+        return shrinkRoot(x);
+    }
+
+    // Subtrees shrank or vanished, or separators went away: rebuild this
+    // node from its pieces, joining them left to right
+    struct BTreeNode *acc = x->C[0];
+    for (int i = 0; i < x->n; i++)
+        acc = dead[i] ? join2(acc, x->C[i + 1]) : join(acc, x->keys[i], x->C[i + 1]);
+    freeNode(x);
+    return acc;
+}
+
+// Deletes a batch of keys (any order, duplicates allowed)
+void deleteBatch(struct BTreeNode **root, int *keys, int n) {
+    if (*root == NULL || n <= 0) return;
+    int *sorted = (int *)malloc(n * sizeof(int));
+    memcpy(sorted, keys, n * sizeof(int));
+    n = sortUnique(sorted, n);
+    *root = shrinkRoot(deleteRun(*root, sorted, n));
+    free(sorted);
+}
+
+/* ---------- Checks and benchmark ---------- */
+
+// Returns the number of keys if the subtree is a valid B-tree (keys in
+// (lo, hi), node sizes within bounds, leaves at one depth), else -1
+long checkBTree(struct BTreeNode *x, long lo, long hi, int isRoot, int depth, int *leafDepth) {
+    if (x == NULL) return 0;
+    int t = x->t;
+    if (x->n > 2 * t - 1 || (isRoot ? x->n < 1 : x->n < t - 1))
+        return -1;
+    for (int i = 0; i < x->n; i++)
+        if (x->keys[i] <= (i ? x->keys[i - 1] : lo) || x->keys[i] >= hi)
+            return -1;
+    if (x->leaf) {
+        if (*leafDepth < 0) *leafDepth = depth;
+        return *leafDepth == depth ? x->n : -1;
+    }
+    long total = x->n;
+    for (int i = 0; i <= x->n; i++) {
+        long c = checkBTree(x->C[i], i ? x->keys[i - 1] : lo, i < x->n ? x->keys[i] : hi, 0, depth + 1, leafDepth);
+        if (c < 0) return -1;
+        total += c;
+    }
+    return total;
+}
+
+long countNodes(struct BTreeNode *x) {
+    if (x == NULL) return 0;
+    long c = 1;
+    if (!x->leaf)
+        for (int i = 0; i <= x->n; i++)
+            c += countNodes(x->C[i]);
+    return c;
+}
+
+double wallTime(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+void report(const char *what, struct BTreeNode *root, double seconds) {
+    int leafDepth = -1;
+    long keys = checkBTree(root, -1L, (long)RAND_MAX + 1, 1, 0, &leafDepth);
+    long nodes = countNodes(root);
+    printf("%-30s %7.3f s  %8ld keys  %7ld nodes  %5.1f%% full  %s\n", what, seconds, keys, nodes,
+           nodes ? 100.0 * keys / (nodes * (2.0 * MIN_DEGREE - 1)) : 0.0, keys >= 0 ? "valid" : "INVALID");
+}
+
+// Compares repeated insert / delete with bulk load / batch delete
+void benchmark(int n) {
+    int *keys = (int *)malloc(n * sizeof(int));
+    srand(1);
+    for (int i = 0; i < n; i++)
+        keys[i] = rand();
+
+    struct BTreeNode *a = NULL;
+    double s = wallTime();
+    for (int i = 0; i < n; i++)
+        if (a == NULL || search(a, keys[i]) == NULL)
+            insert(&a, keys[i]);
+    report("Insert one by one", a, wallTime() - s);
+
+    s = wallTime();
+    int m = sortUnique(keys, n);
+    struct BTreeNode *b = bulkLoad(keys, m, 1.0);
+    report("Sort + bulk load (fill 1.0)", b, wallTime() - s);
+    s = wallTime();
+    struct BTreeNode *c = bulkLoad(keys, m, 0.7);
+    report("Bulk load of sorted keys (0.7)", c, wallTime() - s);
+    freeTree(c);
+
+    // scattered batch: every other key; run batch: the middle 10% of the keys
+    int half = m / 2;
+    int *batch = (int *)malloc(half * sizeof(int));
+    for (int i = 0; i < half; i++)
+        batch[i] = keys[2 * i];
+
+    s = wallTime();
+    for (int i = 0; i < half; i++) {
+        deleteKey(a, batch[i]);
+        a = shrinkRoot(a);
+    }
+    report("Delete half one by one", a, wallTime() - s);
+
+    s = wallTime();
+    deleteBatch(&b, batch, half);
+    report("Batch delete half", b, wallTime() - s);
+
+    s = wallTime();
+    deleteBatch(&b, keys + 2 * m / 5, m / 10);
+    report("Batch delete a 10% key run", b, wallTime() - s);
+
+    freeTree(a);
+    freeTree(b);
+    free(batch);
+    free(keys);
 }
 
 // Main function
-int main() {
+int main(int argc, char **argv) {
     struct BTreeNode *root = NULL;
-    int choice, key;
+    int choice, key, count, *keys;
+    double fill;
+
+    if (argc > 2 && strcmp(argv[1], "--bench") == 0) {
+        benchmark(atoi(argv[2]));
+        return 0;
+    }
 
     while (1) {
         printf("\n\nB-TREE OPERATIONS\n");
-        printf("1. Insert\n2. Delete\n3. Traverse\n4. Exit\n");
+        printf("1. Insert\n2. Delete\n3. Traverse\n4. Bulk Load\n5. Batch Delete\n6. Exit\n");
         printf("Enter choice: ");
         scanf("%d", &choice);
 
@@ -312,9 +730,10 @@ int main() {
             case 2:
                 printf("Enter key to delete: ");
                 scanf("%d", &key);
-                if (root != NULL)
+                if (root != NULL) {
                     deleteKey(root, key);
-                else
+                    root = shrinkRoot(root);
+                } else
                     printf("Tree is empty.\n");
                 break;
             case 3:
@@ -323,6 +742,28 @@ int main() {
                 printf("\n");
                 break;
             case 4:
+                printf("Enter number of keys and fill factor (0.5-1.0): ");
+                scanf("%d %lf", &count, &fill);
+                keys = (int *)malloc((count > 0 ? count : 1) * sizeof(int));
+                printf("Enter %d keys: ", count);
+                for (int i = 0; i < count; i++)
+                    scanf("%d", &keys[i]);
+                freeTree(root);
+                root = bulkLoad(keys, sortUnique(keys, count), fill);
+                free(keys);
+                break;
+            case 5:
+                printf("Enter number of keys to delete: ");
+                scanf("%d", &count);
+                keys = (int *)malloc((count > 0 ? count : 1) * sizeof(int));
+                printf("Enter %d keys: ", count);
+                for (int i = 0; i < count; i++)
+                    scanf("%d", &keys[i]);
+                deleteBatch(&root, keys, count);
+                free(keys);
+                break;
+            case 6:
+                freeTree(root);
                 exit(0);
             default:
                 printf("Invalid choice!\n");
@@ -0,0 +1,993 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <time.h>
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#include "../../common/node_pool.h"
+
+/*
+   Concurrent AVL tree (map from int keys to long long values) in the style
+   of Bronson, Casper, Chafi and Olukotun, "A Practical Concurrent Binary
+   Search Tree".
+
+   - Every node has a version number. A rotation marks the node that moves
+     down as "shrinking" while it works and bumps the version afterwards.
+     A node that is removed from the tree gets the version UNLINKED.
+   - Lookups hold no locks. They walk down hand over hand: read the child
+     link, then check that the parent's version did not change. If it did,
+     the subtree may have moved and the search backs up one level.
+   - Updates take only the locks of the nodes they change. A removed key
+     whose node has two children stays in the tree as a "routing node" with
+     no value. It is unlinked later, once it has at most one child.
+   - Rebalancing is relaxed: heights are fixed and rotations are done
+     bottom-up after the update, one node at a time, under local locks.
+   - Unlinked nodes may still be read by other threads, so they are never
+     freed one by one. All nodes come from a pool that is freed at teardown.
+
+   Usage:
+     Concurrent_AVL                        interactive menu
+     Concurrent_AVL --stress [T] [rounds]  linearizability stress test
+     Concurrent_AVL --bench [T] [sec] [keys] throughput over read/write mixes
+*/
+
+#define NO_VALUE LLONG_MIN   // value of a routing node / "key not present"
+#define RETRY    (LLONG_MIN + 1)
+
+#define LEFT  0
+#define RIGHT 1
+
+// Version bits
+#define SHRINKING 1L
+#define UNLINKED  2L
+
+#define SPIN_COUNT 100
+
+// Condition codes from nodeCondition (otherwise it returns the new height)
+#define UNLINK_REQUIRED    -1
+#define REBALANCE_REQUIRED -2
+#define NOTHING_REQUIRED   -3
+
+#define LOAD(x)      __atomic_load_n(&(x), __ATOMIC_ACQUIRE)
+#define STORE(x, v)  __atomic_store_n(&(x), (v), __ATOMIC_RELEASE)
+
+typedef struct Node {
+    int key;
+    int height;
+    long version;
+    long long value;
+    struct Node *parent;
+    struct Node *child[2];
+    pthread_mutex_t lock;
+} Node;
+
+typedef struct {
+    Node holder;     // root is holder.child[RIGHT]
+    NodePool pool;
+} Tree;
+
+/* ---------- Version helpers ---------- */
+int isShrinking(long v)            { return (v & SHRINKING) != 0; }
+int isUnlinked(long v)             { return (v & UNLINKED) != 0; }
+int isShrinkingOrUnlinked(long v)  { return (v & (SHRINKING | UNLINKED)) != 0; }
+long beginChange(long v)           { return v | SHRINKING; }
+long endChange(long v)             { return (v | SHRINKING | UNLINKED) + 1; }
+
+/* ---------- Node helpers ---------- */
+Node* newNode(Tree* t, int key, long long value, Node* parent) {
+    Node* n = (Node*)np_alloc(&t->pool, sizeof(Node));
+    if (n == NULL) {
+        printf("Memory allocation failed\n");
+        exit(1);
+    }
+    n->key = key;
+    n->height = 1;
+    n->version = 0;
+    n->value = value;
+    n->parent = parent;
+    n->child[LEFT] = n->child[RIGHT] = NULL;
+    pthread_mutex_init(&n->lock, NULL);
+    return n;
+}
+
+int height(Node* n) {
+    return n == NULL ? 0 : LOAD(n->height);
+}
+
+int max(int a, int b) {
+    return (a > b) ? a : b;
+}
+
+void lockNode(Node* n)   { pthread_mutex_lock(&n->lock); }
+void unlockNode(Node* n) { pthread_mutex_unlock(&n->lock); }
+
+// Waits until a rotation that is moving this node down has finished
+void waitUntilNotChanging(Node* n) {
+    long v = LOAD(n->version);
+    if (isShrinking(v)) {
+        for (int i = 0; i < SPIN_COUNT; i++)
+            if (LOAD(n->version) != v)
+                return;
+        lockNode(n);     // the rotating thread holds the lock
+        unlockNode(n);
+    }
+}
+
+void initTree(Tree* t) {
+    memset(&t->holder, 0, sizeof(Node));
+    t->holder.value = NO_VALUE;
+    pthread_mutex_init(&t->holder.lock, NULL);
+    np_init(&t->pool, 1);
+}
+
+void destroyTree(Tree* t) {
+    np_destroy(&t->pool);
+}
+
+/* ---------- Lookup (no locks) ---------- */
+long long attemptGet(int key, Node* node, int dir, long nodeV) {
+    while (1) {
+        Node* child = LOAD(node->child[dir]);
+        if (child == NULL) {
+            if (LOAD(node->version) != nodeV)
+                return RETRY;
+            return NO_VALUE;
+        }
+
+        if (key == child->key)
+            return LOAD(child->value);
+
+        long childV = LOAD(child->version);
+        if (isShrinkingOrUnlinked(childV)) {
+            waitUntilNotChanging(child);
+            if (LOAD(node->version) != nodeV)
+                return RETRY;
+        } else if (child != LOAD(node->child[dir])) {
+            if (LOAD(node->version) != nodeV)
+                return RETRY;
+        } else {
+            // child is valid: hand over hand to the next level
+            if (LOAD(node->version) != nodeV)
+                return RETRY;
+            long long r = attemptGet(key, child, key < child->key ? LEFT : RIGHT, childV);
+            if (r != RETRY)
+                return r;
+        }
+    }
+}
+
+// Returns the value for key, or NO_VALUE
+long long get(Tree* t, int key) {
+    while (1) {
+        Node* right = LOAD(t->holder.child[RIGHT]);
+        if (right == NULL)
+            return NO_VALUE;
+        if (key == right->key)
+            return LOAD(right->value);
+
+        long v = LOAD(right->version);
+        if (isShrinkingOrUnlinked(v)) {
+            waitUntilNotChanging(right);
+        } else if (right == LOAD(t->holder.child[RIGHT])) {
+            long long r = attemptGet(key, right, key < right->key ? LEFT : RIGHT, v);
+            if (r != RETRY)
+                return r;
+        }
+    }
+}
+
+/* ---------- Height repair and rebalancing ---------- */
+
+// Decides what a node needs, from an unlocked (possibly stale) snapshot
+int nodeCondition(Node* n) {
+    Node* nL = LOAD(n->child[LEFT]);
+    Node* nR = LOAD(n->child[RIGHT]);
+    if ((nL == NULL || nR == NULL) && LOAD(n->value) == NO_VALUE)
+        return UNLINK_REQUIRED;
+
+    int hN = LOAD(n->height);
+    int hL = height(nL), hR = height(nR);
+    int hNew = 1 + max(hL, hR);
+    int bal = hL - hR;
+    if (bal < -1 || bal > 1)
+        return REBALANCE_REQUIRED;
+    return hN != hNew ? hNew : NOTHING_REQUIRED;
+}
+
+// n is locked. Fixes its height if that is all it needs and returns the
+// next node this thread is responsible for (NULL when done).
+Node* fixHeight_nl(Node* n) {
+    int c = nodeCondition(n);
+    switch (c) {
+        case REBALANCE_REQUIRED:
+        case UNLINK_REQUIRED:
+            return n;
+        case NOTHING_REQUIRED:
+            return NULL;
+        default:
+            STORE(n->height, c);
+            return LOAD(n->parent);
+    }
+}
+
+// parent and n are locked; n has at most one child and no value
+int attemptUnlink_nl(Node* parent, Node* n) {
+    Node* pL = parent->child[LEFT];
+    Node* pR = parent->child[RIGHT];
+    if (pL != n && pR != n)
+        return 0;
+
+    Node* left = n->child[LEFT];
+    Node* right = n->child[RIGHT];
+    if (left != NULL && right != NULL)
+        return 0;
+
+    // splice's parent changes, so it is locked like the moved nodes of a rotation
+    Node* splice = left != NULL ? left : right;
+    if (splice != NULL)
+        lockNode(splice);
+    STORE(parent->child[pL == n ? LEFT : RIGHT], splice);
+    if (splice != NULL) {
+        STORE(splice->parent, parent);
+        unlockNode(splice);
+    }
+
+    STORE(n->version, UNLINKED);
+    STORE(n->value, NO_VALUE);
+    return 1;
+}
+
+// Single rotation that lifts n->child[d] above n (d = LEFT is a right rotation).
+// nCN, the inner child that moves across, is locked if present.
+// hO is the height of n's other subtree, hNear/hFar of the lifted child's
+// inner and outer subtrees.
+Node* rotate_nl(Node* parent, Node* n, int d, int hO, Node* nC, Node* nCN, int hNear, int hFar) {
+    long nodeV = n->version;
+    STORE(n->version, beginChange(nodeV));
+
+    int pd = parent->child[LEFT] == n ? LEFT : RIGHT;
+
+    STORE(n->child[d], nCN);
+    if (nCN != NULL)
+        STORE(nCN->parent, n);
+
+    STORE(nC->child[1 - d], n);
+    STORE(n->parent, nC);
+
+    STORE(parent->child[pd], nC);
+    STORE(nC->parent, parent);
+
+    int hNew = 1 + max(hNear, hO);
+    STORE(n->height, hNew);
+    STORE(nC->height, 1 + max(hFar, hNew));
+
+    STORE(n->version, endChange(nodeV));
+
+    // n is the deepest damaged node: does it need another rotation or an unlink?
+    int balN = hNear - hO;
+    if (balN < -1 || balN > 1)
+        return n;
+    if ((nCN == NULL || hO == 0) && n->value == NO_VALUE)
+        return n;
+
+    int balC = hFar - hNew;
+    if (balC < -1 || balC > 1)
+        return nC;
+    if (hFar == 0 && nC->value == NO_VALUE)
+        return nC;
+
+    return fixHeight_nl(parent);
+}
+
+// Double rotation: lifts the inner grandchild nCN = nC->child[1-d] to n's
+// position. hFar is the height of nC's outer subtree and hNO the height of
+// nCN->child[d], the subtree that moves under nC. nCN and its children are locked.
+Node* rotateDouble_nl(Node* parent, Node* n, int d, int hO, Node* nC, int hFar, Node* nCN, int hNO) {
+    long nodeV = n->version;
+    long childV = nC->version;
+
+    int pd = parent->child[LEFT] == n ? LEFT : RIGHT;
+    Node* toC = nCN->child[d];       // stays below nC
+    Node* toN = nCN->child[1 - d];   // moves below n
+    int hToN = height(toN);
+
+    STORE(n->version, beginChange(nodeV));
+    STORE(nC->version, beginChange(childV));
+
+    STORE(n->child[d], toN);
+    if (toN != NULL)
+        STORE(toN->parent, n);
+
+    STORE(nC->child[1 - d], toC);
+    if (toC != NULL)
+        STORE(toC->parent, nC);
+
+    STORE(nCN->child[d], nC);
+    STORE(nC->parent, nCN);
+    STORE(nCN->child[1 - d], n);
+    STORE(n->parent, nCN);
+
+    STORE(parent->child[pd], nCN);
+    STORE(nCN->parent, parent);
+
+    int hNNew = 1 + max(hToN, hO);
+    STORE(n->height, hNNew);
+    int hCNew = 1 + max(hFar, hNO);
+    STORE(nC->height, hCNew);
+    STORE(nCN->height, 1 + max(hCNew, hNNew));
+
+    STORE(n->version, endChange(nodeV));
+    STORE(nC->version, endChange(childV));
+
+    int balN = hToN - hO;
+    if (balN < -1 || balN > 1)
+        return n;
+    if ((toN == NULL || hO == 0) && n->value == NO_VALUE)
+        return n;
+
+    int balCN = hCNew - hNNew;
+    if (balCN < -1 || balCN > 1)
+        return nCN;
+
+    return fixHeight_nl(parent);
+}
+
+// parent and n are locked and n's d side is too tall (hO is the other side).
+// Every node whose parent link a rotation changes is locked before its
+// height is read. A thread that fixes that node's height (holding its lock)
+// then sees either the old links and a rotation that used the new height,
+// or the new parent, so the damage is always passed to the right node.
+Node* rebalanceToward_nl(Node* parent, Node* n, int d, Node* nC, int hO) {
+    lockNode(nC);
+
+    int hC = nC->height;
+    if (hC - hO <= 1) {
+        unlockNode(nC);
+        return n;                        // stale snapshot: retry at n
+    }
+
+    Node* result = NULL;
+    int fallback = 0;
+    Node* nCN = nC->child[1 - d];        // inner grandchild
+    if (nCN != NULL)
+        lockNode(nCN);
+    int hFar = height(nC->child[d]);
+    int hNear = height(nCN);
+
+    if (hFar >= hNear) {
+        result = rotate_nl(parent, n, d, hO, nC, nCN, hNear, hFar);
+    } else {
+        Node* toC = nCN->child[d];
+        Node* toN = nCN->child[1 - d];
+        if (toC != NULL) lockNode(toC);
+        if (toN != NULL) lockNode(toN);
+
+        // Double rotate only if nC ends up balanced and not a needless routing node
+        int hNO = height(toC);
+        int b = hFar - hNO;
+        if (b >= -1 && b <= 1 && !((hFar == 0 || hNO == 0) && nC->value == NO_VALUE))
+            result = rotateDouble_nl(parent, n, d, hO, nC, hFar, nCN, hNO);
+        else
+            fallback = 1;
+
+        if (toN != NULL) unlockNode(toN);
+        if (toC != NULL) unlockNode(toC);
+    }
+    if (nCN != NULL)
+        unlockNode(nCN);
+
+    // otherwise fix nC first; n is rebalanced later if still needed
+    if (fallback)
+        result = rebalanceToward_nl(n, nC, 1 - d, nCN, hFar);
+
+    unlockNode(nC);
+    return result;
+}
+
+// parent and n are locked. Returns a damaged node, or NULL.
+Node* rebalance_nl(Node* parent, Node* n) {
+    Node* nL = n->child[LEFT];
+    Node* nR = n->child[RIGHT];
+
+    if ((nL == NULL || nR == NULL) && n->value == NO_VALUE) {
+        if (attemptUnlink_nl(parent, n))
+            return fixHeight_nl(parent);
+        return n;
+    }
+
+    int hN = n->height;
+    int hL = height(nL), hR = height(nR);
+    int hNew = 1 + max(hL, hR);
+    int bal = hL - hR;
+
+    if (bal > 1)
+        return rebalanceToward_nl(parent, n, LEFT, nL, hR);
+    if (bal < -1)
+        return rebalanceToward_nl(parent, n, RIGHT, nR, hL);
+    if (hNew != hN) {
+        STORE(n->height, hNew);
+        return fixHeight_nl(parent);
+    }
+    return NULL;
+}
+
+// Walks up from a damaged node, repairing heights and balance
+void fixHeightAndRebalance(Node* n) {
+    while (n != NULL && LOAD(n->parent) != NULL) {
+        int c = nodeCondition(n);
+        if (c == NOTHING_REQUIRED || isUnlinked(LOAD(n->version)))
+            return;
+
+        if (c != UNLINK_REQUIRED && c != REBALANCE_REQUIRED) {
+            Node* locked = n;
+            lockNode(locked);
+            n = fixHeight_nl(locked);
+            unlockNode(locked);
+        } else {
+            Node* parent = LOAD(n->parent);
+            lockNode(parent);
+            if (!isUnlinked(parent->version) && LOAD(n->parent) == parent) {
+                Node* locked = n;
+                lockNode(locked);
+                n = rebalance_nl(parent, locked);
+                unlockNode(locked);
+            }
+            unlockNode(parent);
+        }
+    }
+}
+
+/* ---------- Update (put and remove) ---------- */
+
+// Node with key was found below parent. newValue == NO_VALUE removes it.
+long long attemptNodeUpdate(long long newValue, Node* parent, Node* n) {
+    if (newValue == NO_VALUE && LOAD(n->value) == NO_VALUE)
+        return NO_VALUE;
+
+    if (newValue == NO_VALUE && (LOAD(n->child[LEFT]) == NULL || LOAD(n->child[RIGHT]) == NULL)) {
+        // removal that can unlink n: lock parent, then n
+        long long prev;
+        Node* damaged;
+        lockNode(parent);
+        if (isUnlinked(parent->version) || LOAD(n->parent) != parent) {
+            unlockNode(parent);
+            return RETRY;
+        }
+        lockNode(n);
+        prev = n->value;
+        if (prev == NO_VALUE) {
+            unlockNode(n);
+            unlockNode(parent);
+            return NO_VALUE;
+        }
+        if (!attemptUnlink_nl(parent, n)) {
+            unlockNode(n);
+            unlockNode(parent);
+            return RETRY;
+        }
+        unlockNode(n);
+        damaged = fixHeight_nl(parent);
+        unlockNode(parent);
+        fixHeightAndRebalance(damaged);
+        return prev;
+    }
+
+    // value change in place (also removal that leaves a routing node)
+    lockNode(n);
+    if (isUnlinked(n->version)) {
+        unlockNode(n);
+        return RETRY;
+    }
+    long long prev = n->value;
+    if (newValue == NO_VALUE && (n->child[LEFT] == NULL || n->child[RIGHT] == NULL)) {
+        unlockNode(n);      // n can be unlinked now: take the other path
+        return RETRY;
+    }
+    STORE(n->value, newValue);
+    unlockNode(n);
+    return prev;
+}
+
+long long attemptUpdate(Tree* t, int key, long long newValue, Node* parent, Node* node, long nodeV) {
+    if (key == node->key)
+        return attemptNodeUpdate(newValue, parent, node);
+
+    int dir = key < node->key ? LEFT : RIGHT;
+    while (1) {
+        Node* child = LOAD(node->child[dir]);
+        if (LOAD(node->version) != nodeV)
+            return RETRY;
+
+        if (child == NULL) {
+            if (newValue == NO_VALUE)
+                return NO_VALUE;      // nothing to remove
+
+            // insert a leaf under node
+            int inserted = 0;
+            Node* damaged = NULL;
+            lockNode(node);
+            if (node->version != nodeV) {
+                unlockNode(node);
+                return RETRY;
+            }
+            if (node->child[dir] == NULL) {
+                STORE(node->child[dir], newNode(t, key, newValue, node));
+                inserted = 1;
+                damaged = fixHeight_nl(node);
+            }
+            unlockNode(node);
+            if (inserted) {
+                fixHeightAndRebalance(damaged);
+                return NO_VALUE;
+            }
+        } else {
+            long childV = LOAD(child->version);
+            if (isShrinkingOrUnlinked(childV)) {
+                waitUntilNotChanging(child);
+            } else if (child != LOAD(node->child[dir])) {
+                // link changed: reread it
+            } else {
+                if (LOAD(node->version) != nodeV)
+                    return RETRY;
+                long long r = attemptUpdate(t, key, newValue, node, child, childV);
+                if (r != RETRY)
+                    return r;
+            }
+        }
+    }
+}
+
+// newValue == NO_VALUE removes the key. Returns the previous value or NO_VALUE.
+long long update(Tree* t, int key, long long newValue) {
+    Node* holder = &t->holder;
+    while (1) {
+        Node* right = LOAD(holder->child[RIGHT]);
+        if (right == NULL) {
+            if (newValue == NO_VALUE)
+                return NO_VALUE;
+            lockNode(holder);
+            if (holder->child[RIGHT] == NULL) {
+                STORE(holder->child[RIGHT], newNode(t, key, newValue, holder));
+                STORE(holder->height, 2);
+                unlockNode(holder);
+                return NO_VALUE;
+            }
+            unlockNode(holder);
+            continue;
+        }
+
+        long v = LOAD(right->version);
+        if (isShrinkingOrUnlinked(v)) {
+            waitUntilNotChanging(right);
+        } else if (right == LOAD(holder->child[RIGHT])) {
+            long long r = attemptUpdate(t, key, newValue, holder, right, v);
+            if (r != RETRY)
+                return r;
+        }
+    }
+}
+
+long long put(Tree* t, int key, long long value) {
+    return update(t, key, value);
+}
+
+long long removeKey(Tree* t, int key) {
+    return update(t, key, NO_VALUE);
+}
+
+/* ---------- Quiescent traversal and checks ---------- */
+void inOrder(Node* n) {
+    if (n == NULL) return;
+    inOrder(n->child[LEFT]);
+    if (n->value != NO_VALUE)
+        printf("%d ", n->key);
+    inOrder(n->child[RIGHT]);
+}
+
+void preOrder(Node* n) {
+    if (n == NULL) return;
+    if (n->value != NO_VALUE)
+        printf("%d ", n->key);
+    else
+        printf("(%d) ", n->key);       // routing node
+    preOrder(n->child[LEFT]);
+    preOrder(n->child[RIGHT]);
+}
+
+// Verifies order, parent links, heights and AVL balance; returns height or -1
+int checkTree(Node* n, Node* parent, long lo, long hi, long* keys, long* routing) {
+    if (n == NULL) return 0;
+    if (n->parent != parent || n->key <= lo || n->key >= hi || isUnlinked(n->version))
+        return -1;
+    int hL = checkTree(n->child[LEFT], n, lo, n->key, keys, routing);
+    int hR = checkTree(n->child[RIGHT], n, n->key, hi, keys, routing);
+    if (hL < 0 || hR < 0) return -1;
+    if (hL - hR > 1 || hR - hL > 1 || n->height != 1 + max(hL, hR))
+        return -1;
+    if (n->value == NO_VALUE) {
+        if (n->child[LEFT] == NULL || n->child[RIGHT] == NULL) return -1;
+        (*routing)++;
+    } else {
+        (*keys)++;
+    }
+    return n->height;
+}
+
+/* ---------- Random numbers and time ---------- */
+unsigned long long nextRandom(unsigned long long* s) {
+    *s ^= *s << 13;
+    *s ^= *s >> 7;
+    *s ^= *s << 17;
+    return *s;
+}
+
+double wallTime(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/* ---------- Linearizability stress test ----------
+   Threads run rounds of random operations. A few keys are "tracked": every
+   operation on them is logged with invocation and response times taken from
+   a shared counter. Between rounds the main thread checks each tracked key's
+   history on its own, which is enough because linearizability is local:
+   a map is linearizable iff the history of every key is. A depth-first
+   search looks for an order of the operations that respects real time and
+   the semantics of a single register (get / put / remove returning the
+   previous value). Other operations on untracked keys keep the tree
+   rotating around the tracked keys.
+*/
+#define TRACKED_KEYS   4
+#define TRACKED_OPS    4      // tracked operations per thread per round
+#define NOISE_OPS      8      // untracked operations between tracked ones
+#define KEY_RANGE      512
+#define MAX_THREADS    16
+
+enum { OP_GET, OP_PUT, OP_REMOVE };
+
+typedef struct {
+    int type, key;
+    long long arg, ret;
+    unsigned long inv, res;
+} Op;
+
+typedef struct {
+    Tree* tree;
+    int id, rounds;
+    Op* log;                   // rounds * TRACKED_OPS entries
+    pthread_barrier_t* start;
+    pthread_barrier_t* end;
+} StressArg;
+
+unsigned long logicalClock = 0;
+
+int trackedKey(int i) {
+    return (i + 1) * (KEY_RANGE / (TRACKED_KEYS + 1));
+}
+
+void* stressWorker(void* p) {
+    StressArg* a = (StressArg*)p;
+    unsigned long long seed = 88172645463325252ULL + 7919ULL * a->id;
+    long long seq = 0;
+
+    for (int r = 0; r < a->rounds; r++) {
+        pthread_barrier_wait(a->start);
+        for (int i = 0; i < TRACKED_OPS; i++) {
+            for (int j = 0; j < NOISE_OPS; j++) {
+                int key = (int)(nextRandom(&seed) % KEY_RANGE);
+                if (key % (KEY_RANGE / (TRACKED_KEYS + 1)) == 0) key++;
+                if (nextRandom(&seed) & 1) put(a->tree, key, key);
+                else removeKey(a->tree, key);
+            }
+
+            Op* op = &a->log[r * TRACKED_OPS + i];
+            op->key = trackedKey((int)(nextRandom(&seed) % TRACKED_KEYS));
+            op->type = (int)(nextRandom(&seed) % 3);
+            op->arg = ((long long)(a->id + 1) << 40) | ++seq;   // unique value per put
+
+            op->inv = __atomic_fetch_add(&logicalClock, 1, __ATOMIC_SEQ_CST);
+            if (op->type == OP_GET) op->ret = get(a->tree, op->key);
+            else if (op->type == OP_PUT) op->ret = put(a->tree, op->key, op->arg);
+            else op->ret = removeKey(a->tree, op->key);
+            op->res = __atomic_fetch_add(&logicalClock, 1, __ATOMIC_SEQ_CST);
+        }
+        pthread_barrier_wait(a->end);
+    }
+    np_thread_flush(&a->tree->pool);
+    return NULL;
+}
+
+// Failed (done, state) pairs, so the search never explores one twice.
+// Entries are valid only if their stamp matches the current search.
+#define SEEN_BITS 16
+
+typedef struct {
+    unsigned long long* mask;
+    long long* state;
+    unsigned* stamp;
+    unsigned current;
+} SeenSet;
+
+unsigned long long seenSlot(unsigned long long done, long long state) {
+    unsigned long long h = done * 0x9E3779B97F4A7C15ULL ^ (unsigned long long)state * 0xC2B2AE3D27D4EB4FULL;
+    return h >> (64 - SEEN_BITS);
+}
+
+int seenFind(SeenSet* s, unsigned long long done, long long state, int insert) {
+    unsigned long long i = seenSlot(done, state);
+    for (int probe = 0; probe < 32; probe++, i = (i + 1) & ((1u << SEEN_BITS) - 1)) {
+        if (s->stamp[i] != s->current) {
+            if (insert) {
+                s->stamp[i] = s->current;
+                s->mask[i] = done;
+                s->state[i] = state;
+            }
+            return 0;
+        }
+        if (s->mask[i] == done && s->state[i] == state)
+            return 1;
+    }
+    return 0;      // table crowded here: just search again
+}
+
+// Searches for a legal order of the remaining ops; done is a bitmask of ops already placed
+int linearize(Op** ops, int n, unsigned long long done, long long state, long long finalState, SeenSet* seen) {
+    if (done == (n == 64 ? ~0ULL : (1ULL << n) - 1))
+        return state == finalState;
+    if (seenFind(seen, done, state, 0))
+        return 0;
+
+    // earliest response among remaining ops: only ops invoked before it can go next
+    unsigned long minRes = ULONG_MAX;
+    for (int i = 0; i < n; i++)
+        if (!(done >> i & 1) && ops[i]->res < minRes)
+            minRes = ops[i]->res;
+
+    for (int i = 0; i < n; i++) {
+        if (done >> i & 1 || ops[i]->inv > minRes) continue;
+        if (ops[i]->ret != state) continue;    // every op returns the current value
+        long long next = ops[i]->type == OP_GET ? state
+                       : ops[i]->type == OP_PUT ? ops[i]->arg : NO_VALUE;
+        if (linearize(ops, n, done | (1ULL << i), next, finalState, seen))
+            return 1;
+    }
+
+    seenFind(seen, done, state, 1);
+    return 0;
+}
+
+int stressTest(int threads, int rounds) {
+    if (threads > MAX_THREADS) threads = MAX_THREADS;
+    Tree tree;
+    initTree(&tree);
+
+    pthread_barrier_t start, end;
+    pthread_barrier_init(&start, NULL, threads + 1);
+    pthread_barrier_init(&end, NULL, threads + 1);
+
+    StressArg args[MAX_THREADS];
+    pthread_t tid[MAX_THREADS];
+    for (int i = 0; i < threads; i++) {
+        args[i] = (StressArg){ &tree, i, rounds,
+                               (Op*)malloc((size_t)rounds * TRACKED_OPS * sizeof(Op)), &start, &end };
+        pthread_create(&tid[i], NULL, stressWorker, &args[i]);
+    }
+
+    SeenSet seen;
+    seen.mask = (unsigned long long*)malloc(sizeof(unsigned long long) << SEEN_BITS);
+    seen.state = (long long*)malloc(sizeof(long long) << SEEN_BITS);
+    seen.stamp = (unsigned*)calloc(1u << SEEN_BITS, sizeof(unsigned));
+    seen.current = 0;
+    long long state[TRACKED_KEYS];
+    for (int k = 0; k < TRACKED_KEYS; k++) state[k] = NO_VALUE;
+
+    long failures = 0, checked = 0;
+    for (int r = 0; r < rounds; r++) {
+        pthread_barrier_wait(&start);
+        pthread_barrier_wait(&end);
+
+        for (int k = 0; k < TRACKED_KEYS; k++) {
+            Op* ops[64];
+            int n = 0;
+            for (int i = 0; i < threads; i++)
+                for (int j = 0; j < TRACKED_OPS; j++) {
+                    Op* op = &args[i].log[r * TRACKED_OPS + j];
+                    if (op->key == trackedKey(k)) ops[n++] = op;
+                }
+
+            long long finalState = get(&tree, trackedKey(k));
+            seen.current++;
+            if (!linearize(ops, n, 0, state[k], finalState, &seen)) {
+                if (failures++ < 5)
+                    printf("Round %d, key %d: history of %d operations is not linearizable\n",
+                           r, trackedKey(k), n);
+            }
+            checked += n;
+            state[k] = finalState;
+        }
+    }
+
+    for (int i = 0; i < threads; i++) {
+        pthread_join(tid[i], NULL);
+        free(args[i].log);
+    }
+
+    long keys = 0, routing = 0;
+    int h = checkTree(tree.holder.child[RIGHT], &tree.holder, LONG_MIN, LONG_MAX, &keys, &routing);
+
+    printf("Threads: %d, rounds: %d, tracked operations checked: %ld\n", threads, rounds, checked);
+    printf("Linearizability violations: %ld\n", failures);
+    if (h < 0)
+        printf("Final tree: INVALID (order, links, heights or balance)\n");
+    else
+        printf("Final tree: valid AVL, height %d, %ld keys, %ld routing nodes\n", h, keys, routing);
+
+    free(seen.mask);
+    free(seen.state);
+    free(seen.stamp);
+    pthread_barrier_destroy(&start);
+    pthread_barrier_destroy(&end);
+    destroyTree(&tree);
+    return failures == 0 && h >= 0;
+}
+
+/* ---------- Throughput benchmark ---------- */
+typedef struct {
+    Tree* tree;
+    int id, readPct, keyRange;
+    volatile int* stop;
+    long ops;
+} BenchArg;
+
+void* benchWorker(void* p) {
+    BenchArg* a = (BenchArg*)p;
+    unsigned long long seed = 0x9E3779B97F4A7C15ULL ^ (unsigned long long)(a->id + 1) * 1000003ULL;
+    long ops = 0;
+    while (!LOAD(*a->stop)) {
+        for (int i = 0; i < 64; i++) {
+            unsigned long long r = nextRandom(&seed);
+            int key = (int)((r >> 8) % (unsigned)a->keyRange);
+            int pct = (int)(r % 100);
+            if (pct < a->readPct) get(a->tree, key);
+            else if (pct & 1) put(a->tree, key, key);
+            else removeKey(a->tree, key);
+        }
+        ops += 64;
+    }
+    a->ops = ops;
+    np_thread_flush(&a->tree->pool);
+    return NULL;
+}
+
+double runBench(int threads, int readPct, int keyRange, double seconds) {
+    Tree tree;
+    initTree(&tree);
+    unsigned long long seed = 12345;
+    for (int i = 0; i < keyRange / 2; i++) {
+        int key = (int)(nextRandom(&seed) % (unsigned)keyRange);
+        put(&tree, key, key);
+    }
+
+    volatile int stop = 0;
+    BenchArg args[64];
+    pthread_t tid[64];
+    for (int i = 0; i < threads; i++) {
+        args[i] = (BenchArg){ &tree, i, readPct, keyRange, &stop, 0 };
+        pthread_create(&tid[i], NULL, benchWorker, &args[i]);
+    }
+
+    double t = wallTime();
+    usleep((useconds_t)(seconds * 1e6));
+    STORE(stop, 1);
+    long total = 0;
+    for (int i = 0; i < threads; i++) {
+        pthread_join(tid[i], NULL);
+        total += args[i].ops;
+    }
+    t = wallTime() - t;
+
+    destroyTree(&tree);
+    return total / t / 1e6;
+}
+
+void benchmark(int maxThreads, double seconds, int keyRange) {
+    int mixes[] = { 100, 90, 50, 0 };
+    if (maxThreads > 64) maxThreads = 64;
+
+    printf("Key range %d, %.1f s per run, Mops/s (reads%% / writes%%)\n", keyRange, seconds);
+    printf("Threads");
+    for (int m = 0; m < 4; m++)
+        printf("   %3d/%-3d", mixes[m], 100 - mixes[m]);
+    printf("\n");
+
+    for (int t = 1; t <= maxThreads; t *= 2) {
+        printf("%7d", t);
+        for (int m = 0; m < 4; m++) {
+            printf("  %8.2f", runBench(t, mixes[m], keyRange, seconds));
+            fflush(stdout);
+        }
+        printf("\n");
+        if (t < maxThreads && t * 2 > maxThreads) t = maxThreads / 2;   // always end at maxThreads
+    }
+}
+
+/* ---------- Driver ---------- */
+int main(int argc, char** argv) {
+    int cores = (int)sysconf(_SC_NPROCESSORS_ONLN);
+
+    if (argc > 1 && strcmp(argv[1], "--stress") == 0) {
+        int threads = argc > 2 ? atoi(argv[2]) : (cores < MAX_THREADS ? cores : MAX_THREADS);
+        int rounds = argc > 3 ? atoi(argv[3]) : 20000;
+        if (threads < 2) threads = 2;
+        return stressTest(threads, rounds) ? 0 : 1;
+    }
+    if (argc > 1 && strcmp(argv[1], "--bench") == 0) {
+        int threads = argc > 2 ? atoi(argv[2]) : cores;
+        double seconds = argc > 3 ? atof(argv[3]) : 1.0;
+        int keyRange = argc > 4 ? atoi(argv[4]) : 100000;
+        benchmark(threads, seconds, keyRange);
+        return 0;
+    }
+
+    Tree tree;
+    initTree(&tree);
+    int choice, val;
+
+    while (1) {
+        printf("\n\n--- Concurrent AVL Tree Menu ---\n");
+        printf("1. Insert\t");
+        printf("2. Delete\t");
+        printf("3. Search\t");
+        printf("4. Preorder Traversal\t");
+        printf("5. Inorder Traversal\t");
+        printf("6. Exit\n");
+        printf("Enter choice: ");
+        if (scanf("%d", &choice) != 1)
+            break;
+
+        switch(choice) {
+            case 1:
+                printf("Enter value to insert: ");
+                scanf("%d", &val);
+                put(&tree, val, val);
+                break;
+
+            case 2:
+                printf("Enter value to delete: ");
+                scanf("%d", &val);
+                if (removeKey(&tree, val) == NO_VALUE)
+                    printf("%d not found\n", val);
+                break;
+
+            case 3:
+                printf("Enter value to search: ");
+                scanf("%d", &val);
+                printf(get(&tree, val) != NO_VALUE ? "%d found\n" : "%d not found\n", val);
+                break;
+
+            case 4:
+                printf("Preorder (routing nodes in parentheses): ");
+                preOrder(tree.holder.child[RIGHT]);
+                printf("\n");
+                break;
+
+            case 5:
+                printf("Inorder: ");
+                inOrder(tree.holder.child[RIGHT]);
+                printf("\n");
+                break;
+
+            case 6:
+                destroyTree(&tree);
+                exit(0);
+
+            default:
+                printf("Invalid choice!\n");
+        }
+    }
+    destroyTree(&tree);
+    return 0;
+}
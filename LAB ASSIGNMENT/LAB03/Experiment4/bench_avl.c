@@ -0,0 +1,45 @@
+/*
+   Ordered index benchmark for the AVL tree (see common/index_bench.h).
+
+   Usage:
+       gcc -O2 bench_avl.c -o bench_avl -pthread -lm
+       ./bench_avl [--n 1000,100000,1000000] [--ops N] [--workload ...]
+*/
+#define main avl_main
+#include "AVL_TREE.c"
+#undef main
+#include "../../common/index_bench.h"
+
+struct Node* root = NULL;
+
+void ib_reset(void) {
+    np_destroy(&pool);
+    np_init(&pool, 1);
+    root = NULL;
+}
+
+void ib_insert(int key) { root = insert(root, key); }
+
+void ib_erase(int key) { root = deleteNode(root, key); }
+
+int ib_find(int key) {
+    struct Node* n = root;
+    while (n != NULL && n->key != key)
+        n = key < n->key ? n->left : n->right;
+    return n != NULL;
+}
+
+long ib_range(int lo, int hi) {
+    RangeIter it;
+    long count = 0;
+    int key;
+    rangeBegin(&it, root, lo, hi);
+    while (rangeNext(&it, &key))
+        count++;
+    return count;
+}
+
+int main(int argc, char** argv) {
+    np_init(&pool, 1);
+    return ib_main(argc, argv, "AVL", 0);
+}
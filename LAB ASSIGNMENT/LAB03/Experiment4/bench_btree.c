@@ -0,0 +1,57 @@
+/*
+   Ordered index benchmark for the B-tree (see common/index_bench.h).
+   Node size follows MIN_DEGREE in B_tree.c.
+
+   Usage:
+       gcc -O2 bench_btree.c -o bench_btree -lm
+       ./bench_btree [--n 1000,100000,1000000] [--ops N] [--workload ...]
+*/
+#define main btree_main
+#include "B_tree.c"
+#undef main
+#include "../../common/index_bench.h"
+
+struct BTreeNode *root = NULL;
+
+void ib_reset(void) {
+    freeTree(root);
+    root = NULL;
+}
+
+void ib_insert(int key) { insert(&root, key); }
+
+void ib_erase(int key) {
+    deleteKey(root, key);
+    root = shrinkRoot(root);
+}
+
+int ib_find(int key) { return root != NULL && search(root, key) != NULL; }
+
+// Keys of x in [lo, hi), in order; stops early once a key >= hi is seen
+static long rangeCount(struct BTreeNode *x, int lo, int hi, int *done) {
+    long count = 0;
+    int i = 0;
+    while (i < x->n && x->keys[i] < lo)
+        i++;
+    for (; i <= x->n && !*done; i++) {
+        if (!x->leaf)
+            count += rangeCount(x->C[i], lo, hi, done);
+        if (i == x->n || *done)
+            break;
+        if (x->keys[i] >= hi) {
+            *done = 1;
+            break;
+        }
+        count++;
+    }
+    return count;
+}
+
+long ib_range(int lo, int hi) {
+    int done = 0;
+    return root != NULL ? rangeCount(root, lo, hi, &done) : 0;
+}
+
+int main(int argc, char **argv) {
+    return ib_main(argc, argv, "B-tree", 0);
+}
@@ -1,54 +1,585 @@
 #include <stdio.h>
-#define INF 99999
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <limits.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "../../common/dense_kernels.h"
+#include "../../common/csr_graph.h"
+#include "../../common/indexed_heap.h"
 
-void printSolution(int n, int dist[n][n]) {
+/*
+   Floyd-Warshall all-pairs shortest paths, blocked.
+
+   The classic k-i-j loop streams the whole n x n matrix from memory n
+   times. The blocked version cuts the matrix into TILE x TILE tiles and
+   does, for each diagonal tile kb:
+     1. the diagonal tile (kb, kb), closed on its own;
+     2. the tiles in row kb and column kb, using the diagonal tile;
+     3. every other tile (ib, jb), a min-plus product of tile (ib, kb) and
+        tile (kb, jb).
+   Phase 3 has no dependencies between tiles, does almost all the work and
+   is split across threads (DK_NUM_THREADS, see dense_kernels.h); phase 2
+   tiles are independent of each other too. Three tiles fit in L2 and a
+   row of the output tile stays in AVX2 registers, chosen at run time.
+
+   Matrices are heap-allocated with rows padded to a multiple of TILE. The
+   padding vertices have no arcs, so they change nothing.
+
+   For sparse graphs Johnson's algorithm is faster: Bellman-Ford from a
+   virtual source gives potentials h with w(u,v) + h(u) - h(v) >= 0, and
+   then one Dijkstra per source on the reweighted CSR graph, O(nm log n)
+   in all, with the sources shared among threads. Each result row is a
+   distance row and a predecessor row, so every shortest path can be
+   rebuilt. Rows can be kept in memory or written straight to a file, so
+   the n^2 output never has to fit in RAM. The file is "APSP", int n, then
+   for each source s in order: int64 dist[n] (INT64_MAX: no path) and
+   int pred[n] (-1 at s and where there is no path).
+
+   Usage:
+       gcc -O2 Floyd_warshall.c -o floyd -pthread
+       ./floyd                          interactive
+       ./floyd --bench N [pct]          random graph, N vertices, pct% of
+                                        the arcs present (default 10);
+                                        compared with the classic loop
+                                        when N <= 2000
+       ./floyd --johnson N|file.gr [out.apsp]
+                                        Johnson on a random graph with N
+                                        vertices and 4N arcs, some negative,
+                                        or on a DIMACS graph; compared with
+                                        Floyd-Warshall when N <= 2000
+       ./floyd --path out.apsp s t      a shortest path from the file
+*/
+
+#define INF (INT_MAX / 2)          // no arc; INF + INF does not overflow
+#define UNREACHABLE(d) ((d) > INF / 2)
+#define TILE 64
+#define VERIFY_LIMIT 2000
+
+typedef struct {
+    int n, ld;      // vertices, row stride (multiple of TILE)
+    int* d;         // d[i * ld + j]
+} DistMatrix;
+
+// n x n matrix with 0 on the diagonal and INF elsewhere
+DistMatrix newDistMatrix(int n) {
+    DistMatrix m;
+    m.n = n;
+    m.ld = (n + TILE - 1) / TILE * TILE;
+    if (m.ld == 0)
+        m.ld = TILE;
+    m.d = (int*)aligned_alloc(64, (size_t)m.ld * m.ld * sizeof(int));
+    if (m.d == NULL)
+        return m;
+    for (size_t i = 0; i < (size_t)m.ld * m.ld; i++)
+        m.d[i] = INF;
+    for (int i = 0; i < m.ld; i++)
+        m.d[(size_t)i * m.ld + i] = 0;
+    return m;
+}
+
+/* ---------- Tile kernels ---------- */
+// Both kernels compute c[i][j] = min(c[i][j], a[i][k] + b[k][j]) over the
+// k of one tile. closeTile runs k outermost, so c may be a or b (phases 1
+// and 2); minPlusTile keeps a row of c in registers and needs c distinct
+// from a and b (phase 3).
+void closeTileScalar(int* c, const int* a, const int* b, int ld) {
+    for (int k = 0; k < TILE; k++)
+        for (int i = 0; i < TILE; i++) {
+            int aik = a[(size_t)i * ld + k];
+            if (UNREACHABLE(aik))
+                continue;
+            int* ci = c + (size_t)i * ld;
+            const int* bk = b + (size_t)k * ld;
+            for (int j = 0; j < TILE; j++)
+                if (aik + bk[j] < ci[j])
+                    ci[j] = aik + bk[j];
+        }
+}
+
+void minPlusTileScalar(int* restrict c, const int* restrict a, const int* restrict b, int ld) {
+    for (int i = 0; i < TILE; i++) {
+        int row[TILE];
+        int* ci = c + (size_t)i * ld;
+        memcpy(row, ci, sizeof(row));
+        for (int k = 0; k < TILE; k++) {
+            int aik = a[(size_t)i * ld + k];
+            if (UNREACHABLE(aik))
+                continue;
+            const int* bk = b + (size_t)k * ld;
+            for (int j = 0; j < TILE; j++)
+                row[j] = aik + bk[j] < row[j] ? aik + bk[j] : row[j];
+        }
+        memcpy(ci, row, sizeof(row));
+    }
+}
+
+#if DK_X86
+DK_TARGET_AVX2
+static void closeTileAvx2(int* c, const int* a, const int* b, int ld) {
+    for (int k = 0; k < TILE; k++) {
+        const int* bk = b + (size_t)k * ld;
+        for (int i = 0; i < TILE; i++) {
+            int aik = a[(size_t)i * ld + k];
+            if (UNREACHABLE(aik))
+                continue;
+            __m256i va = _mm256_set1_epi32(aik);
+            int* ci = c + (size_t)i * ld;
+            for (int j = 0; j < TILE; j += 8) {
+                __m256i s = _mm256_add_epi32(va, _mm256_load_si256((const __m256i*)(bk + j)));
+                __m256i v = _mm256_load_si256((const __m256i*)(ci + j));
+                _mm256_store_si256((__m256i*)(ci + j), _mm256_min_epi32(v, s));
+            }
+        }
+    }
+}
+
+DK_TARGET_AVX2
+static void minPlusTileAvx2(int* restrict c, const int* restrict a, const int* restrict b, int ld) {
+    for (int i = 0; i < TILE; i++) {
+        int* ci = c + (size_t)i * ld;
+        const int* ai = a + (size_t)i * ld;
+        __m256i r[TILE / 8];
+        for (int v = 0; v < TILE / 8; v++)
+            r[v] = _mm256_load_si256((const __m256i*)(ci + 8 * v));
+        for (int k = 0; k < TILE; k++) {
+            if (UNREACHABLE(ai[k]))
+                continue;
+            __m256i va = _mm256_set1_epi32(ai[k]);
+            const int* bk = b + (size_t)k * ld;
+            for (int v = 0; v < TILE / 8; v++)
+                r[v] = _mm256_min_epi32(r[v], _mm256_add_epi32(va, _mm256_load_si256((const __m256i*)(bk + 8 * v))));
+        }
+        for (int v = 0; v < TILE / 8; v++)
+            _mm256_store_si256((__m256i*)(ci + 8 * v), r[v]);
+    }
+}
+#endif
+
+typedef void (*TileKernel)(int*, const int*, const int*, int);
+TileKernel closeTile = closeTileScalar;
+TileKernel minPlusTile = minPlusTileScalar;
+
+void selectKernels(void) {
+#if DK_X86
+    if (dk_has_avx2()) {
+        closeTile = closeTileAvx2;
+        minPlusTile = minPlusTileAvx2;
+    }
+#endif
+}
+
+/* ---------- Blocked Floyd-Warshall ---------- */
+typedef struct {
+    DistMatrix* m;
+    int kb, tiles;
+} Round;
+
+static int* tileAt(const DistMatrix* m, int ib, int jb) {
+    return m->d + (size_t)ib * TILE * m->ld + (size_t)jb * TILE;
+}
+
+// Phase 2: task t < tiles-1 is a tile of row kb, the rest are column kb
+void rowColumnTiles(void* ctx, int lo, int hi) {
+    Round* r = (Round*)ctx;
+    int* diag = tileAt(r->m, r->kb, r->kb);
+    for (int t = lo; t < hi; t++) {
+        int other = t % (r->tiles - 1);
+        other += other >= r->kb;
+        if (t < r->tiles - 1) {
+            int* c = tileAt(r->m, r->kb, other);
+            closeTile(c, diag, c, r->m->ld);
+        } else {
+            int* c = tileAt(r->m, other, r->kb);
+            closeTile(c, c, diag, r->m->ld);
+        }
+    }
+}
+
+// Phase 3 for tile rows [lo, hi)
+void remainingTiles(void* ctx, int lo, int hi) {
+    Round* r = (Round*)ctx;
+    for (int ib = lo; ib < hi; ib++) {
+        if (ib == r->kb)
+            continue;
+        const int* col = tileAt(r->m, ib, r->kb);
+        for (int jb = 0; jb < r->tiles; jb++)
+            if (jb != r->kb)
+                minPlusTile(tileAt(r->m, ib, jb), col, tileAt(r->m, r->kb, jb), r->m->ld);
+    }
+}
+
+// Shortest distances in place; returns 1 if there is a negative cycle
+int floydWarshall(DistMatrix* m) {
+    selectKernels();
+    int tiles = m->ld / TILE;
+    double tileWork = (double)TILE * TILE * TILE;
+    for (int kb = 0; kb < tiles; kb++) {
+        Round r = { m, kb, tiles };
+        int* diag = tileAt(m, kb, kb);
+        closeTile(diag, diag, diag, m->ld);
+        if (tiles > 1) {
+            dk_parallel_for(2 * (tiles - 1), 1, 2.0 * (tiles - 1) * tileWork, rowColumnTiles, &r);
+            dk_parallel_for(tiles, 1, (double)(tiles - 1) * (tiles - 1) * tileWork, remainingTiles, &r);
+        }
+    }
+    for (int i = 0; i < m->n; i++)
+        if (m->d[(size_t)i * m->ld + i] < 0)
+            return 1;
+    return 0;
+}
+
+// The textbook k-i-j loop, kept as a reference for the benchmark
+void floydWarshallClassic(DistMatrix* m) {
+    int n = m->n, ld = m->ld;
+    for (int k = 0; k < n; k++)
+        for (int i = 0; i < n; i++) {
+            int dik = m->d[(size_t)i * ld + k];
+            if (UNREACHABLE(dik))
+                continue;
+            for (int j = 0; j < n; j++)
+                if (dik + m->d[(size_t)k * ld + j] < m->d[(size_t)i * ld + j])
+                    m->d[(size_t)i * ld + j] = dik + m->d[(size_t)k * ld + j];
+        }
+}
+
+void printSolution(const DistMatrix* m) {
     printf("\nShortest distances between every pair of vertices:\n");
-    for (int i = 0; i < n; i++) {
-        for (int j = 0; j < n; j++) {
-            if (dist[i][j] == INF)
+    for (int i = 0; i < m->n; i++) {
+        for (int j = 0; j < m->n; j++) {
+            int d = m->d[(size_t)i * m->ld + j];
+            if (UNREACHABLE(d))
                 printf("%7s", "INF");
             else
-                printf("%7d", dist[i][j]);
+                printf("%7d", d);
         }
         printf("\n");
     }
 }
 
-void floydWarshall(int n, int graph[n][n]) {
-    int dist[n][n];
+/* ---------- Johnson's algorithm for sparse graphs ---------- */
+#define NO_PATH INT64_MAX
+
+// Potentials for the reweighting: distances from a virtual vertex with a
+// 0-length arc to every vertex. Returns -1 if there is a negative cycle.
+int bellmanFord(const CsrGraph* g, int64_t* h) {
+    for (int v = 0; v < g->n; v++)
+        h[v] = 0;
+    for (int round = 0; round <= g->n; round++) {
+        int changed = 0;
+        for (int u = 0; u < g->n; u++)
+            for (long a = g->offset[u]; a < g->offset[u + 1]; a++)
+                if (h[u] + g->weight[a] < h[g->target[a]]) {
+                    h[g->target[a]] = h[u] + g->weight[a];
+                    changed = 1;
+                }
+        if (!changed)
+            return 0;
+    }
+    return -1;
+}
+
+typedef struct {
+    const CsrGraph* g;
+    const int64_t* rw;      // reweighted arc lengths, all >= 0
+    const int64_t* h;
+    int64_t* dist;          // n x n rows kept in memory, or NULL
+    int* pred;
+    int fd;                 // file the rows are written to, or -1
+    int64_t checksum;       // sum of all finite distances
+    int failed;             // a write failed
+} Johnson;
 
-    // Step 1: Initialize distance matrix
+static off_t rowOffset(int n, int s) {
+    return 8 + (off_t)s * n * (sizeof(int64_t) + sizeof(int));
+}
+
+// Dijkstra from every source in [lo, hi), each thread with its own arrays
+void johnsonRows(void* ctx, int lo, int hi) {
+    Johnson* J = (Johnson*)ctx;
+    const CsrGraph* g = J->g;
+    int n = g->n;
+    size_t distBytes = (size_t)n * sizeof(int64_t), predBytes = (size_t)n * sizeof(int);
+    char* row = (char*)malloc(distBytes + predBytes);
+    int64_t* d = (int64_t*)row;
+    int* p = (int*)(row + distBytes);
+    IndexedHeap heap;
+    ih_init(&heap, n);
+    int64_t sum = 0;
+
+    for (int s = lo; s < hi; s++) {
+        for (int v = 0; v < n; v++) {
+            d[v] = NO_PATH;
+            p[v] = -1;
+        }
+        d[s] = 0;
+        ih_push(&heap, s, 0);
+        while (!ih_empty(&heap)) {
+            int u = ih_pop(&heap);
+            for (long a = g->offset[u]; a < g->offset[u + 1]; a++) {
+                int v = g->target[a];
+                if (d[u] + J->rw[a] < d[v]) {
+                    d[v] = d[u] + J->rw[a];
+                    p[v] = u;
+                    ih_push(&heap, v, d[v]);
+                }
+            }
+        }
+        // back to the original lengths
+        for (int v = 0; v < n; v++)
+            if (d[v] != NO_PATH) {
+                d[v] += J->h[v] - J->h[s];
+                sum += d[v];
+            }
+        if (J->dist != NULL) {
+            memcpy(J->dist + (size_t)s * n, d, distBytes);
+            memcpy(J->pred + (size_t)s * n, p, predBytes);
+        }
+        if (J->fd >= 0 && pwrite(J->fd, row, distBytes + predBytes, rowOffset(n, s)) != (ssize_t)(distBytes + predBytes))
+            J->failed = 1;
+    }
+    __atomic_fetch_add(&J->checksum, sum, __ATOMIC_RELAXED);
+    ih_free(&heap);
+    free(row);
+}
+
+// All-pairs shortest paths into dist/pred (n x n, may be NULL) and/or the
+// file `out` (may be NULL). Returns 0, -1 on a negative cycle, -2 if the
+// file cannot be written.
+int johnson(const CsrGraph* g, int64_t* dist, int* pred, const char* out, int64_t* checksum) {
+    int n = g->n;
+    int64_t* h = (int64_t*)malloc((size_t)(n > 0 ? n : 1) * sizeof(int64_t));
+    if (bellmanFord(g, h) != 0) {
+        free(h);
+        return -1;
+    }
+    int64_t* rw = (int64_t*)malloc((size_t)(g->m > 0 ? g->m : 1) * sizeof(int64_t));
+    for (int u = 0; u < n; u++)
+        for (long a = g->offset[u]; a < g->offset[u + 1]; a++)
+            rw[a] = g->weight[a] + h[u] - h[g->target[a]];
+
+    Johnson J = { g, rw, h, dist, pred, -1, 0, 0 };
+    if (out != NULL) {
+        J.fd = open(out, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        J.failed = J.fd < 0 || write(J.fd, "APSP", 4) != 4 || write(J.fd, &n, sizeof(int)) != sizeof(int);
+    }
+    if (!J.failed) {
+        double work = (double)n * (g->m + n) * 20;
+        dk_parallel_for(n, 1, work, johnsonRows, &J);
+    }
+    if (J.fd >= 0 && close(J.fd) != 0)
+        J.failed = 1;
+    if (checksum != NULL)
+        *checksum = J.checksum;
+    free(rw);
+    free(h);
+    return J.failed ? -2 : 0;
+}
+
+// Prints the path s -> t from a predecessor row
+void printRowPath(const int* predRow, int s, int t) {
+    int* stack = (int*)malloc(sizeof(int));
+    int len = 0, cap = 1;
+    for (int v = t; v != -1; v = v == s ? -1 : predRow[v]) {
+        if (len == cap) {
+            cap *= 2;
+            stack = (int*)realloc(stack, cap * sizeof(int));
+        }
+        stack[len++] = v;
+    }
+    for (int i = len - 1; i >= 0; i--)
+        printf(i ? "%d -> " : "%d\n", stack[i]);
+    free(stack);
+}
+
+// Reads row s of a file written by johnson() and prints the path to t
+int pathFromFile(const char* path, int s, int t) {
+    int fd = open(path, O_RDONLY);
+    char magic[4];
+    int n;
+    if (fd < 0 || read(fd, magic, 4) != 4 || memcmp(magic, "APSP", 4) != 0 ||
+        read(fd, &n, sizeof(int)) != sizeof(int) || s < 0 || t < 0 || s >= n || t >= n) {
+        if (fd >= 0)
+            close(fd);
+        return -1;
+    }
+    int64_t d;
+    int* predRow = (int*)malloc((size_t)n * sizeof(int));
+    off_t row = rowOffset(n, s);
+    int ok = pread(fd, &d, sizeof(d), row + (off_t)t * sizeof(int64_t)) == sizeof(d) &&
+             pread(fd, predRow, (size_t)n * sizeof(int), row + (off_t)n * sizeof(int64_t)) ==
+                 (ssize_t)((size_t)n * sizeof(int));
+    close(fd);
+    if (ok) {
+        if (d == NO_PATH) {
+            printf("No path from %d to %d\n", s, t);
+        } else {
+            printf("Distance %lld: ", (long long)d);
+            printRowPath(predRow, s, t);
+        }
+    }
+    free(predRow);
+    return ok ? 0 : -1;
+}
+
+/* ---------- Benchmark ---------- */
+double wallTime(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+void benchmark(int n, int pct) {
+    DistMatrix m = newDistMatrix(n);
+    if (m.d == NULL) {
+        printf("Not enough memory for %d vertices\n", n);
+        return;
+    }
+    unsigned long long seed = 88172645463325252ULL;
     for (int i = 0; i < n; i++)
         for (int j = 0; j < n; j++)
-            dist[i][j] = graph[i][j];
+            if (i != j && (int)(cg_rand(&seed) % 100) < pct)
+                m.d[(size_t)i * m.ld + j] = 1 + (int)(cg_rand(&seed) % 1000);
 
-    // Step 2: Consider each vertex as intermediate
-    for (int k = 0; k < n; k++) {
-        for (int i = 0; i < n; i++) {
-            for (int j = 0; j < n; j++) {
-                if (dist[i][k] + dist[k][j] < dist[i][j])
-                    dist[i][j] = dist[i][k] + dist[k][j];
-            }
+    DistMatrix ref = { n, m.ld, NULL };
+    if (n <= VERIFY_LIMIT) {
+        ref = newDistMatrix(n);
+        memcpy(ref.d, m.d, (size_t)m.ld * m.ld * sizeof(int));
+        double t = wallTime();
+        floydWarshallClassic(&ref);
+        t = wallTime() - t;
+        printf("classic:  %8.3f s  %6.2f G updates/s\n", t, (double)n * n * n / t * 1e-9);
+    }
+
+    double t = wallTime();
+    floydWarshall(&m);
+    t = wallTime() - t;
+    printf("blocked:  %8.3f s  %6.2f G updates/s  (%s, %d threads)", t, (double)n * n * n / t * 1e-9,
+           dk_has_avx2() ? "AVX2" : "scalar", dk_num_threads());
+    if (ref.d != NULL) {
+        int same = 1;
+        for (int i = 0; i < n && same; i++)
+            same = memcmp(m.d + (size_t)i * m.ld, ref.d + (size_t)i * m.ld, n * sizeof(int)) == 0;
+        printf(", %s", same ? "correct" : "MISMATCH");
+        free(ref.d);
+    }
+    printf("\n");
+    free(m.d);
+}
+
+// Fills a distance matrix with the shortest arc between each pair
+DistMatrix matrixFromGraph(const CsrGraph* g) {
+    DistMatrix m = newDistMatrix(g->n);
+    if (m.d == NULL)
+        return m;
+    for (int u = 0; u < g->n; u++)
+        for (long a = g->offset[u]; a < g->offset[u + 1]; a++) {
+            int* d = &m.d[(size_t)u * m.ld + g->target[a]];
+            if (g->weight[a] < *d)
+                *d = g->weight[a];
         }
+    return m;
+}
+
+// Johnson on a random graph with n vertices (arg is a number) or a DIMACS
+// file; checked against Floyd-Warshall when the graph is small
+void johnsonBenchmark(const char* arg, const char* out) {
+    CsrGraph g;
+    char* end;
+    long n = strtol(arg, &end, 10);
+    if (*end == '\0' && n > 0) {
+        // shifting the lengths by a potential makes some of them negative
+        // without creating a negative cycle
+        g = cg_random((int)n, 4 * n, 1000, 7);
+        int* p = (int*)malloc((size_t)n * sizeof(int));
+        unsigned long long seed = 11;
+        for (int v = 0; v < n; v++)
+            p[v] = (int)(cg_rand(&seed) % 500);
+        for (int u = 0; u < n; u++)
+            for (long a = g.offset[u]; a < g.offset[u + 1]; a++)
+                g.weight[a] += p[u] - p[g.target[a]];
+        free(p);
+    } else if (cg_read_dimacs(arg, &g) != 0) {
+        printf("Cannot read DIMACS graph %s\n", arg);
+        return;
     }
+    n = g.n;
+    printf("%ld vertices, %ld arcs\n", n, g.m);
 
-    // Step 3: Print the final result
-    printSolution(n, dist);
+    int verify = n <= VERIFY_LIMIT;
+    int64_t* dist = verify ? (int64_t*)malloc((size_t)n * n * sizeof(int64_t)) : NULL;
+    int* pred = verify ? (int*)malloc((size_t)n * n * sizeof(int)) : NULL;
+    int64_t checksum;
+    double t = wallTime();
+    int r = johnson(&g, dist, pred, out, &checksum);
+    t = wallTime() - t;
+    if (r == -1)
+        printf("The graph has a negative cycle.\n");
+    else if (r == -2)
+        printf("Cannot write %s\n", out);
+    else
+        printf("Johnson:  %8.3f s  (%d threads), sum of distances %lld\n", t, dk_num_threads(),
+               (long long)checksum);
+    if (r == 0 && out != NULL)
+        printf("rows written to %s, %.1f MB\n", out, rowOffset((int)n, (int)n) / 1e6);
+
+    if (r == 0 && verify) {
+        DistMatrix arcs = matrixFromGraph(&g);  // lightest arc u -> v, kept for the predecessor check
+        DistMatrix m = matrixFromGraph(&g);
+        t = wallTime();
+        floydWarshall(&m);
+        printf("blocked Floyd-Warshall: %8.3f s\n", wallTime() - t);
+        long bad = 0;
+        for (int i = 0; i < n; i++)
+            for (int j = 0; j < n; j++) {
+                int fw = m.d[(size_t)i * m.ld + j];
+                int64_t d = dist[(size_t)i * n + j];
+                int p = pred[(size_t)i * n + j];
+                if (UNREACHABLE(fw) ? d != NO_PATH : d != fw) {
+                    bad++;
+                } else if (i != j && d != NO_PATH) {
+                    // p -> j must be an arc that completes a shortest path
+                    if (p < 0 || p >= n || UNREACHABLE(arcs.d[(size_t)p * arcs.ld + j]) ||
+                        dist[(size_t)i * n + p] == NO_PATH)
+                        bad++;
+                    else
+                        bad += dist[(size_t)i * n + p] + arcs.d[(size_t)p * arcs.ld + j] != d;
+                }
+            }
+        printf("%s\n", bad ? "MISMATCH" : "distances and predecessors agree");
+        free(m.d);
+        free(arcs.d);
+    }
+    free(dist);
+    free(pred);
+    cg_free(&g);
 }
 
-int main() {
+int main(int argc, char** argv) {
+    if (argc > 2 && strcmp(argv[1], "--bench") == 0) {
+        benchmark(atoi(argv[2]), argc > 3 ? atoi(argv[3]) : 10);
+        return 0;
+    }
+    if (argc > 2 && strcmp(argv[1], "--johnson") == 0) {
+        johnsonBenchmark(argv[2], argc > 3 ? argv[3] : NULL);
+        return 0;
+    }
+    if (argc > 4 && strcmp(argv[1], "--path") == 0) {
+        if (pathFromFile(argv[2], atoi(argv[3]), atoi(argv[4])) != 0)
+            printf("Cannot read a path from %s\n", argv[2]);
+        return 0;
+    }
+
     int n, e;
     printf("Enter number of vertices: ");
     scanf("%d", &n);
     printf("Enter number of edges: ");
     scanf("%d", &e);
 
-    int graph[n][n];
-
-    // Initialize all distances to INF and 0 for self-loops
-    for (int i = 0; i < n; i++)
-        for (int j = 0; j < n; j++)
-            graph[i][j] = (i == j) ? 0 : INF;
+    CgEdge* edges = (CgEdge*)malloc((size_t)(e > 0 ? e : 1) * sizeof(CgEdge));
+    int m = 0;
 
     printf("\nEnter edges in the format: source destination weight\n");
     printf("(Vertices are numbered from 0 to %d)\n", n - 1);
@@ -56,9 +587,64 @@ int main() {
     for (int i = 0; i < e; i++) {
         int u, v, w;
         scanf("%d %d %d", &u, &v, &w);
-        graph[u][v] = w;  // directed edge
+        if (u < 0 || v < 0 || u >= n || v >= n) {
+            printf("Edge %d %d skipped: no such vertex\n", u, v);
+            continue;
+        }
+        edges[m++] = (CgEdge){ u, v, w };  // directed edge
+    }
+    CsrGraph g = cg_from_edges(n, m, edges, 0);
+    free(edges);
+
+    int choice;
+    printf("\n1. Floyd-Warshall (dense graphs)\n2. Johnson (sparse graphs, with paths)\n");
+    printf("Enter your choice: ");
+    scanf("%d", &choice);
+
+    if (choice == 2) {
+        int64_t* dist = (int64_t*)malloc((size_t)n * n * sizeof(int64_t));
+        int* pred = (int*)malloc((size_t)n * n * sizeof(int));
+        if (johnson(&g, dist, pred, NULL, NULL) != 0) {
+            printf("\nThe graph has a negative cycle; distances are not defined.\n");
+        } else {
+            printf("\nShortest distances between every pair of vertices:\n");
+            for (int i = 0; i < n; i++) {
+                for (int j = 0; j < n; j++) {
+                    if (dist[(size_t)i * n + j] == NO_PATH)
+                        printf("%7s", "INF");
+                    else
+                        printf("%7lld", (long long)dist[(size_t)i * n + j]);
+                }
+                printf("\n");
+            }
+            int s, t;
+            printf("\nEnter source and destination for a path (-1 -1 to stop): ");
+            while (scanf("%d %d", &s, &t) == 2 && s >= 0 && s < n && t >= 0 && t < n) {
+                if (dist[(size_t)s * n + t] == NO_PATH)
+                    printf("No path from %d to %d\n", s, t);
+                else
+                    printRowPath(pred + (size_t)s * n, s, t);
+                printf("Enter source and destination for a path (-1 -1 to stop): ");
+            }
+        }
+        free(dist);
+        free(pred);
+        cg_free(&g);
+        return 0;
+    }
+
+    // All distances INF, 0 for self-loops; of parallel edges the shortest counts
+    DistMatrix graph = matrixFromGraph(&g);
+    cg_free(&g);
+    if (graph.d == NULL) {
+        printf("Not enough memory\n");
+        return 1;
     }
 
-    floydWarshall(n, graph);
+    if (floydWarshall(&graph))
+        printf("\nThe graph has a negative cycle; distances are not defined.\n");
+    else
+        printSolution(&graph);
+    free(graph.d);
     return 0;
 }
@@ -0,0 +1,656 @@
+/*
+   Contraction hierarchies (Geisberger et al.) on top of dijkstra_alg.c.
+
+   Preprocessing contracts the vertices one at a time, least important
+   first. Contracting v removes it from the graph; for every pair of
+   neighbours u -> v -> w a shortcut u -> w of length d(u,v) + d(v,w) is
+   added unless a witness search (a small Dijkstra from u that avoids v)
+   finds a path that is no longer. The importance of a vertex is its edge
+   difference (shortcuts added minus arcs removed) plus the number of its
+   neighbours already contracted plus its level in the hierarchy; it is
+   kept in a heap and refreshed lazily.
+
+   A query runs Dijkstra forward from s and backward from t, each going
+   only to higher-ranked vertices, and the shortest path meets at its
+   highest vertex. Both searches are tiny, and a vertex that can be reached
+   more cheaply from above is stalled rather than expanded, so a query
+   takes microseconds where plain Dijkstra takes milliseconds. Shortcuts
+   remember their middle vertex, so a path can be unpacked into original
+   arcs. This pays off on road-like graphs; on random graphs the last
+   vertices to be contracted form a dense core and preprocessing is slow.
+
+   The hierarchy is saved as "CH01", n, rank[n], then the upward and the
+   (reversed) downward graph, each as m, offset[n+1], target[m],
+   weight[m], mid[m].
+
+   Usage:
+       gcc -O2 contraction_hierarchy.c -o ch -pthread -lm
+       ./ch                                interactive
+       ./ch --bench N [file.gr]            grid of about N vertices or a
+                                           DIMACS graph; the hierarchy is
+                                           kept in <file>.ch / grid<side>.ch
+*/
+#define main dijkstraMain
+#include "dijkstra_alg.c"
+#undef main
+
+#define WITNESS_LIMIT 500      // vertices a witness search may settle
+#define ESTIMATE_LIMIT 40      // the same when only estimating importance
+
+typedef struct {
+    int v, w, mid;      // other end, length, middle vertex (-1: original arc)
+} ChArc;
+
+typedef struct {
+    ChArc* a;
+    int size, cap;
+} ArcList;
+
+typedef struct {
+    int n;
+    int* rank;
+    CsrGraph up;        // u -> w with rank[u] < rank[w]
+    CsrGraph down;      // w -> u for every arc u -> w with rank[u] > rank[w]
+    int* upMid;
+    int* downMid;
+} ContractionHierarchy;
+
+/* ---------- Preprocessing ---------- */
+typedef struct {
+    int n;
+    ArcList* out;       // arcs between vertices that are not contracted yet
+    ArcList* in;
+    int* deleted;       // contracted neighbours
+    int* level;
+    // witness search workspace
+    int64_t* dist;
+    int* touched;
+    int ntouched;
+    char* isTarget;     // out-neighbours of the vertex being contracted
+    IndexedHeap heap;
+    long shortcuts;
+} Contractor;
+
+void arcPush(ArcList* l, ChArc a) {
+    if (l->size == l->cap) {
+        l->cap = l->cap ? 2 * l->cap : 4;
+        l->a = (ChArc*)realloc(l->a, l->cap * sizeof(ChArc));
+    }
+    l->a[l->size++] = a;
+}
+
+void arcRemove(ArcList* l, int v) {
+    for (int i = 0; i < l->size; i++)
+        if (l->a[i].v == v) {
+            l->a[i] = l->a[--l->size];
+            return;
+        }
+}
+
+ChArc* arcFind(ArcList* l, int v) {
+    for (int i = 0; i < l->size; i++)
+        if (l->a[i].v == v)
+            return &l->a[i];
+    return NULL;
+}
+
+// Adds u -> w or shortens an existing arc; parallel arcs are merged
+void addArc(Contractor* c, int u, int w, int len, int mid) {
+    ChArc* a = arcFind(&c->out[u], w);
+    if (a != NULL) {
+        if (len < a->w) {
+            a->w = len;
+            a->mid = mid;
+            ChArc* b = arcFind(&c->in[w], u);
+            b->w = len;
+            b->mid = mid;
+        }
+        return;
+    }
+    arcPush(&c->out[u], (ChArc){ w, len, mid });
+    arcPush(&c->in[w], (ChArc){ u, len, mid });
+}
+
+// Distances from u in the remaining graph without `skip`. Stops once all
+// targets are settled, the distance passes maxDist or `limit` vertices
+// are settled; dist[] is then an upper bound, which is safe for a witness.
+void witnessSearch(Contractor* c, int u, int skip, int64_t maxDist, int targets, int limit) {
+    for (int i = 0; i < c->ntouched; i++)
+        c->dist[c->touched[i]] = INF;
+    ih_clear(&c->heap);
+    c->ntouched = 0;
+    c->dist[u] = 0;
+    c->touched[c->ntouched++] = u;
+    ih_push(&c->heap, u, 0);
+    for (int settled = 0; !ih_empty(&c->heap) && settled < limit; settled++) {
+        if (ih_min_key(&c->heap) > maxDist)
+            break;
+        int x = ih_pop(&c->heap);
+        if (c->isTarget[x] && --targets == 0)
+            break;
+        ArcList* l = &c->out[x];
+        for (int i = 0; i < l->size; i++) {
+            int y = l->a[i].v;
+            int64_t nd = c->dist[x] + l->a[i].w;
+            if (y == skip || nd >= c->dist[y])
+                continue;
+            if (c->dist[y] == INF)
+                c->touched[c->ntouched++] = y;
+            c->dist[y] = nd;
+            ih_push(&c->heap, y, nd);
+        }
+    }
+}
+
+// Shortcuts needed to contract v; adds them when `apply` is set
+int contractVertex(Contractor* c, int v, int apply) {
+    ArcList *in = &c->in[v], *out = &c->out[v];
+    int needed = 0;
+    int maxOut = 0;
+    for (int j = 0; j < out->size; j++) {
+        c->isTarget[out->a[j].v] = 1;
+        if (out->a[j].w > maxOut)
+            maxOut = out->a[j].w;
+    }
+    for (int i = 0; i < in->size; i++) {
+        int u = in->a[i].v;
+        witnessSearch(c, u, v, (int64_t)in->a[i].w + maxOut, out->size, apply ? WITNESS_LIMIT : ESTIMATE_LIMIT);
+        for (int j = 0; j < out->size; j++) {
+            int w = out->a[j].v;
+            int64_t len = (int64_t)in->a[i].w + out->a[j].w;
+            if (w == u || c->dist[w] <= len)
+                continue;  // a witness path is at least as short
+            needed++;
+            if (apply)
+                addArc(c, u, w, (int)len, v);
+        }
+    }
+    for (int j = 0; j < out->size; j++)
+        c->isTarget[out->a[j].v] = 0;
+    return needed;
+}
+
+int64_t importance(Contractor* c, int v) {
+    int edgeDiff = contractVertex(c, v, 0) - c->in[v].size - c->out[v].size;
+    return 2 * (int64_t)edgeDiff + c->deleted[v] + c->level[v];
+}
+
+// Copies one half of the hierarchy into a CSR graph with a parallel mid[]
+void buildLevelGraph(const ArcList* lists, int n, CsrGraph* g, int** mid) {
+    g->n = n;
+    g->offset = (long*)malloc((size_t)(n + 1) * sizeof(long));
+    g->offset[0] = 0;
+    for (int u = 0; u < n; u++)
+        g->offset[u + 1] = g->offset[u] + lists[u].size;
+    g->m = g->offset[n];
+    g->target = (int*)malloc((g->m > 0 ? g->m : 1) * sizeof(int));
+    g->weight = (int*)malloc((g->m > 0 ? g->m : 1) * sizeof(int));
+    *mid = (int*)malloc((g->m > 0 ? g->m : 1) * sizeof(int));
+    for (int u = 0; u < n; u++)
+        for (int i = 0; i < lists[u].size; i++) {
+            long a = g->offset[u] + i;
+            g->target[a] = lists[u].a[i].v;
+            g->weight[a] = lists[u].a[i].w;
+            (*mid)[a] = lists[u].a[i].mid;
+        }
+}
+
+ContractionHierarchy buildHierarchy(const CsrGraph* g) {
+    int n = g->n;
+    Contractor c;
+    memset(&c, 0, sizeof(c));
+    c.n = n;
+    c.out = (ArcList*)calloc(n, sizeof(ArcList));
+    c.in = (ArcList*)calloc(n, sizeof(ArcList));
+    c.deleted = (int*)calloc(n, sizeof(int));
+    c.level = (int*)calloc(n, sizeof(int));
+    c.dist = (int64_t*)malloc((size_t)n * sizeof(int64_t));
+    c.touched = (int*)malloc((size_t)n * sizeof(int));
+    c.isTarget = (char*)calloc(n, 1);
+    for (int v = 0; v < n; v++)
+        c.dist[v] = INF;
+    ih_init(&c.heap, n);
+    for (int u = 0; u < n; u++)
+        for (long a = g->offset[u]; a < g->offset[u + 1]; a++)
+            if (g->target[a] != u)
+                addArc(&c, u, g->target[a], g->weight[a], -1);
+
+    // the finished hierarchy: upward arcs by tail, downward arcs by head
+    ArcList* up = (ArcList*)calloc(n, sizeof(ArcList));
+    ArcList* down = (ArcList*)calloc(n, sizeof(ArcList));
+    ContractionHierarchy ch;
+    ch.n = n;
+    ch.rank = (int*)malloc((size_t)n * sizeof(int));
+
+    IndexedHeap order;
+    ih_init(&order, n);
+    for (int v = 0; v < n; v++)
+        ih_push(&order, v, importance(&c, v));
+
+    int next = 0;
+    while (!ih_empty(&order)) {
+        int v = ih_pop(&order);
+        int64_t prio = importance(&c, v);
+        if (!ih_empty(&order) && prio > ih_min_key(&order)) {
+            ih_push(&order, v, prio);  // lazy update: not the minimum any more
+            continue;
+        }
+        c.shortcuts += contractVertex(&c, v, 1);
+        ch.rank[v] = next++;
+
+        // v's remaining arcs all lead to higher-ranked vertices
+        for (int i = 0; i < c.out[v].size; i++) {
+            ChArc a = c.out[v].a[i];
+            arcPush(&up[v], a);
+            arcRemove(&c.in[a.v], v);
+        }
+        for (int i = 0; i < c.in[v].size; i++) {
+            ChArc a = c.in[v].a[i];
+            arcPush(&down[v], a);
+            arcRemove(&c.out[a.v], v);
+        }
+        for (int pass = 0; pass < 2; pass++) {
+            ArcList* l = pass ? &c.in[v] : &c.out[v];
+            for (int i = 0; i < l->size; i++) {
+                int x = l->a[i].v;
+                c.deleted[x]++;
+                if (c.level[x] < c.level[v] + 1)
+                    c.level[x] = c.level[v] + 1;
+                if (ih_contains(&order, x))
+                    ih_update(&order, x, importance(&c, x));
+            }
+        }
+        free(c.out[v].a);
+        free(c.in[v].a);
+        c.out[v] = c.in[v] = (ArcList){ NULL, 0, 0 };
+    }
+
+    buildLevelGraph(up, n, &ch.up, &ch.upMid);
+    buildLevelGraph(down, n, &ch.down, &ch.downMid);
+    for (int v = 0; v < n; v++) {
+        free(up[v].a);
+        free(down[v].a);
+    }
+    free(up);
+    free(down);
+    ih_free(&order);
+    ih_free(&c.heap);
+    free(c.out);
+    free(c.in);
+    free(c.deleted);
+    free(c.level);
+    free(c.dist);
+    free(c.touched);
+    free(c.isTarget);
+    return ch;
+}
+
+void hierarchyFree(ContractionHierarchy* ch) {
+    free(ch->rank);
+    cg_free(&ch->up);
+    cg_free(&ch->down);
+    free(ch->upMid);
+    free(ch->downMid);
+}
+
+/* ---------- File format ---------- */
+int writeLevelGraph(FILE* f, const CsrGraph* g, const int* mid) {
+    return fwrite(&g->m, sizeof(long), 1, f) == 1 &&
+           fwrite(g->offset, sizeof(long), g->n + 1, f) == (size_t)g->n + 1 &&
+           fwrite(g->target, sizeof(int), g->m, f) == (size_t)g->m &&
+           fwrite(g->weight, sizeof(int), g->m, f) == (size_t)g->m &&
+           fwrite(mid, sizeof(int), g->m, f) == (size_t)g->m;
+}
+
+int readLevelGraph(FILE* f, int n, CsrGraph* g, int** mid) {
+    g->n = n;
+    if (fread(&g->m, sizeof(long), 1, f) != 1 || g->m < 0)
+        return 0;
+    g->offset = (long*)malloc((size_t)(n + 1) * sizeof(long));
+    g->target = (int*)malloc((g->m > 0 ? g->m : 1) * sizeof(int));
+    g->weight = (int*)malloc((g->m > 0 ? g->m : 1) * sizeof(int));
+    *mid = (int*)malloc((g->m > 0 ? g->m : 1) * sizeof(int));
+    return fread(g->offset, sizeof(long), n + 1, f) == (size_t)n + 1 &&
+           fread(g->target, sizeof(int), g->m, f) == (size_t)g->m &&
+           fread(g->weight, sizeof(int), g->m, f) == (size_t)g->m &&
+           fread(*mid, sizeof(int), g->m, f) == (size_t)g->m;
+}
+
+int saveHierarchy(const ContractionHierarchy* ch, const char* path) {
+    FILE* f = fopen(path, "wb");
+    if (f == NULL)
+        return -1;
+    int ok = fwrite("CH01", 1, 4, f) == 4 && fwrite(&ch->n, sizeof(int), 1, f) == 1 &&
+             fwrite(ch->rank, sizeof(int), ch->n, f) == (size_t)ch->n &&
+             writeLevelGraph(f, &ch->up, ch->upMid) && writeLevelGraph(f, &ch->down, ch->downMid);
+    return fclose(f) == 0 && ok ? 0 : -1;
+}
+
+// Loads a hierarchy for a graph with n vertices (n < 0: any); 0 on success
+int loadHierarchy(ContractionHierarchy* ch, const char* path, int n) {
+    FILE* f = fopen(path, "rb");
+    if (f == NULL)
+        return -1;
+    char magic[4];
+    if (fread(magic, 1, 4, f) != 4 || memcmp(magic, "CH01", 4) != 0 ||
+        fread(&ch->n, sizeof(int), 1, f) != 1 || ch->n <= 0 || (n >= 0 && ch->n != n)) {
+        fclose(f);
+        return -1;
+    }
+    memset(&ch->up, 0, sizeof(CsrGraph));
+    memset(&ch->down, 0, sizeof(CsrGraph));
+    ch->upMid = ch->downMid = NULL;
+    ch->rank = (int*)malloc((size_t)ch->n * sizeof(int));
+    int ok = fread(ch->rank, sizeof(int), ch->n, f) == (size_t)ch->n &&
+             readLevelGraph(f, ch->n, &ch->up, &ch->upMid) &&
+             readLevelGraph(f, ch->n, &ch->down, &ch->downMid);
+    fclose(f);
+    if (!ok)
+        hierarchyFree(ch);
+    return ok ? 0 : -1;
+}
+
+/* ---------- Query ---------- */
+typedef struct {
+    const ContractionHierarchy* ch;
+    Dijkstra fwd, bwd;      // on ch->up and ch->down
+    int meet;
+    long settled;
+} ChQuery;
+
+void chQueryInit(ChQuery* q, const ContractionHierarchy* ch) {
+    q->ch = ch;
+    dijkstraInit(&q->fwd, &ch->up);
+    dijkstraInit(&q->bwd, &ch->down);
+    q->meet = -1;
+}
+
+void chQueryFree(ChQuery* q) {
+    dijkstraFree(&q->fwd);
+    dijkstraFree(&q->bwd);
+}
+
+// Settles one vertex of d. `into` holds the arcs entering each vertex
+// from above in d's direction: if one of them gives a shorter way to u,
+// u is not on a shortest up-path and is stalled instead of relaxed.
+void chSettle(ChQuery* q, Dijkstra* d, const Dijkstra* other, const CsrGraph* into, int64_t* mu) {
+    const CsrGraph* g = d->g;
+    int u = ih_pop(&d->heap);
+    d->settled++;
+    int64_t du = d->dist[u];
+    if (other->dist[u] != INF && du + other->dist[u] < *mu) {
+        *mu = du + other->dist[u];
+        q->meet = u;
+    }
+    for (long a = into->offset[u]; a < into->offset[u + 1]; a++) {
+        int x = into->target[a];
+        if (d->dist[x] != INF && d->dist[x] + into->weight[a] < du)
+            return;
+    }
+    for (long a = g->offset[u]; a < g->offset[u + 1]; a++) {
+        int v = g->target[a];
+        int64_t nd = du + g->weight[a];
+        if (nd >= d->dist[v])
+            continue;
+        if (d->dist[v] == INF)
+            d->touched[d->ntouched++] = v;
+        d->dist[v] = nd;
+        d->pred[v] = u;
+        ih_push(&d->heap, v, nd);
+    }
+}
+
+// Length of a shortest s-t path, INF if none. Neither search can stop at
+// the first meeting: each runs until its smallest key reaches mu.
+int64_t chQuery(ChQuery* q, int s, int t) {
+    int64_t mu = INF;
+    q->meet = -1;
+    dijkstraReset(&q->fwd, s, 0);
+    dijkstraReset(&q->bwd, t, 0);
+    for (int side = 0;; side ^= 1) {
+        int fwdLive = !ih_empty(&q->fwd.heap) && ih_min_key(&q->fwd.heap) < mu;
+        int bwdLive = !ih_empty(&q->bwd.heap) && ih_min_key(&q->bwd.heap) < mu;
+        if (!fwdLive && !bwdLive)
+            break;
+        if ((side == 0 && fwdLive) || !bwdLive)
+            chSettle(q, &q->fwd, &q->bwd, &q->ch->down, &mu);
+        else
+            chSettle(q, &q->bwd, &q->fwd, &q->ch->up, &mu);
+    }
+    q->settled = q->fwd.settled + q->bwd.settled;
+    return mu;
+}
+
+// Middle vertex of the arc x -> y in the hierarchy (-1: original arc)
+int arcMid(const ContractionHierarchy* ch, int x, int y) {
+    const CsrGraph* g = ch->rank[x] < ch->rank[y] ? &ch->up : &ch->down;
+    const int* mid = ch->rank[x] < ch->rank[y] ? ch->upMid : ch->downMid;
+    int from = ch->rank[x] < ch->rank[y] ? x : y, to = from == x ? y : x;
+    for (long a = g->offset[from]; a < g->offset[from + 1]; a++)
+        if (g->target[a] == to)
+            return mid[a];
+    return -1;
+}
+
+// Writes the path of the last query as original vertices; returns its
+// length (0 if t was not reached). Shortcuts are expanded with a stack.
+int chPath(const ChQuery* q, int* path) {
+    if (q->meet < 0)
+        return 0;
+    const ContractionHierarchy* ch = q->ch;
+    int nhops = 0, len = 0, top = 0;
+    for (int x = q->meet; x != -1; x = q->fwd.pred[x])
+        nhops++;
+    for (int x = q->bwd.pred[q->meet]; x != -1; x = q->bwd.pred[x])
+        nhops++;
+    int* hops = (int*)malloc(nhops * sizeof(int));
+    int i = 0;
+    for (int x = q->meet; x != -1; x = q->fwd.pred[x])
+        hops[i++] = x;
+    for (int a = 0, b = i - 1; a < b; a++, b--) {
+        int tmp = hops[a];
+        hops[a] = hops[b];
+        hops[b] = tmp;
+    }
+    for (int x = q->bwd.pred[q->meet]; x != -1; x = q->bwd.pred[x])
+        hops[i++] = x;
+
+    int cap = 64;
+    int(*stack)[2] = malloc(cap * sizeof(*stack));
+    path[len++] = hops[0];
+    for (i = 0; i + 1 < nhops; i++) {
+        stack[top][0] = hops[i];
+        stack[top][1] = hops[i + 1];
+        top++;
+        while (top > 0) {
+            int x = stack[top - 1][0], y = stack[top - 1][1];
+            top--;
+            int m = arcMid(ch, x, y);
+            if (m < 0) {
+                path[len++] = y;
+                continue;
+            }
+            if (top + 2 > cap) {
+                cap *= 2;
+                stack = realloc(stack, cap * sizeof(*stack));
+            }
+            stack[top][0] = m;      // m -> y is expanded after x -> m
+            stack[top][1] = y;
+            stack[top + 1][0] = x;
+            stack[top + 1][1] = m;
+            top += 2;
+        }
+    }
+    free(stack);
+    free(hops);
+    return len;
+}
+
+/* ---------- Benchmark and menu ---------- */
+void chBenchmark(int n, const char* file) {
+    CsrGraph g;
+    char chFile[512];
+    if (file != NULL) {
+        if (cg_read_dimacs(file, &g) != 0) {
+            printf("Cannot read DIMACS graph %s\n", file);
+            return;
+        }
+        snprintf(chFile, sizeof(chFile), "%s.ch", file);
+    } else {
+        int side = (int)sqrt((double)n);
+        g = cg_grid(side, side, 1000, 42);
+        snprintf(chFile, sizeof(chFile), "grid%d.ch", side);
+    }
+    printf("%d vertices, %ld arcs\n", g.n, g.m);
+
+    ContractionHierarchy ch;
+    double t = wallTime();
+    if (loadHierarchy(&ch, chFile, g.n) == 0) {
+        printf("loaded hierarchy from %s in %.3f s\n", chFile, wallTime() - t);
+    } else {
+        ch = buildHierarchy(&g);
+        printf("contracted in %.3f s: %ld upward + %ld downward arcs (graph has %ld)", wallTime() - t,
+               ch.up.m, ch.down.m, g.m);
+        printf(saveHierarchy(&ch, chFile) == 0 ? ", saved to %s\n" : ", could not save %s\n", chFile);
+    }
+
+    CsrGraph rev = cg_reverse(&g);
+    PointToPoint p;
+    p2pInit(&p, &g, &rev, NULL);
+    ChQuery q;
+    chQueryInit(&q, &ch);
+    int queries = 200, wrong = 0;
+    int* path = (int*)malloc((size_t)g.n * sizeof(int));
+    unsigned long long seed = 99;
+    double tDijkstra = 0, tBidir = 0, tCh = 0;
+    long sDijkstra = 0, sBidir = 0, sCh = 0;
+    for (int i = 0; i < queries; i++) {
+        int s = (int)(cg_rand(&seed) % g.n), tg = (int)(cg_rand(&seed) % g.n);
+        double a = wallTime();
+        int64_t ref = p2pQuery(&p, s, tg, P2P_DIJKSTRA);
+        double b = wallTime();
+        sDijkstra += p.settled;
+        p2pQuery(&p, s, tg, P2P_BIDIRECTIONAL);
+        double c = wallTime();
+        sBidir += p.settled;
+        int64_t d = chQuery(&q, s, tg);
+        double e = wallTime();
+        sCh += q.settled;
+        tDijkstra += b - a;
+        tBidir += c - b;
+        tCh += e - c;
+        // the unpacked path must start at s, end at t and have length d
+        int len = chPath(&q, path);
+        int64_t sum = 0;
+        for (int k = 0; k + 1 < len; k++) {
+            int64_t best = INF;
+            for (long arc = g.offset[path[k]]; arc < g.offset[path[k] + 1]; arc++)
+                if (g.target[arc] == path[k + 1] && g.weight[arc] < best)
+                    best = g.weight[arc];
+            sum = best == INF || sum == INF ? INF : sum + best;
+        }
+        wrong += d != ref || (d != INF && (len == 0 || path[0] != s || path[len - 1] != tg || sum != d));
+    }
+    printf("%-16s %12s %10s\n", "query", "time (us)", "settled");
+    printf("%-16s %12.1f %10.0f\n", "Dijkstra", tDijkstra * 1e6 / queries, (double)sDijkstra / queries);
+    printf("%-16s %12.1f %10.0f\n", "bidirectional", tBidir * 1e6 / queries, (double)sBidir / queries);
+    printf("%-16s %12.1f %10.0f\n", "CH", tCh * 1e6 / queries, (double)sCh / queries);
+    printf("%s\n", wrong ? "WRONG DISTANCES OR PATHS" : "all distances and unpacked paths agree");
+    free(path);
+    chQueryFree(&q);
+    p2pFree(&p);
+    hierarchyFree(&ch);
+    cg_free(&rev);
+    cg_free(&g);
+}
+
+int main(int argc, char** argv) {
+    if (argc > 2 && strcmp(argv[1], "--bench") == 0) {
+        chBenchmark(atoi(argv[2]), argc > 3 ? argv[3] : NULL);
+        return 0;
+    }
+
+    CsrGraph g = { 0 };
+    ContractionHierarchy ch;
+    ChQuery q;
+    int built = 0, choice, s, t;
+    char file[512];
+    int* path = NULL;
+
+    while (1) {
+        printf("\n--- Contraction Hierarchies ---\n");
+        printf("1. Build from DIMACS file\n2. Load hierarchy file\n3. Save hierarchy file\n");
+        printf("4. Shortest path query\n5. Exit\n");
+        printf("Enter your choice: ");
+        if (scanf("%d", &choice) != 1)
+            break;
+        switch (choice) {
+            case 1:
+            case 2:
+                printf(choice == 1 ? "Enter .gr file: " : "Enter .ch file: ");
+                scanf("%511s", file);
+                if (built) {
+                    chQueryFree(&q);
+                    hierarchyFree(&ch);
+                    built = 0;
+                }
+                if (choice == 1) {
+                    if (cg_read_dimacs(file, &g) != 0) {
+                        printf("Cannot read %s\n", file);
+                        break;
+                    }
+                    ch = buildHierarchy(&g);
+                    cg_free(&g);
+                } else if (loadHierarchy(&ch, file, -1) != 0) {
+                    printf("Cannot load %s\n", file);
+                    break;
+                }
+                chQueryInit(&q, &ch);
+                path = (int*)realloc(path, (size_t)ch.n * sizeof(int));
+                built = 1;
+                printf("%d vertices, %ld + %ld arcs in the hierarchy\n", ch.n, ch.up.m, ch.down.m);
+                break;
+            case 3:
+                if (!built) {
+                    printf("Nothing built yet.\n");
+                    break;
+                }
+                printf("Enter .ch file: ");
+                scanf("%511s", file);
+                printf(saveHierarchy(&ch, file) == 0 ? "Saved.\n" : "Cannot write file.\n");
+                break;
+            case 4:
+                if (!built) {
+                    printf("Nothing built yet.\n");
+                    break;
+                }
+                printf("Enter source and target (1-based, as in the .gr file): ");
+                scanf("%d %d", &s, &t);
+                if (s < 1 || t < 1 || s > ch.n || t > ch.n) {
+                    printf("Invalid vertex.\n");
+                    break;
+                }
+                int64_t d = chQuery(&q, s - 1, t - 1);
+                if (d == INF) {
+                    printf("No path.\n");
+                    break;
+                }
+                printf("Distance %lld, path:", (long long)d);
+                int len = chPath(&q, path);
+                for (int i = 0; i < len; i++)
+                    printf(" %d", path[i] + 1);
+                printf("\n");
+                break;
+            case 5:
+                if (built) {
+                    chQueryFree(&q);
+                    hierarchyFree(&ch);
+                }
+                free(path);
+                return 0;
+            default:
+                printf("Invalid choice!\n");
+        }
+    }
+    return 0;
+}
@@ -1,13 +1,51 @@
+/*
+   Dijkstra's single-source shortest paths.
+
+   dijkstraMatrix is the classic O(V^2) version: it scans an adjacency
+   matrix for the closest unvisited vertex on every step. dijkstraRun works
+   on a CSR graph (common/csr_graph.h) with a 4-ary indexed heap, so it
+   takes O(E log V) time and O(V + E) memory, records predecessors for path
+   reconstruction, and can stop as soon as a given target is settled. Its
+   arrays are kept between queries and only the entries a query touched are
+   reset, so a short point-to-point query does not pay O(V).
+   deltaStepping computes the same distances with several threads.
+   p2pQuery answers one-to-one queries with bidirectional search and ALT.
+
+   Usage:
+       gcc -O2 dijkstra_alg.c -o dijkstra -pthread -lm
+       ./dijkstra                          interactive (adjacency matrix)
+       ./dijkstra --bench N [file.gr]      grid of about N vertices, or a
+                                           DIMACS road graph; compares with
+                                           the O(V^2) version when V <= 8000
+                                           and with delta-stepping on 1, 2,
+                                           4, ... threads up to the core count
+       ./dijkstra --p2p N [k] [file.gr]    point-to-point queries: Dijkstra,
+                                           bidirectional, ALT and bidirectional
+                                           ALT with k landmarks (default 16),
+                                           kept in <file>.alt / grid<side>.alt
+*/
 #include <stdio.h>
-#define MAX 100
-#define INF 99999
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <pthread.h>
+#include <unistd.h>
+#include "../../common/csr_graph.h"
+#include "../../common/indexed_heap.h"
+
+#define INF INT64_MAX  // distance of an unreachable vertex
+#define DENSE_LIMIT 8000
 
 int V; // number of vertices
 
-int minDistance(int dist[], int visited[]) {
-    int min = INF, min_index;
+/* ---------- O(V^2) version on an adjacency matrix ---------- */
+int minDistance(int64_t dist[], int visited[]) {
+    int64_t min = INF;
+    int min_index = -1;
     for (int v = 0; v < V; v++) {
-        if (!visited[v] && dist[v] <= min) {
+        if (!visited[v] && dist[v] < min) {
             min = dist[v];
             min_index = v;
         }
@@ -15,9 +53,9 @@ int minDistance(int dist[], int visited[]) {
     return min_index;
 }
 
-void dijkstra(int graph[MAX][MAX], int src) {
-    int dist[MAX];
-    int visited[MAX] = {0};
+// graph is V x V, row-major; 0 means no edge
+void dijkstraMatrix(const int* graph, int src, int64_t dist[]) {
+    int* visited = (int*)calloc(V, sizeof(int));
 
     for (int i = 0; i < V; i++)
         dist[i] = INF;
@@ -25,33 +63,818 @@ void dijkstra(int graph[MAX][MAX], int src) {
 
     for (int count = 0; count < V - 1; count++) {
         int u = minDistance(dist, visited);
+        if (u < 0)
+            break;  // the rest is unreachable
         visited[u] = 1;
 
         for (int v = 0; v < V; v++) {
-            if (!visited[v] && graph[u][v] && dist[u] + graph[u][v] < dist[v])
-                dist[v] = dist[u] + graph[u][v];
+            int w = graph[(long)u * V + v];
+            if (!visited[v] && w && dist[u] + w < dist[v])
+                dist[v] = dist[u] + w;
         }
     }
+    free(visited);
+}
 
-    printf("Vertex \t Distance from Source\n");
-    for (int i = 0; i < V; i++)
-        printf("%d \t %d\n", i, dist[i]);
+/* ---------- Heap-based version on CSR adjacency ---------- */
+typedef struct {
+    const CsrGraph* g;
+    int64_t* dist;      // INF where not reached
+    int* pred;          // previous vertex on a shortest path, -1 at the source
+    IndexedHeap heap;
+    int* touched;       // vertices whose dist was set by the last query
+    int ntouched;
+    long settled;       // vertices settled by the last query
+} Dijkstra;
+
+void dijkstraInit(Dijkstra* d, const CsrGraph* g) {
+    d->g = g;
+    d->dist = (int64_t*)malloc((size_t)g->n * sizeof(int64_t));
+    d->pred = (int*)malloc((size_t)g->n * sizeof(int));
+    d->touched = (int*)malloc((size_t)g->n * sizeof(int));
+    for (int v = 0; v < g->n; v++)
+        d->dist[v] = INF;
+    ih_init(&d->heap, g->n);
+    d->ntouched = 0;
+    d->settled = 0;
+}
+
+void dijkstraFree(Dijkstra* d) {
+    free(d->dist);
+    free(d->pred);
+    free(d->touched);
+    ih_free(&d->heap);
+}
+
+// Undoes the previous query and starts a new one at src with heap key `key`
+void dijkstraReset(Dijkstra* d, int src, int64_t key) {
+    for (int i = 0; i < d->ntouched; i++)
+        d->dist[d->touched[i]] = INF;
+    ih_clear(&d->heap);
+    d->ntouched = 0;
+    d->settled = 0;
+
+    d->dist[src] = 0;
+    d->pred[src] = -1;
+    d->touched[d->ntouched++] = src;
+    ih_push(&d->heap, src, key);
+}
+
+// Shortest paths from src. With target >= 0 the search stops once target
+// is settled; dist is then exact only for settled vertices. Returns
+// dist[target] (or 0 when target < 0).
+int64_t dijkstraRun(Dijkstra* d, int src, int target) {
+    const CsrGraph* g = d->g;
+    dijkstraReset(d, src, 0);
+
+    while (!ih_empty(&d->heap)) {
+        int u = ih_pop(&d->heap);
+        d->settled++;
+        if (u == target)
+            break;
+        int64_t du = d->dist[u];
+        for (long a = g->offset[u]; a < g->offset[u + 1]; a++) {
+            int v = g->target[a];
+            int64_t nd = du + g->weight[a];
+            if (nd < d->dist[v]) {
+                if (d->dist[v] == INF)
+                    d->touched[d->ntouched++] = v;
+                d->dist[v] = nd;
+                d->pred[v] = u;
+                ih_push(&d->heap, v, nd);
+            }
+        }
+    }
+    return target >= 0 ? d->dist[target] : 0;
+}
+
+// Prints src -> ... -> v by following pred (iteratively, paths can be long)
+void printPath(const Dijkstra* d, int v) {
+    int len = 0;
+    for (int x = v; x != -1; x = d->pred[x])
+        len++;
+    int* path = (int*)malloc(len * sizeof(int));
+    for (int x = v, i = len - 1; x != -1; x = d->pred[x], i--)
+        path[i] = x;
+    for (int i = 0; i < len; i++)
+        printf(i ? " -> %d" : "%d", path[i]);
+    free(path);
+}
+
+/* ---------- Point-to-point queries: bidirectional search and ALT ----------
+   A bidirectional query grows one search forward from s and one backward
+   from t over the reversed graph, and stops when the two smallest keys
+   together reach the best s-t path seen so far (mu).
+
+   ALT (Goldberg and Harrelson) adds A* lower bounds from landmarks: for a
+   landmark L the triangle inequality gives
+       d(v, t) >= d(L, t) - d(L, v)   and   d(v, t) >= d(v, L) - d(t, L),
+   and the best of these over all landmarks steers the search towards t.
+   The bidirectional version uses the average potential
+   p(v) = (pi_t(v) - pi_s(v)) / 2 forward and -p(v) backward, which keeps
+   the two searches consistent; keys are doubled so they stay integers.
+
+   Landmarks are chosen by the farthest heuristic (each one as far as
+   possible from those already chosen) and their distances are stored as
+   32-bit values in a file, so preprocessing runs once per graph.
+*/
+#define LM_INF UINT32_MAX  // unknown (unreachable or too large)
+
+typedef struct {
+    int n, k;
+    int* landmark;
+    uint32_t* from;     // from[v * k + i] = d(landmark i, v)
+    uint32_t* to;       // to[v * k + i]   = d(v, landmark i)
+} Landmarks;
+
+void landmarksFree(Landmarks* lm) {
+    free(lm->landmark);
+    free(lm->from);
+    free(lm->to);
+}
+
+// Lower bound on d(a, b)
+int64_t lowerBound(const Landmarks* lm, int a, int b) {
+    const uint32_t *fa = lm->from + (long)a * lm->k, *fb = lm->from + (long)b * lm->k;
+    const uint32_t *ta = lm->to + (long)a * lm->k, *tb = lm->to + (long)b * lm->k;
+    int64_t best = 0;
+    for (int i = 0; i < lm->k; i++) {
+        if (fa[i] != LM_INF && fb[i] != LM_INF && (int64_t)fb[i] - fa[i] > best)
+            best = (int64_t)fb[i] - fa[i];
+        if (ta[i] != LM_INF && tb[i] != LM_INF && (int64_t)ta[i] - tb[i] > best)
+            best = (int64_t)ta[i] - tb[i];
+    }
+    return best;
+}
+
+void storeDistances(uint32_t* out, int k, int i, const Dijkstra* d) {
+    for (int v = 0; v < d->g->n; v++)
+        out[(long)v * k + i] = d->dist[v] < LM_INF ? (uint32_t)d->dist[v] : LM_INF;
+}
+
+// k landmarks by the farthest heuristic: 2k full Dijkstra runs
+Landmarks selectLandmarks(const CsrGraph* g, const CsrGraph* rev, int k) {
+    Landmarks lm;
+    lm.n = g->n;
+    lm.k = k;
+    lm.landmark = (int*)malloc(k * sizeof(int));
+    lm.from = (uint32_t*)malloc((size_t)g->n * k * sizeof(uint32_t));
+    lm.to = (uint32_t*)malloc((size_t)g->n * k * sizeof(uint32_t));
+    int64_t* nearest = (int64_t*)malloc((size_t)g->n * sizeof(int64_t));
+    Dijkstra fwd, bwd;
+    dijkstraInit(&fwd, g);
+    dijkstraInit(&bwd, rev);
+
+    // start from the vertex farthest from vertex 0
+    dijkstraRun(&fwd, 0, -1);
+    int next = 0;
+    for (int v = 0; v < g->n; v++) {
+        nearest[v] = INF;
+        if (fwd.dist[v] != INF && fwd.dist[v] > fwd.dist[next])
+            next = v;
+    }
+    for (int i = 0; i < k; i++) {
+        lm.landmark[i] = next;
+        dijkstraRun(&fwd, next, -1);
+        dijkstraRun(&bwd, next, -1);
+        storeDistances(lm.from, k, i, &fwd);
+        storeDistances(lm.to, k, i, &bwd);
+        for (int v = 0; v < g->n; v++) {
+            int64_t dv = fwd.dist[v] < bwd.dist[v] ? fwd.dist[v] : bwd.dist[v];
+            if (dv < nearest[v])
+                nearest[v] = dv;
+            if (nearest[v] != INF && nearest[v] > nearest[next])
+                next = v;
+        }
+    }
+    free(nearest);
+    dijkstraFree(&fwd);
+    dijkstraFree(&bwd);
+    return lm;
+}
+
+// File: "ALT1", n, k, landmark[k], from[n*k], to[n*k]; returns 0 on success
+int saveLandmarks(const Landmarks* lm, const char* path) {
+    FILE* f = fopen(path, "wb");
+    if (f == NULL)
+        return -1;
+    long nk = (long)lm->n * lm->k;
+    int ok = fwrite("ALT1", 1, 4, f) == 4 && fwrite(&lm->n, sizeof(int), 1, f) == 1 &&
+             fwrite(&lm->k, sizeof(int), 1, f) == 1 &&
+             fwrite(lm->landmark, sizeof(int), lm->k, f) == (size_t)lm->k &&
+             fwrite(lm->from, sizeof(uint32_t), nk, f) == (size_t)nk &&
+             fwrite(lm->to, sizeof(uint32_t), nk, f) == (size_t)nk;
+    return fclose(f) == 0 && ok ? 0 : -1;
+}
+
+// Loads landmarks for a graph with n vertices; returns 0 on success
+int loadLandmarks(Landmarks* lm, const char* path, int n) {
+    FILE* f = fopen(path, "rb");
+    if (f == NULL)
+        return -1;
+    char magic[4];
+    int ok = fread(magic, 1, 4, f) == 4 && memcmp(magic, "ALT1", 4) == 0 &&
+             fread(&lm->n, sizeof(int), 1, f) == 1 && fread(&lm->k, sizeof(int), 1, f) == 1 &&
+             lm->n == n && lm->k > 0 && lm->k <= 64;
+    if (!ok) {
+        fclose(f);
+        return -1;
+    }
+    long nk = (long)n * lm->k;
+    lm->landmark = (int*)malloc(lm->k * sizeof(int));
+    lm->from = (uint32_t*)malloc(nk * sizeof(uint32_t));
+    lm->to = (uint32_t*)malloc(nk * sizeof(uint32_t));
+    ok = fread(lm->landmark, sizeof(int), lm->k, f) == (size_t)lm->k &&
+         fread(lm->from, sizeof(uint32_t), nk, f) == (size_t)nk &&
+         fread(lm->to, sizeof(uint32_t), nk, f) == (size_t)nk;
+    fclose(f);
+    if (!ok)
+        landmarksFree(lm);
+    return ok ? 0 : -1;
+}
+
+enum { P2P_DIJKSTRA, P2P_BIDIRECTIONAL, P2P_ALT, P2P_BIDIRECTIONAL_ALT };
+const char* p2pModes[] = { "Dijkstra", "bidirectional", "ALT (A*)", "bidirectional ALT" };
+
+typedef struct {
+    const Landmarks* lm;    // may be NULL when no ALT mode is used
+    Dijkstra fwd, bwd;      // bwd runs on the reversed graph
+    int s, t, meet;         // meet: vertex joining the two halves, -1 if none
+    long settled;
+} PointToPoint;
+
+void p2pInit(PointToPoint* q, const CsrGraph* g, const CsrGraph* rev, const Landmarks* lm) {
+    q->lm = lm;
+    dijkstraInit(&q->fwd, g);
+    dijkstraInit(&q->bwd, rev);
+    q->meet = -1;
+}
+
+void p2pFree(PointToPoint* q) {
+    dijkstraFree(&q->fwd);
+    dijkstraFree(&q->bwd);
+}
+
+// Doubled forward potential of v (the backward one is its negation)
+int64_t potential(const PointToPoint* q, int mode, int v) {
+    if (mode == P2P_ALT)
+        return 2 * lowerBound(q->lm, v, q->t);
+    if (mode == P2P_BIDIRECTIONAL_ALT)
+        return lowerBound(q->lm, v, q->t) - lowerBound(q->lm, q->s, v);
+    return 0;
+}
+
+// Settles the top vertex of one side; sign is +1 forward, -1 backward
+void p2pSettle(PointToPoint* q, int mode, Dijkstra* d, const Dijkstra* other, int sign, int64_t* mu) {
+    const CsrGraph* g = d->g;
+    int u = ih_pop(&d->heap);
+    d->settled++;
+    int64_t du = d->dist[u];
+    for (long a = g->offset[u]; a < g->offset[u + 1]; a++) {
+        int v = g->target[a];
+        int64_t nd = du + g->weight[a];
+        if (nd >= d->dist[v])
+            continue;
+        if (d->dist[v] == INF)
+            d->touched[d->ntouched++] = v;
+        d->dist[v] = nd;
+        d->pred[v] = u;
+        ih_push(&d->heap, v, 2 * nd + sign * potential(q, mode, v));
+        if (other != NULL && other->dist[v] != INF && nd + other->dist[v] < *mu) {
+            *mu = nd + other->dist[v];
+            q->meet = v;
+        }
+    }
+}
+
+// Length of a shortest s-t path, INF if there is none
+int64_t p2pQuery(PointToPoint* q, int s, int t, int mode) {
+    q->s = s;
+    q->t = t;
+    q->meet = -1;
+    int64_t mu = INF;
+    if (mode == P2P_DIJKSTRA || mode == P2P_ALT) {
+        dijkstraReset(&q->fwd, s, potential(q, mode, s));
+        while (!ih_empty(&q->fwd.heap)) {
+            if (q->fwd.heap.a[0].v == t) {
+                mu = q->fwd.dist[t];
+                q->meet = t;
+                q->fwd.settled++;
+                break;
+            }
+            p2pSettle(q, mode, &q->fwd, NULL, 1, &mu);
+        }
+        q->settled = q->fwd.settled;
+        return mu;
+    }
+
+    dijkstraReset(&q->fwd, s, potential(q, mode, s));
+    dijkstraReset(&q->bwd, t, -potential(q, mode, t));
+    if (s == t) {
+        q->meet = s;
+        mu = 0;
+    }
+    while (!ih_empty(&q->fwd.heap) && !ih_empty(&q->bwd.heap)) {
+        int64_t kf = ih_min_key(&q->fwd.heap), kb = ih_min_key(&q->bwd.heap);
+        if (mu != INF && kf + kb >= 2 * mu)
+            break;
+        if (kf <= kb)
+            p2pSettle(q, mode, &q->fwd, &q->bwd, 1, &mu);
+        else
+            p2pSettle(q, mode, &q->bwd, &q->fwd, -1, &mu);
+    }
+    q->settled = q->fwd.settled + q->bwd.settled;
+    return mu;
+}
+
+// Writes the vertices of the path found by the last query; returns its
+// length (0 if t was not reached)
+int p2pPath(const PointToPoint* q, int* path) {
+    if (q->meet < 0)
+        return 0;
+    int len = 0;
+    for (int x = q->meet; x != -1; x = q->fwd.pred[x])
+        path[len++] = x;
+    for (int i = 0; i < len / 2; i++) {
+        int tmp = path[i];
+        path[i] = path[len - 1 - i];
+        path[len - 1 - i] = tmp;
+    }
+    if (q->meet != q->t)
+        for (int x = q->bwd.pred[q->meet]; x != -1; x = q->bwd.pred[x])
+            path[len++] = x;
+    return len;
+}
+
+/* ---------- Parallel delta-stepping ----------
+   Vertices are kept in buckets of width delta by tentative distance
+   (Meyer and Sanders). The lowest non-empty bucket is emptied in rounds:
+   its vertices relax their light arcs (weight <= delta), which may put
+   vertices back into the same bucket; once it stays empty, every vertex
+   that was settled in it relaxes its heavy arcs, which can only reach
+   later buckets. Each round's frontier is split between threads, and a
+   distance is lowered with an atomic compare-and-swap loop. Every thread
+   keeps its own buckets, so pushes need no locks; thread 0 merges them
+   between barriers.
+*/
+typedef struct {
+    int* v;
+    long size, cap;
+} VertexList;
+
+void listPush(VertexList* l, int v) {
+    if (l->size == l->cap) {
+        l->cap = l->cap ? 2 * l->cap : 64;
+        l->v = (int*)realloc(l->v, l->cap * sizeof(int));
+    }
+    l->v[l->size++] = v;
+}
+
+typedef struct {
+    VertexList* bucket;  // bucket[b]: vertices pushed into bucket b
+    long nbuckets;
+    VertexList settled;  // vertices this thread settled in the current bucket
+} ThreadBuckets;
+
+enum { PHASE_LIGHT, PHASE_HEAVY, PHASE_DONE };
+
+typedef struct {
+    const CsrGraph* g;
+    const long* lightEnd;   // arcs offset[u] .. lightEnd[u]-1 are light
+    int64_t delta;
+    int64_t* dist;
+    char* inSettled;
+    int threads;
+    ThreadBuckets* tb;
+    pthread_barrier_t barrier;
+    int phase;
+    long cur;               // bucket being emptied
+    int* frontier;
+    long frontierSize, frontierCap;
+    long next;              // next frontier index to hand out
+    long rounds;
+} DeltaStepping;
+
+typedef struct {
+    DeltaStepping* s;
+    int id;
+} DeltaArg;
+
+// Lowers *p to value; returns 1 if this call lowered it
+int atomicMin64(int64_t* p, int64_t value) {
+    int64_t old = __atomic_load_n(p, __ATOMIC_RELAXED);
+    while (value < old)
+        if (__atomic_compare_exchange_n(p, &old, value, 1, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+            return 1;
+    return 0;
+}
+
+void relaxArcs(DeltaStepping* s, ThreadBuckets* tb, int u, long from, long to) {
+    const CsrGraph* g = s->g;
+    int64_t du = __atomic_load_n(&s->dist[u], __ATOMIC_RELAXED);
+    for (long a = from; a < to; a++) {
+        int64_t nd = du + g->weight[a];
+        if (atomicMin64(&s->dist[g->target[a]], nd)) {
+            long b = nd / s->delta;
+            if (b >= tb->nbuckets) {
+                long nb = tb->nbuckets ? tb->nbuckets : 64;
+                while (nb <= b) nb *= 2;
+                tb->bucket = (VertexList*)realloc(tb->bucket, nb * sizeof(VertexList));
+                memset(tb->bucket + tb->nbuckets, 0, (nb - tb->nbuckets) * sizeof(VertexList));
+                tb->nbuckets = nb;
+            }
+            listPush(&tb->bucket[b], g->target[a]);
+        }
+    }
+}
+
+void frontierAppend(DeltaStepping* s, const int* v, long n) {
+    if (n == 0)
+        return;
+    if (s->frontierSize + n > s->frontierCap) {
+        while (s->frontierSize + n > s->frontierCap)
+            s->frontierCap = s->frontierCap ? 2 * s->frontierCap : 1024;
+        s->frontier = (int*)realloc(s->frontier, s->frontierCap * sizeof(int));
+    }
+    memcpy(s->frontier + s->frontierSize, v, n * sizeof(int));
+    s->frontierSize += n;
+}
+
+// Moves every thread's bucket b into the frontier; returns its size
+long gatherBucket(DeltaStepping* s, long b) {
+    s->frontierSize = 0;
+    for (int t = 0; t < s->threads; t++)
+        if (b < s->tb[t].nbuckets) {
+            frontierAppend(s, s->tb[t].bucket[b].v, s->tb[t].bucket[b].size);
+            s->tb[t].bucket[b].size = 0;
+        }
+    return s->frontierSize;
+}
+
+// Run by thread 0 between rounds: picks the next frontier and phase
+void advance(DeltaStepping* s) {
+    s->next = 0;
+    s->rounds++;
+    if (s->phase == PHASE_LIGHT) {
+        if (gatherBucket(s, s->cur) > 0)
+            return;  // vertices came back into the current bucket
+        s->frontierSize = 0;
+        for (int t = 0; t < s->threads; t++) {
+            frontierAppend(s, s->tb[t].settled.v, s->tb[t].settled.size);
+            s->tb[t].settled.size = 0;
+        }
+        s->phase = PHASE_HEAVY;
+        return;
+    }
+    for (long i = 0; i < s->frontierSize; i++)
+        s->inSettled[s->frontier[i]] = 0;
+    // lowest non-empty bucket above cur; cur only grows, so all these
+    // scans together cost O(buckets * threads)
+    long b = -1, limit = 0;
+    for (int t = 0; t < s->threads; t++)
+        if (s->tb[t].nbuckets > limit)
+            limit = s->tb[t].nbuckets;
+    for (long i = s->cur + 1; i < limit && b < 0; i++)
+        for (int t = 0; t < s->threads; t++)
+            if (i < s->tb[t].nbuckets && s->tb[t].bucket[i].size > 0) {
+                b = i;
+                break;
+            }
+    if (b < 0) {
+        s->phase = PHASE_DONE;
+        return;
+    }
+    s->cur = b;
+    gatherBucket(s, b);
+    s->phase = PHASE_LIGHT;
+}
+
+void* deltaWorker(void* p) {
+    DeltaArg* arg = (DeltaArg*)p;
+    DeltaStepping* s = arg->s;
+    ThreadBuckets* tb = &s->tb[arg->id];
+    const long chunk = 64;
+    for (;;) {
+        pthread_barrier_wait(&s->barrier);
+        if (s->phase == PHASE_DONE)
+            break;
+        long i;
+        while ((i = __atomic_fetch_add(&s->next, chunk, __ATOMIC_RELAXED)) < s->frontierSize) {
+            long end = i + chunk < s->frontierSize ? i + chunk : s->frontierSize;
+            for (; i < end; i++) {
+                int u = s->frontier[i];
+                if (s->phase == PHASE_LIGHT) {
+                    // skip entries whose vertex has since moved to a lower bucket
+                    if (__atomic_load_n(&s->dist[u], __ATOMIC_RELAXED) / s->delta != s->cur)
+                        continue;
+                    if (!__atomic_exchange_n(&s->inSettled[u], 1, __ATOMIC_RELAXED))
+                        listPush(&tb->settled, u);
+                    relaxArcs(s, tb, u, s->g->offset[u], s->lightEnd[u]);
+                } else {
+                    relaxArcs(s, tb, u, s->lightEnd[u], s->g->offset[u + 1]);
+                }
+            }
+        }
+        pthread_barrier_wait(&s->barrier);
+        if (arg->id == 0)
+            advance(s);
+    }
+    return NULL;
+}
+
+int compareInts(const void* a, const void* b) {
+    int x = *(const int*)a, y = *(const int*)b;
+    return (x > y) - (x < y);
+}
+
+// Bucket width from the weight distribution: with d arcs per vertex, a
+// width near the 1/d quantile of the weights leaves about one light arc
+// per vertex (Meyer and Sanders' delta = 1/d for uniform weights)
+int64_t autoDelta(const CsrGraph* g) {
+    if (g->m == 0)
+        return 1;
+    int samples = g->m < 100000 ? (int)g->m : 100000;
+    int* w = (int*)malloc(samples * sizeof(int));
+    unsigned long long seed = 12345;
+    for (int i = 0; i < samples; i++)
+        w[i] = g->weight[samples == g->m ? i : (long)(cg_rand(&seed) % g->m)];
+    qsort(w, samples, sizeof(int), compareInts);
+    double degree = (double)g->m / g->n;
+    int q = (int)(samples / (degree > 1 ? degree : 1));
+    int64_t delta = w[q < samples ? q : samples - 1];
+    free(w);
+    return delta > 0 ? delta : 1;
+}
+
+// Distances from src (INF where unreachable), computed by `threads`
+// threads; delta <= 0 picks the bucket width with autoDelta. The caller
+// frees the result. *rounds (if not NULL) receives the number of rounds.
+int64_t* deltaStepping(const CsrGraph* g, int src, int threads, int64_t delta, long* rounds) {
+    DeltaStepping s;
+    memset(&s, 0, sizeof(s));
+    s.g = g;
+    s.delta = delta > 0 ? delta : autoDelta(g);
+    s.threads = threads;
+
+    // reorder each vertex's arcs so the light ones come first
+    CsrGraph* part = (CsrGraph*)malloc(sizeof(CsrGraph));
+    *part = *g;
+    part->target = (int*)malloc((g->m > 0 ? g->m : 1) * sizeof(int));
+    part->weight = (int*)malloc((g->m > 0 ? g->m : 1) * sizeof(int));
+    long* lightEnd = (long*)malloc((size_t)g->n * sizeof(long));
+    for (int u = 0; u < g->n; u++) {
+        long lo = g->offset[u], hi = g->offset[u + 1];
+        for (long a = g->offset[u]; a < g->offset[u + 1]; a++) {
+            long at = g->weight[a] <= s.delta ? lo++ : --hi;
+            part->target[at] = g->target[a];
+            part->weight[at] = g->weight[a];
+        }
+        lightEnd[u] = lo;
+    }
+    s.g = part;
+    s.lightEnd = lightEnd;
+
+    s.dist = (int64_t*)malloc((size_t)g->n * sizeof(int64_t));
+    for (int v = 0; v < g->n; v++)
+        s.dist[v] = INF;
+    s.inSettled = (char*)calloc(g->n, 1);
+    s.tb = (ThreadBuckets*)calloc(threads, sizeof(ThreadBuckets));
+    s.dist[src] = 0;
+    frontierAppend(&s, &src, 1);
+    s.phase = PHASE_LIGHT;
+    pthread_barrier_init(&s.barrier, NULL, threads);
+
+    pthread_t* tid = (pthread_t*)malloc(threads * sizeof(pthread_t));
+    DeltaArg* args = (DeltaArg*)malloc(threads * sizeof(DeltaArg));
+    for (int t = 0; t < threads; t++) {
+        args[t] = (DeltaArg){ &s, t };
+        if (t > 0)
+            pthread_create(&tid[t], NULL, deltaWorker, &args[t]);
+    }
+    deltaWorker(&args[0]);
+    for (int t = 1; t < threads; t++)
+        pthread_join(tid[t], NULL);
+
+    if (rounds != NULL)
+        *rounds = s.rounds;
+    pthread_barrier_destroy(&s.barrier);
+    for (int t = 0; t < threads; t++) {
+        for (long b = 0; b < s.tb[t].nbuckets; b++)
+            free(s.tb[t].bucket[b].v);
+        free(s.tb[t].bucket);
+        free(s.tb[t].settled.v);
+    }
+    free(s.tb);
+    free(s.inSettled);
+    free(s.frontier);
+    free(tid);
+    free(args);
+    free(lightEnd);
+    free(part->target);
+    free(part->weight);
+    free(part);
+    return s.dist;
 }
 
-int main() {
+/* ---------- Benchmark ---------- */
+double wallTime(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+void benchmark(int n, const char* file) {
+    CsrGraph g;
+    if (file != NULL) {
+        if (cg_read_dimacs(file, &g) != 0) {
+            printf("Cannot read DIMACS graph %s\n", file);
+            return;
+        }
+    } else {
+        int side = (int)sqrt((double)n);
+        g = cg_grid(side, side, 1000, 42);
+    }
+    V = g.n;
+    printf("%d vertices, %ld arcs\n", g.n, g.m);
+
+    Dijkstra d;
+    dijkstraInit(&d, &g);
+    double t = wallTime();
+    dijkstraRun(&d, 0, -1);
+    t = wallTime() - t;
+    printf("heap + CSR, all targets:   %10.4f s\n", t);
+
+    if (g.n <= DENSE_LIMIT) {
+        int* matrix = (int*)calloc((size_t)g.n * g.n, sizeof(int));
+        for (int u = 0; u < g.n; u++)
+            for (long a = g.offset[u]; a < g.offset[u + 1]; a++) {
+                int* w = &matrix[(long)u * g.n + g.target[a]];
+                if (*w == 0 || g.weight[a] < *w)
+                    *w = g.weight[a] ? g.weight[a] : 1;
+            }
+        int64_t* dist = (int64_t*)malloc(g.n * sizeof(int64_t));
+        double s = wallTime();
+        dijkstraMatrix(matrix, 0, dist);
+        s = wallTime() - s;
+        int same = 1;
+        for (int v = 0; v < g.n; v++)
+            same &= dist[v] == d.dist[v];
+        printf("O(V^2) matrix, all targets:%10.4f s  (%.1fx slower, %s)\n", s, s / t,
+               same ? "same distances" : "DIFFERENT DISTANCES");
+        free(dist);
+        free(matrix);
+    } else {
+        printf("O(V^2) matrix: skipped above %d vertices\n", DENSE_LIMIT);
+    }
+
+    int cores = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    for (int threads = 1; threads <= cores; threads = threads < cores && 2 * threads > cores ? cores : 2 * threads) {
+        long rounds;
+        double s = wallTime();
+        int64_t* dist = deltaStepping(&g, 0, threads, 0, &rounds);
+        s = wallTime() - s;
+        int same = 1;
+        for (int v = 0; v < g.n; v++)
+            same &= dist[v] == d.dist[v];
+        printf("delta-stepping, %2d threads:%10.4f s  (delta %lld, %ld rounds, %s)\n", threads, s,
+               (long long)autoDelta(&g), rounds, same ? "same distances" : "DIFFERENT DISTANCES");
+        free(dist);
+    }
+
+    // single-target queries with early exit
+    unsigned long long seed = 7;
+    int queries = g.n > 1000000 ? 10 : 100;
+    long settled = 0;
+    t = wallTime();
+    for (int q = 0; q < queries; q++) {
+        int s = (int)(cg_rand(&seed) % g.n), tg = (int)(cg_rand(&seed) % g.n);
+        dijkstraRun(&d, s, tg);
+        settled += d.settled;
+    }
+    t = wallTime() - t;
+    printf("single-target queries:     %10.4f ms each, %.0f vertices settled on average\n",
+           t * 1e3 / queries, (double)settled / queries);
+    dijkstraFree(&d);
+    cg_free(&g);
+}
+
+// Random point-to-point queries in every mode; landmarks are loaded from
+// <graph>.alt, or computed and saved there when the file is missing
+void p2pBenchmark(int n, int k, const char* file) {
+    CsrGraph g;
+    char altPath[512];
+    if (file != NULL) {
+        if (cg_read_dimacs(file, &g) != 0) {
+            printf("Cannot read DIMACS graph %s\n", file);
+            return;
+        }
+        snprintf(altPath, sizeof(altPath), "%s.alt", file);
+    } else {
+        int side = (int)sqrt((double)n);
+        g = cg_grid(side, side, 1000, 42);
+        snprintf(altPath, sizeof(altPath), "grid%d.alt", side);
+    }
+    CsrGraph rev = cg_reverse(&g);
+    printf("%d vertices, %ld arcs\n", g.n, g.m);
+
+    Landmarks lm;
+    double t = wallTime();
+    if (loadLandmarks(&lm, altPath, g.n) == 0) {
+        printf("loaded %d landmarks from %s in %.3f s\n", lm.k, altPath, wallTime() - t);
+    } else {
+        lm = selectLandmarks(&g, &rev, k);
+        printf("selected %d landmarks in %.3f s", k, wallTime() - t);
+        printf(saveLandmarks(&lm, altPath) == 0 ? ", saved to %s\n" : ", could not save %s\n", altPath);
+    }
+
+    int queries = 200;
+    int* pairs = (int*)malloc(2 * queries * sizeof(int));
+    int64_t* expected = (int64_t*)malloc(queries * sizeof(int64_t));
+    unsigned long long seed = 99;
+    for (int i = 0; i < 2 * queries; i++)
+        pairs[i] = (int)(cg_rand(&seed) % g.n);
+
+    PointToPoint q;
+    p2pInit(&q, &g, &rev, &lm);
+    printf("%-18s %12s %14s\n", "mode", "time (us)", "settled");
+    for (int mode = 0; mode < 4; mode++) {
+        long settled = 0;
+        int wrong = 0;
+        t = wallTime();
+        for (int i = 0; i < queries; i++) {
+            int64_t dist = p2pQuery(&q, pairs[2 * i], pairs[2 * i + 1], mode);
+            settled += q.settled;
+            if (mode == 0)
+                expected[i] = dist;
+            wrong += dist != expected[i];
+        }
+        t = wallTime() - t;
+        printf("%-18s %12.1f %14.0f%s\n", p2pModes[mode], t * 1e6 / queries, (double)settled / queries,
+               wrong ? "  WRONG DISTANCES" : "");
+    }
+    p2pFree(&q);
+    free(pairs);
+    free(expected);
+    landmarksFree(&lm);
+    cg_free(&rev);
+    cg_free(&g);
+}
+
+int main(int argc, char** argv) {
+    if (argc > 2 && strcmp(argv[1], "--bench") == 0) {
+        benchmark(atoi(argv[2]), argc > 3 ? argv[3] : NULL);
+        return 0;
+    }
+    if (argc > 2 && strcmp(argv[1], "--p2p") == 0) {
+        p2pBenchmark(atoi(argv[2]), argc > 3 ? atoi(argv[3]) : 16, argc > 4 ? argv[4] : NULL);
+        return 0;
+    }
+
     printf("Enter number of vertices: ");
-    scanf("%d", &V);
-    int graph[MAX][MAX];
+    if (scanf("%d", &V) != 1 || V <= 0)
+        return 1;
+    int* graph = (int*)malloc((size_t)V * V * sizeof(int));
 
     printf("Enter adjacency matrix:\n");
+    long m = 0;
     for (int i = 0; i < V; i++)
-        for (int j = 0; j < V; j++)
-            scanf("%d", &graph[i][j]);
+        for (int j = 0; j < V; j++) {
+            scanf("%d", &graph[(long)i * V + j]);
+            m += graph[(long)i * V + j] != 0;
+        }
 
     int src;
     printf("Enter source vertex: ");
     scanf("%d", &src);
+    if (src < 0 || src >= V)
+        return 1;
+
+    CgEdge* edges = (CgEdge*)malloc((m > 0 ? m : 1) * sizeof(CgEdge));
+    m = 0;
+    for (int i = 0; i < V; i++)
+        for (int j = 0; j < V; j++)
+            if (graph[(long)i * V + j])
+                edges[m++] = (CgEdge){ i, j, graph[(long)i * V + j] };
+    CsrGraph g = cg_from_edges(V, m, edges, 0);
+    free(edges);
+
+    Dijkstra d;
+    dijkstraInit(&d, &g);
+    dijkstraRun(&d, src, -1);
+
+    printf("Vertex \t Distance from Source \t Path\n");
+    for (int i = 0; i < V; i++) {
+        if (d.dist[i] == INF) {
+            printf("%d \t INF \t\t\t -\n", i);
+            continue;
+        }
+        printf("%d \t %lld \t\t\t ", i, (long long)d.dist[i]);
+        printPath(&d, i);
+        printf("\n");
+    }
 
-    dijkstra(graph, src);
+    dijkstraFree(&d);
+    cg_free(&g);
+    free(graph);
     return 0;
 }
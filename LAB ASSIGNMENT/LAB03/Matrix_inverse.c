@@ -1,76 +1,51 @@
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../common/dense_kernels.h"
 
 // Function to perform LU Decomposition using Doolittle’s method
+// (right-looking: each step is one rank-1 update of the trailing block)
 void luDecomposition(int n, double A[n][n], double L[n][n], double U[n][n]) {
-    for (int i = 0; i < n; i++) {
-        // Upper triangular matrix
-        for (int k = i; k < n; k++) {
-            double sum = 0;
-            for (int j = 0; j < i; j++)
-                sum += L[i][j] * U[j][k];
-            U[i][k] = A[i][k] - sum;
-        }
-
-        // Lower triangular matrix
-        for (int k = i; k < n; k++) {
-            if (i == k)
-                L[i][i] = 1;
-            else {
-                double sum = 0;
-                for (int j = 0; j < i; j++)
-                    sum += L[k][j] * U[j][i];
-                L[k][i] = (A[k][i] - sum) / U[i][i];
-            }
+    double *col = (double *)malloc(n * sizeof(double));
+
+    memcpy(U, A, sizeof(double) * n * n);
+    memset(L, 0, sizeof(double) * n * n);
+
+    for (int k = 0; k < n; k++) {
+        // Lower triangular matrix: multipliers of column k
+        L[k][k] = 1;
+        for (int i = k + 1; i < n; i++) {
+            L[i][k] = U[i][k] / U[k][k];
+            col[i] = L[i][k];
+            U[i][k] = 0;
         }
-    }
-}
-
-// Forward substitution: L * Y = B
-void forwardSubstitution(int n, double L[n][n], double B[n], double Y[n]) {
-    for (int i = 0; i < n; i++) {
-        double sum = 0;
-        for (int j = 0; j < i; j++)
-            sum += L[i][j] * Y[j];
-        Y[i] = B[i] - sum;
-    }
-}
 
-// Backward substitution: U * X = Y
-void backwardSubstitution(int n, double U[n][n], double Y[n], double X[n]) {
-    for (int i = n - 1; i >= 0; i--) {
-        double sum = 0;
-        for (int j = i + 1; j < n; j++)
-            sum += U[i][j] * X[j];
-        X[i] = (Y[i] - sum) / U[i][i];
+        // Upper triangular matrix: U[k+1:, k+1:] -= L[k+1:, k] * U[k, k+1:]
+        if (k + 1 < n)
+            dk_dger(n - k - 1, n - k - 1, -1.0, col + k + 1, &U[k][k + 1],
+                    &U[k + 1][k + 1], n);
     }
+    free(col);
 }
 
 // Function to find the inverse of A using LU decomposition
 void inverseMatrix(int n, double A[n][n], double inverse[n][n]) {
-    double L[n][n], U[n][n];
-
-    // Initialize L and U with 0
-    for (int i = 0; i < n; i++)
-        for (int j = 0; j < n; j++) {
-            L[i][j] = 0;
-            U[i][j] = 0;
-        }
+    double (*L)[n] = malloc(sizeof(double[n][n]));
+    double (*U)[n] = malloc(sizeof(double[n][n]));
 
     luDecomposition(n, A, L, U);
 
-    // Solve AX = I → For each column of I
-    for (int i = 0; i < n; i++) {
-        double e[n], y[n], x[n];
-
-        for (int j = 0; j < n; j++) e[j] = 0;
-        e[i] = 1;  // ith column of Identity
+    // Solve AX = I for all columns of I at once:
+    // L * Y = I (forward substitution), then U * X = Y (backward substitution)
+    for (int i = 0; i < n; i++)
+        for (int j = 0; j < n; j++)
+            inverse[i][j] = (i == j) ? 1 : 0;
 
-        forwardSubstitution(n, L, e, y);
-        backwardSubstitution(n, U, y, x);
+    dk_dtrsm('L', 'U', n, n, &L[0][0], n, &inverse[0][0], n);
+    dk_dtrsm('U', 'N', n, n, &U[0][0], n, &inverse[0][0], n);
 
-        for (int j = 0; j < n; j++)
-            inverse[j][i] = x[j];
-    }
+    free(L);
+    free(U);
 }
 
 // Function to print matrix
@@ -87,7 +62,8 @@ int main() {
     printf("Enter order of matrix (n x n): ");
     scanf("%d", &n);
 
-    double A[n][n], inverse[n][n];
+    double (*A)[n] = malloc(sizeof(double[n][n]));
+    double (*inverse)[n] = malloc(sizeof(double[n][n]));
 
     printf("Enter matrix elements:\n");
     for (int i = 0; i < n; i++)
@@ -99,5 +75,7 @@ int main() {
     printf("\nInverse of the matrix is:\n");
     printMatrix(n, inverse);
 
+    free(A);
+    free(inverse);
     return 0;
 }
@@ -1,133 +1,435 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include "../../common/dense_kernels.h"
 
-#define MAX 8  // maximum matrix size (must be power of 2 for simplicity)
+// Below these orders the shared GEMM kernels beat another Strassen level.
+// Defaults measured per element type with --bench-cutoff, which also sets
+// cutoff_S for the rest of its run.
+#ifndef CUTOFF_i64
+#define CUTOFF_i64 512
+#endif
+#ifndef CUTOFF_f32
+#define CUTOFF_f32 64
+#endif
+#ifndef CUTOFF_f64
+#define CUTOFF_f64 2048   // the packed AVX2 dk_dgemm is hard to beat
+#endif
+int cutoff_i64 = CUTOFF_i64, cutoff_f32 = CUTOFF_f32, cutoff_f64 = CUTOFF_f64;
 
-// Function to add two matrices
-void addMatrix(int n, int A[MAX][MAX], int B[MAX][MAX], int C[MAX][MAX]) {
-    for (int i = 0; i < n; i++)
-        for (int j = 0; j < n; j++)
-            C[i][j] = A[i][j] + B[i][j];
+/*
+   Matrices are heap-backed and any size n works. The same code is generated
+   for int64, float and double element types by DEFINE_MATRIX_TYPE, and
+   strassen(n, A, B, C) picks the right version from the argument type.
+
+   int64 arithmetic is done with unsigned (wrapping) operations. Strassen's
+   intermediate sums may overflow, but the result is exact modulo 2^64, so it
+   is correct whenever the true product fits in int64. strassen() checks a
+   bound on the result first. If the bound may overflow, it uses a classical
+   kernel that accumulates in 128 bits and reports real overflow.
+*/
+
+// Set when an int64 product does not fit in 64 bits
+int overflowDetected = 0;
+
+/* Element arithmetic per type */
+#define ADD_i64(a, b) ((int64_t)((uint64_t)(a) + (uint64_t)(b)))
+#define SUB_i64(a, b) ((int64_t)((uint64_t)(a) - (uint64_t)(b)))
+#define MUL_i64(a, b) ((int64_t)((uint64_t)(a) * (uint64_t)(b)))
+#define ADD_f32(a, b) ((a) + (b))
+#define SUB_f32(a, b) ((a) - (b))
+#define MUL_f32(a, b) ((a) * (b))
+#define ADD_f64(a, b) ((a) + (b))
+#define SUB_f64(a, b) ((a) - (b))
+#define MUL_f64(a, b) ((a) * (b))
+
+/* Classical kernel per type, from common/dense_kernels.h */
+void dgemmAccumulate(int m, int n, int k, const double *A, int lda, const double *B, int ldb,
+                     double *C, int ldc, int accumulate) {
+    dk_dgemm(m, n, k, 1.0, A, lda, B, ldb, accumulate ? 1.0 : 0.0, C, ldc);
+}
+#define GEMM_i64 dk_lgemm
+#define GEMM_f32 dk_sgemm
+#define GEMM_f64 dgemmAccumulate
+
+#define DEFINE_MATRIX_TYPE(T, S)                                                   \
+                                                                                   \
+/* Square n x n matrix, row-major */                                               \
+typedef struct {                                                                   \
+    int n;                                                                         \
+    T *data;                                                                       \
+} Matrix_##S;                                                                      \
+                                                                                   \
+Matrix_##S *newMatrix_##S(int n) {                                                 \
+    Matrix_##S *M = (Matrix_##S *)malloc(sizeof(Matrix_##S));                      \
+    M->n = n;                                                                      \
+    M->data = (T *)calloc((size_t)n * n, sizeof(T));                               \
+    return M;                                                                      \
+}                                                                                  \
+                                                                                   \
+void freeMatrix_##S(Matrix_##S *M) {                                               \
+    free(M->data);                                                                 \
+    free(M);                                                                       \
+}                                                                                  \
+                                                                                   \
+/* C = A + B on n x n views with leading dimensions */                             \
+void addMatrix_##S(int n, const T *A, int lda, const T *B, int ldb, T *C, int ldc) { \
+    for (int i = 0; i < n; i++)                                                    \
+        for (int j = 0; j < n; j++)                                                \
+            C[i*ldc + j] = ADD_##S(A[i*lda + j], B[i*ldb + j]);                    \
+}                                                                                  \
+                                                                                   \
+/* C = A - B */                                                                    \
+void subMatrix_##S(int n, const T *A, int lda, const T *B, int ldb, T *C, int ldc) { \
+    for (int i = 0; i < n; i++)                                                    \
+        for (int j = 0; j < n; j++)                                                \
+            C[i*ldc + j] = SUB_##S(A[i*lda + j], B[i*ldb + j]);                    \
+}                                                                                  \
+                                                                                   \
+/* Naive triple loop C = A * B */                                                  \
+void naiveMultiply_##S(int n, const T *A, const T *B, T *C) {                      \
+    for (int i = 0; i < n; i++)                                                    \
+        for (int j = 0; j < n; j++) {                                              \
+            T sum = 0;                                                             \
+            for (int k = 0; k < n; k++)                                            \
+                sum = ADD_##S(sum, MUL_##S(A[(size_t)i*n + k], B[(size_t)k*n + j])); \
+            C[(size_t)i*n + j] = sum;                                              \
+        }                                                                          \
+}                                                                                  \
+                                                                                   \
+/* Classical C (+)= A * B on an m x k by k x n view */                          \
+void blockedMultiply_##S(int m, int k, int n, const T *A, int lda, const T *B, int ldb, \
+                         T *C, int ldc, int accumulate) {                          \
+    GEMM_##S(m, n, k, A, lda, B, ldb, C, ldc, accumulate);                         \
+}                                                                                  \
+                                                                                   \
+/* Elements of workspace strassenView_##S needs for order n */                     \
+size_t strassenWork_##S(int n) {                                                   \
+    size_t total = 0;                                                              \
+    while (n > cutoff_##S) {                                                       \
+        n -= n % 2;                                                                \
+        n /= 2;                                                                    \
+        total += 9 * (size_t)n * n;                                                \
+    }                                                                              \
+    return total;                                                                  \
+}                                                                                  \
+                                                                                   \
+/* Strassen on n x n views; odd n is handled by peeling the last row/column.       \
+   work holds strassenWork_##S(n) elements: this level takes the first 9*h*h       \
+   and the recursive calls, which run one after another, share the rest. */        \
+void strassenView_##S(int n, const T *A, int lda, const T *B, int ldb, T *C, int ldc, T *work) { \
+    if (n <= cutoff_##S) {                                                         \
+        blockedMultiply_##S(n, n, n, A, lda, B, ldb, C, ldc, 0);                   \
+        return;                                                                    \
+    }                                                                              \
+    if (n % 2 != 0) {                                                              \
+        int e = n - 1;                                                             \
+        strassenView_##S(e, A, lda, B, ldb, C, ldc, work);                         \
+        /* C[0:e,0:e] += A[0:e,e] * B[e,0:e] */                                    \
+        blockedMultiply_##S(e, 1, e, A + e, lda, B + (size_t)e*ldb, ldb, C, ldc, 1); \
+        /* last column and last row */                                             \
+        blockedMultiply_##S(e, n, 1, A, lda, B + e, ldb, C + e, ldc, 0);           \
+        blockedMultiply_##S(1, n, n, A + (size_t)e*lda, lda, B, ldb, C + (size_t)e*ldc, ldc, 0); \
+        return;                                                                    \
+    }                                                                              \
+                                                                                   \
+    int h = n / 2;                                                                 \
+    size_t sz = (size_t)h * h;                                                     \
+    T *buf = work, *rest = work + 9 * sz;                                          \
+    T *temp1 = buf, *temp2 = buf + sz;                                             \
+    T *M[7];                                                                       \
+    for (int i = 0; i < 7; i++) M[i] = buf + (2 + i) * sz;                         \
+                                                                                   \
+    const T *A11 = A, *A12 = A + h, *A21 = A + (size_t)h*lda, *A22 = A21 + h;      \
+    const T *B11 = B, *B12 = B + h, *B21 = B + (size_t)h*ldb, *B22 = B21 + h;      \
+    T *C11 = C, *C12 = C + h, *C21 = C + (size_t)h*ldc, *C22 = C21 + h;            \
+                                                                                   \
+    /* M1 = (A11 + A22) * (B11 + B22) */                                           \
+    addMatrix_##S(h, A11, lda, A22, lda, temp1, h);                                \
+    addMatrix_##S(h, B11, ldb, B22, ldb, temp2, h);                                \
+    strassenView_##S(h, temp1, h, temp2, h, M[0], h, rest);                        \
+    /* M2 = (A21 + A22) * B11 */                                                   \
+    addMatrix_##S(h, A21, lda, A22, lda, temp1, h);                                \
+    strassenView_##S(h, temp1, h, B11, ldb, M[1], h, rest);                        \
+    /* M3 = A11 * (B12 - B22) */                                                   \
+    subMatrix_##S(h, B12, ldb, B22, ldb, temp2, h);                                \
+    strassenView_##S(h, A11, lda, temp2, h, M[2], h, rest);                        \
+    /* M4 = A22 * (B21 - B11) */                                                   \
+    subMatrix_##S(h, B21, ldb, B11, ldb, temp2, h);                                \
+    strassenView_##S(h, A22, lda, temp2, h, M[3], h, rest);                        \
+    /* M5 = (A11 + A12) * B22 */                                                   \
+    addMatrix_##S(h, A11, lda, A12, lda, temp1, h);                                \
+    strassenView_##S(h, temp1, h, B22, ldb, M[4], h, rest);                        \
+    /* M6 = (A21 - A11) * (B11 + B12) */                                           \
+    subMatrix_##S(h, A21, lda, A11, lda, temp1, h);                                \
+    addMatrix_##S(h, B11, ldb, B12, ldb, temp2, h);                                \
+    strassenView_##S(h, temp1, h, temp2, h, M[5], h, rest);                        \
+    /* M7 = (A12 - A22) * (B21 + B22) */                                           \
+    subMatrix_##S(h, A12, lda, A22, lda, temp1, h);                                \
+    addMatrix_##S(h, B21, ldb, B22, ldb, temp2, h);                                \
+    strassenView_##S(h, temp1, h, temp2, h, M[6], h, rest);                        \
+                                                                                   \
+    /* C11 = M1 + M4 - M5 + M7 */                                                  \
+    addMatrix_##S(h, M[0], h, M[3], h, temp1, h);                                  \
+    subMatrix_##S(h, temp1, h, M[4], h, temp2, h);                                 \
+    addMatrix_##S(h, temp2, h, M[6], h, C11, ldc);                                 \
+    /* C12 = M3 + M5 */                                                            \
+    addMatrix_##S(h, M[2], h, M[4], h, C12, ldc);                                  \
+    /* C21 = M2 + M4 */                                                            \
+    addMatrix_##S(h, M[1], h, M[3], h, C21, ldc);                                  \
+    /* C22 = M1 - M2 + M3 + M6 */                                                  \
+    subMatrix_##S(h, M[0], h, M[1], h, temp1, h);                                  \
+    addMatrix_##S(h, temp1, h, M[2], h, temp2, h);                                 \
+    addMatrix_##S(h, temp2, h, M[5], h, C22, ldc);                                 \
+}
+
+DEFINE_MATRIX_TYPE(int64_t, i64)
+DEFINE_MATRIX_TYPE(float, f32)
+DEFINE_MATRIX_TYPE(double, f64)
+
+void strassen_f32(int n, const Matrix_f32 *A, const Matrix_f32 *B, Matrix_f32 *C) {
+    float *work = (float *)malloc((strassenWork_f32(n) + 1) * sizeof(float));
+    strassenView_f32(n, A->data, A->n, B->data, B->n, C->data, C->n, work);
+    free(work);
+}
+
+void strassen_f64(int n, const Matrix_f64 *A, const Matrix_f64 *B, Matrix_f64 *C) {
+    double *work = (double *)malloc((strassenWork_f64(n) + 1) * sizeof(double));
+    strassenView_f64(n, A->data, A->n, B->data, B->n, C->data, C->n, work);
+    free(work);
 }
 
-// Function to subtract two matrices
-void subMatrix(int n, int A[MAX][MAX], int B[MAX][MAX], int C[MAX][MAX]) {
+// Classical int64 product that flags entries whose true value does not fit
+// in 64 bits; C then holds the result modulo 2^64, like the Strassen path.
+// Each product fits in 128 bits; the running sum is added with an overflow
+// check, and a partial sum past 2^127 is treated as overflow.
+void checkedMultiply_i64(int n, const int64_t *A, const int64_t *B, int64_t *C) {
     for (int i = 0; i < n; i++)
-        for (int j = 0; j < n; j++)
-            C[i][j] = A[i][j] - B[i][j];
+        for (int j = 0; j < n; j++) {
+            __int128 sum = 0;
+            int64_t wrapped = 0;
+            int overflow = 0;
+            for (int k = 0; k < n; k++) {
+                int64_t a = A[(size_t)i*n + k], b = B[(size_t)k*n + j];
+                wrapped = ADD_i64(wrapped, MUL_i64(a, b));
+                if (!overflow && __builtin_add_overflow(sum, (__int128)a * b, &sum))
+                    overflow = 1;
+            }
+            if (overflow || sum > INT64_MAX || sum < INT64_MIN)
+                overflowDetected = 1;
+            C[(size_t)i*n + j] = wrapped;
+        }
+}
+
+void strassen_i64(int n, const Matrix_i64 *A, const Matrix_i64 *B, Matrix_i64 *C) {
+    // |C[i][j]| <= n * max|A| * max|B|; if that fits, wrapping Strassen is exact
+    uint64_t maxA = 0, maxB = 0;
+    for (size_t i = 0; i < (size_t)n * n; i++) {
+        uint64_t a = A->data[i] < 0 ? -(uint64_t)A->data[i] : (uint64_t)A->data[i];
+        uint64_t b = B->data[i] < 0 ? -(uint64_t)B->data[i] : (uint64_t)B->data[i];
+        if (a > maxA) maxA = a;
+        if (b > maxB) maxB = b;
+    }
+    // divide instead of multiplying so the test itself cannot overflow
+    if (maxA == 0 || maxB == 0 || (maxA <= INT64_MAX / maxB && maxA * maxB <= INT64_MAX / (uint64_t)n)) {
+        int64_t *work = (int64_t *)malloc((strassenWork_i64(n) + 1) * sizeof(int64_t));
+        strassenView_i64(n, A->data, A->n, B->data, B->n, C->data, C->n, work);
+        free(work);
+    } else
+        checkedMultiply_i64(n, A->data, B->data, C->data);
+}
+
+// strassen(n, A, B, C) dispatches on the matrix element type
+#define strassen(n, A, B, C) _Generic((A),              \
+        Matrix_i64 *: strassen_i64,                     \
+        Matrix_f32 *: strassen_f32,                     \
+        Matrix_f64 *: strassen_f64)(n, A, B, C)
+
+double wallTime(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
 }
 
-// Strassen’s matrix multiplication algorithm
-void strassen(int n, int A[MAX][MAX], int B[MAX][MAX], int C[MAX][MAX]) {
-    if (n == 1) {
-        C[0][0] = A[0][0] * B[0][0];
-        return;
+// int64 products near the overflow bound must take the checked kernel and
+// agree with it; returns the number of failures
+int overflowCheck(void) {
+    int failures = 0, n = 64;
+    Matrix_i64 *A = newMatrix_i64(n), *B = newMatrix_i64(n), *C = newMatrix_i64(n);
+    int64_t *R = (int64_t *)malloc((size_t)n * n * sizeof(int64_t));
+
+    // each entry sums about 21 products of 2^124: far outside int64, and
+    // past 2^127 the 128-bit partial sum itself overflows; both must be flagged
+    for (size_t i = 0; i < (size_t)n * n; i++) {
+        A->data[i] = (int64_t)1 << 62;
+        B->data[i] = i % 3 == 0 ? (int64_t)1 << 62 : 0;
+    }
+    overflowDetected = 0;
+    strassen(n, A, B, C);
+    printf("%-40s %s\n", "2^62 entries, n = 64: overflow flagged", overflowDetected ? "ok" : "MISMATCH");
+    failures += !overflowDetected;
+
+    // n = 16, all 2^62: sixteen products of 2^124 sum to exactly 2^128, which
+    // a wrapping 128-bit accumulator would report as 0 with no overflow
+    Matrix_i64 *A16 = newMatrix_i64(16), *B16 = newMatrix_i64(16), *C16 = newMatrix_i64(16);
+    for (int i = 0; i < 16 * 16; i++)
+        A16->data[i] = B16->data[i] = (int64_t)1 << 62;
+    overflowDetected = 0;
+    strassen(16, A16, B16, C16);
+    printf("%-40s %s\n", "2^62 entries, n = 16: overflow flagged", overflowDetected ? "ok" : "MISMATCH");
+    failures += !overflowDetected;
+    freeMatrix_i64(A16); freeMatrix_i64(B16); freeMatrix_i64(C16);
+
+    // entries just below the bound: no overflow, and the result is exact
+    for (size_t i = 0; i < (size_t)n * n; i++) {
+        A->data[i] = (i % 2 ? 1 : -1) * (int64_t)(INT32_MAX / 8);
+        B->data[i] = (i % 5 ? 1 : -1) * (int64_t)(INT32_MAX / 8);
     }
+    overflowDetected = 0;
+    strassen(n, A, B, C);
+    checkedMultiply_i64(n, A->data, B->data, R);
+    int same = memcmp(C->data, R, (size_t)n * n * sizeof(int64_t)) == 0 && !overflowDetected;
+    printf("%-40s %s\n", "2^28 entries, n = 64: exact product", same ? "ok" : "MISMATCH");
+    failures += !same;
+
+    free(R);
+    freeMatrix_i64(A); freeMatrix_i64(B); freeMatrix_i64(C);
+    return failures;
+}
 
-    int newSize = n / 2;
-    int A11[MAX][MAX], A12[MAX][MAX], A21[MAX][MAX], A22[MAX][MAX];
-    int B11[MAX][MAX], B12[MAX][MAX], B21[MAX][MAX], B22[MAX][MAX];
-    int M1[MAX][MAX], M2[MAX][MAX], M3[MAX][MAX], M4[MAX][MAX];
-    int M5[MAX][MAX], M6[MAX][MAX], M7[MAX][MAX];
-    int temp1[MAX][MAX], temp2[MAX][MAX];
-
-    // Divide matrices A and B into 4 submatrices
-    for (int i = 0; i < newSize; i++) {
-        for (int j = 0; j < newSize; j++) {
-            A11[i][j] = A[i][j];
-            A12[i][j] = A[i][j + newSize];
-            A21[i][j] = A[i + newSize][j];
-            A22[i][j] = A[i + newSize][j + newSize];
-
-            B11[i][j] = B[i][j];
-            B12[i][j] = B[i][j + newSize];
-            B21[i][j] = B[i + newSize][j];
-            B22[i][j] = B[i + newSize][j + newSize];
+// Compares naive, blocked and Strassen (double) for n = 512 .. maxN
+void benchmark(int maxN, int naiveLimit) {
+    printf("%6s %12s %12s %12s %14s\n", "n", "naive(s)", "blocked(s)", "strassen(s)", "max |diff|");
+    for (int n = 512; n <= maxN; n *= 2) {
+        Matrix_f64 *A = newMatrix_f64(n), *B = newMatrix_f64(n);
+        Matrix_f64 *C = newMatrix_f64(n), *R = newMatrix_f64(n);
+        for (size_t i = 0; i < (size_t)n * n; i++) {
+            A->data[i] = (double)rand() / RAND_MAX;
+            B->data[i] = (double)rand() / RAND_MAX;
         }
+
+        double naive = -1;
+        if (n <= naiveLimit) {
+            double t = wallTime();
+            naiveMultiply_f64(n, A->data, B->data, R->data);
+            naive = wallTime() - t;
+        }
+
+        double t = wallTime();
+        blockedMultiply_f64(n, n, n, A->data, n, B->data, n, R->data, n, 0);
+        double blocked = wallTime() - t;
+
+        t = wallTime();
+        strassen(n, A, B, C);
+        double fast = wallTime() - t;
+
+        double diff = 0;
+        for (size_t i = 0; i < (size_t)n * n; i++) {
+            double d = C->data[i] - R->data[i];
+            if (d < 0) d = -d;
+            if (d > diff) diff = d;
+        }
+
+        if (naive >= 0)
+            printf("%6d %12.3f %12.3f %12.3f %14.3e\n", n, naive, blocked, fast, diff);
+        else
+            printf("%6d %12s %12.3f %12.3f %14.3e\n", n, "skipped", blocked, fast, diff);
+
+        freeMatrix_f64(A); freeMatrix_f64(B); freeMatrix_f64(C); freeMatrix_f64(R);
     }
+}
 
-    // M1 = (A11 + A22) * (B11 + B22)
-    addMatrix(newSize, A11, A22, temp1);
-    addMatrix(newSize, B11, B22, temp2);
-    strassen(newSize, temp1, temp2, M1);
-
-    // M2 = (A21 + A22) * B11
-    addMatrix(newSize, A21, A22, temp1);
-    strassen(newSize, temp1, B11, M2);
-
-    // M3 = A11 * (B12 - B22)
-    subMatrix(newSize, B12, B22, temp2);
-    strassen(newSize, A11, temp2, M3);
-
-    // M4 = A22 * (B21 - B11)
-    subMatrix(newSize, B21, B11, temp2);
-    strassen(newSize, A22, temp2, M4);
-
-    // M5 = (A11 + A12) * B22
-    addMatrix(newSize, A11, A12, temp1);
-    strassen(newSize, temp1, B22, M5);
-
-    // M6 = (A21 - A11) * (B11 + B12)
-    subMatrix(newSize, A21, A11, temp1);
-    addMatrix(newSize, B11, B12, temp2);
-    strassen(newSize, temp1, temp2, M6);
-
-    // M7 = (A12 - A22) * (B21 + B22)
-    subMatrix(newSize, A12, A22, temp1);
-    addMatrix(newSize, B21, B22, temp2);
-    strassen(newSize, temp1, temp2, M7);
-
-    // C11 = M1 + M4 - M5 + M7
-    addMatrix(newSize, M1, M4, temp1);
-    subMatrix(newSize, temp1, M5, temp2);
-    addMatrix(newSize, temp2, M7, C);
-
-    // C12 = M3 + M5
-    addMatrix(newSize, M3, M5, temp1);
-    for (int i = 0; i < newSize; i++)
-        for (int j = 0; j < newSize; j++)
-            C[i][j + newSize] = temp1[i][j];
-
-    // C21 = M2 + M4
-    addMatrix(newSize, M2, M4, temp1);
-    for (int i = 0; i < newSize; i++)
-        for (int j = 0; j < newSize; j++)
-            C[i + newSize][j] = temp1[i][j];
-
-    // C22 = M1 - M2 + M3 + M6
-    subMatrix(newSize, M1, M2, temp1);
-    addMatrix(newSize, temp1, M3, temp2);
-    addMatrix(newSize, temp2, M6, temp1);
-    for (int i = 0; i < newSize; i++)
-        for (int j = 0; j < newSize; j++)
-            C[i + newSize][j + newSize] = temp1[i][j];
+/* Crossover per element type: one Strassen level against the classical
+   kernel at n = 128 .. maxN, best of three runs each. The cutoff is half
+   the smallest n from which one level stays at least 5% faster (maxN if it
+   never does); it is stored in cutoff_S and returned. */
+#define DEFINE_CROSSOVER(T, S, RANDOM)                                             \
+int crossover_##S(int maxN) {                                                      \
+    int chosen = 0;                                                                \
+    printf("%-4s %6s %12s %12s\n", #S, "n", "blocked(s)", "1 level(s)");           \
+    for (int n = 128; n <= maxN; n *= 2) {                                         \
+        Matrix_##S *A = newMatrix_##S(n), *B = newMatrix_##S(n), *C = newMatrix_##S(n); \
+        for (size_t i = 0; i < (size_t)n * n; i++) {                               \
+            A->data[i] = RANDOM;                                                   \
+            B->data[i] = RANDOM;                                                   \
+        }                                                                          \
+        double blocked = 0, oneLevel = 0;                                          \
+        for (int r = 0; r < 3; r++) {                                              \
+            double t = wallTime();                                                 \
+            blockedMultiply_##S(n, n, n, A->data, n, B->data, n, C->data, n, 0);   \
+            t = wallTime() - t;                                                    \
+            if (r == 0 || t < blocked) blocked = t;                                \
+            cutoff_##S = n / 2;                                                    \
+            t = wallTime();                                                        \
+            strassen(n, A, B, C);                                                  \
+            t = wallTime() - t;                                                    \
+            if (r == 0 || t < oneLevel) oneLevel = t;                              \
+        }                                                                          \
+        printf("%-4s %6d %12.4f %12.4f\n", "", n, blocked, oneLevel);              \
+        freeMatrix_##S(A); freeMatrix_##S(B); freeMatrix_##S(C);                   \
+        if (oneLevel < 0.95 * blocked) {                                           \
+            if (chosen == 0) chosen = n / 2;                                       \
+        } else {                                                                   \
+            chosen = 0;                                                            \
+        }                                                                          \
+    }                                                                              \
+    cutoff_##S = chosen ? chosen : maxN;                                           \
+    printf("%-4s cutoff %d\n", "", cutoff_##S);                                    \
+    return cutoff_##S;                                                             \
 }
 
-int main() {
-    int n;
-    int A[MAX][MAX], B[MAX][MAX], C[MAX][MAX] = {0};
+DEFINE_CROSSOVER(int64_t, i64, rand() % 1000)
+DEFINE_CROSSOVER(float, f32, (float)rand() / RAND_MAX)
+DEFINE_CROSSOVER(double, f64, (double)rand() / RAND_MAX)
+
+int main(int argc, char **argv) {
+    // --bench [maxN] [naiveLimit]
+    if (argc > 1 && strcmp(argv[1], "--bench") == 0) {
+        int maxN = argc > 2 ? atoi(argv[2]) : 8192;
+        int naiveLimit = argc > 3 ? atoi(argv[3]) : 2048;
+        benchmark(maxN, naiveLimit);
+        return 0;
+    }
+    // --bench-cutoff [maxN]
+    if (argc > 1 && strcmp(argv[1], "--bench-cutoff") == 0) {
+        int maxN = argc > 2 ? atoi(argv[2]) : 2048;
+        crossover_i64(maxN);
+        crossover_f32(maxN);
+        crossover_f64(maxN);
+        return 0;
+    }
+    // --check: int64 products near the overflow bound
+    if (argc > 1 && strcmp(argv[1], "--check") == 0)
+        return overflowCheck() ? 1 : 0;
 
-    printf("Enter the size of matrix (power of 2): ");
+    int n;
+    printf("Enter the size of matrix: ");
     scanf("%d", &n);
 
+    Matrix_i64 *A = newMatrix_i64(n), *B = newMatrix_i64(n), *C = newMatrix_i64(n);
+
     printf("Enter elements of matrix A:\n");
-    for (int i = 0; i < n; i++)
-        for (int j = 0; j < n; j++)
-            scanf("%d", &A[i][j]);
+    for (int i = 0; i < n * n; i++)
+        scanf("%lld", (long long *)&A->data[i]);
 
     printf("Enter elements of matrix B:\n");
-    for (int i = 0; i < n; i++)
-        for (int j = 0; j < n; j++)
-            scanf("%d", &B[i][j]);
+    for (int i = 0; i < n * n; i++)
+        scanf("%lld", (long long *)&B->data[i]);
 
     strassen(n, A, B, C);
 
+    if (overflowDetected)
+        printf("\nWarning: some entries of the product do not fit in 64 bits.\n");
+
     printf("\nResultant Matrix (A × B):\n");
     for (int i = 0; i < n; i++) {
         for (int j = 0; j < n; j++)
-            printf("%d ", C[i][j]);
+            printf("%lld ", (long long)C->data[i*n + j]);
         printf("\n");
     }
 
+    freeMatrix_i64(A); freeMatrix_i64(B); freeMatrix_i64(C);
     return 0;
-}
\ No newline at end of file
+}
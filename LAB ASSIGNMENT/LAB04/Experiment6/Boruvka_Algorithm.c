@@ -0,0 +1,318 @@
+// ======= Boruvka's Algorithm - parallel Minimum Spanning Tree =======
+// Graph input: number of vertices, number of edges, then edges (u v w),
+// or a binary edge file as written by ./kruskal --gen.
+//
+// Every round, each component picks its lightest outgoing edge, all those
+// edges join the tree at once, and the graph is contracted: components
+// get new numbers 0 .. k-1 and edges that now lie inside a component are
+// dropped. The number of components at least halves per round, so there
+// are at most log2 V rounds, each touching arrays of only k entries. Every
+// step is a loop over edges or components that the threads split:
+//   1. for each edge, lower the best edge of both ends with a
+//      compare-and-swap on a packed (weight, position) key; the position
+//      breaks ties, so the chosen edges never form a cycle;
+//   2. each component adds its best edge through a lock-free union-find
+//      (a root is linked with a CAS on its parent; the edge two
+//      components both chose is added once);
+//   3. the roots are numbered with a prefix sum over the threads;
+//   4. each thread relabels and compacts its share of the edge list.
+// Disconnected graphs give a minimum spanning forest. Kruskal_Algorithm.c
+// is built in to check the result.
+//
+// Usage:
+//     gcc -O2 Boruvka_Algorithm.c -o boruvka -pthread
+//     ./boruvka                                interactive
+//     ./boruvka --bench file.bin|N [threads]   edge file, or a random graph
+//                                              with N vertices and 8N edges,
+//                                              on 1, 2, 4, ... threads
+
+#define main kruskalMain
+#include "Kruskal_Algorithm.c"
+#undef main
+
+#define NO_EDGE UINT64_MAX
+
+typedef struct {
+    int a, b;       // current components of the two ends
+    int w;
+    unsigned id;    // position in the input edge list
+} ContractedEdge;
+
+typedef struct {
+    int threads;
+    const CgEdge* input;
+    ContractedEdge* e;      // edges between two components, ends relabelled
+    long m;
+    int k;                  // components, numbered 0 .. k-1
+    int* parent;            // concurrent union-find over the components
+    int* label;             // new number of each root after the round
+    uint64_t* best;         // lightest edge of each component: weight key << 32 | position
+    long* kept;             // per thread: edges kept, then roots found
+    CgEdge* mst;
+    long count;             // edges in mst
+    int merged;             // unions in the current round
+    int done;
+    pthread_barrier_t barrier;
+} Boruvka;
+
+typedef struct {
+    Boruvka* b;
+    int id;
+} BoruvkaArg;
+
+int concurrentFind(int* parent, int x) {
+    int p;
+    while ((p = __atomic_load_n(&parent[x], __ATOMIC_ACQUIRE)) != x) {
+        int g = __atomic_load_n(&parent[p], __ATOMIC_ACQUIRE);
+        if (g != p)  // path halving; any ancestor is a valid parent
+            __atomic_compare_exchange_n(&parent[x], &p, g, 0, __ATOMIC_RELEASE, __ATOMIC_RELAXED);
+        x = p;
+    }
+    return x;
+}
+
+// Links the roots of a and b, the smaller index under the larger;
+// returns 0 if they are already in one set
+int concurrentUnite(int* parent, int a, int b) {
+    for (;;) {
+        a = concurrentFind(parent, a);
+        b = concurrentFind(parent, b);
+        if (a == b)
+            return 0;
+        if (a > b) {
+            int t = a;
+            a = b;
+            b = t;
+        }
+        int expected = a;
+        if (__atomic_compare_exchange_n(&parent[a], &expected, b, 0, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED))
+            return 1;
+    }
+}
+
+void atomicMinKey(uint64_t* p, uint64_t key) {
+    uint64_t old = __atomic_load_n(p, __ATOMIC_RELAXED);
+    while (key < old && !__atomic_compare_exchange_n(p, &old, key, 1, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+        ;
+}
+
+// One round is steps 1-4 of the header; the serial parts between them
+// are done by whichever thread the barrier picks
+void* boruvkaWorker(void* p) {
+    Boruvka* b = ((BoruvkaArg*)p)->b;
+    int id = ((BoruvkaArg*)p)->id, T = b->threads;
+
+    while (!b->done) {
+        int vlo = (int)((long)b->k * id / T), vhi = (int)((long)b->k * (id + 1) / T);
+        long elo = b->m * id / T, ehi = b->m * (id + 1) / T;
+        for (int c = vlo; c < vhi; c++) {
+            b->parent[c] = c;
+            b->best[c] = NO_EDGE;
+        }
+        pthread_barrier_wait(&b->barrier);
+
+        for (long i = elo; i < ehi; i++) {
+            uint64_t key = (uint64_t)weightKey(b->e[i].w) << 32 | (uint64_t)i;
+            atomicMinKey(&b->best[b->e[i].a], key);
+            atomicMinKey(&b->best[b->e[i].b], key);
+        }
+        pthread_barrier_wait(&b->barrier);
+
+        int merged = 0;
+        for (int c = vlo; c < vhi; c++) {
+            if (b->best[c] == NO_EDGE)
+                continue;
+            const ContractedEdge* x = &b->e[b->best[c] & 0xFFFFFFFFu];
+            if (concurrentUnite(b->parent, x->a, x->b)) {
+                b->mst[__atomic_fetch_add(&b->count, 1, __ATOMIC_RELAXED)] = b->input[x->id];
+                merged++;
+            }
+        }
+        __atomic_fetch_add(&b->merged, merged, __ATOMIC_RELAXED);
+        pthread_barrier_wait(&b->barrier);
+
+        // number the new components: each thread its roots, in order
+        long roots = 0;
+        for (int c = vlo; c < vhi; c++)
+            roots += concurrentFind(b->parent, c) == c;
+        b->kept[id] = roots;
+        if (pthread_barrier_wait(&b->barrier) == PTHREAD_BARRIER_SERIAL_THREAD) {
+            long sum = 0;
+            for (int t = 0; t < T; t++) {
+                long r = b->kept[t];
+                b->kept[t] = sum;
+                sum += r;
+            }
+            b->k = (int)sum;
+            b->done = b->merged == 0;
+            b->merged = 0;
+        }
+        pthread_barrier_wait(&b->barrier);
+        int next = (int)b->kept[id];
+        for (int c = vlo; c < vhi; c++)
+            if (b->parent[c] == c)
+                b->label[c] = next++;
+        pthread_barrier_wait(&b->barrier);
+
+        long kept = elo;
+        for (long i = elo; i < ehi; i++) {
+            ContractedEdge x = b->e[i];
+            x.a = b->label[concurrentFind(b->parent, x.a)];
+            x.b = b->label[concurrentFind(b->parent, x.b)];
+            if (x.a != x.b)
+                b->e[kept++] = x;
+        }
+        b->kept[id] = kept - elo;
+        if (pthread_barrier_wait(&b->barrier) == PTHREAD_BARRIER_SERIAL_THREAD) {
+            long m = b->kept[0];
+            for (int t = 1; t < T; t++) {
+                memmove(b->e + m, b->e + b->m * t / T, (size_t)b->kept[t] * sizeof(ContractedEdge));
+                m += b->kept[t];
+            }
+            b->m = m;
+            b->done |= m == 0;
+        }
+        pthread_barrier_wait(&b->barrier);
+    }
+    return NULL;
+}
+
+// Minimum spanning forest of the edges into mst (n - 1 slots); returns the
+// number of forest edges, or -1 if there are 2^32 edges or more
+long boruvka(int n, const CgEdge* e, long m, int threads, CgEdge* mst) {
+    if (threads < 1)
+        threads = 1;
+    if (m > 0xFFFFFFFFL)  // positions must fit the low half of a key
+        return -1;
+    Boruvka b;
+    b.threads = threads;
+    b.input = e;
+    b.e = (ContractedEdge*)malloc((size_t)(m > 0 ? m : 1) * sizeof(ContractedEdge));
+    b.m = 0;
+    for (long i = 0; i < m; i++)
+        if (e[i].u != e[i].v)
+            b.e[b.m++] = (ContractedEdge){ e[i].u, e[i].v, e[i].w, (unsigned)i };
+    b.k = n;
+    b.parent = (int*)malloc((size_t)(n > 0 ? n : 1) * sizeof(int));
+    b.label = (int*)malloc((size_t)(n > 0 ? n : 1) * sizeof(int));
+    b.best = (uint64_t*)malloc((size_t)(n > 0 ? n : 1) * sizeof(uint64_t));
+    b.kept = (long*)calloc(threads, sizeof(long));
+    b.mst = mst;
+    b.count = 0;
+    b.merged = 0;
+    b.done = b.m == 0;
+    pthread_barrier_init(&b.barrier, NULL, threads);
+
+    pthread_t* tid = (pthread_t*)malloc(threads * sizeof(pthread_t));
+    BoruvkaArg* args = (BoruvkaArg*)malloc(threads * sizeof(BoruvkaArg));
+    for (int t = 0; t < threads; t++) {
+        args[t] = (BoruvkaArg){ &b, t };
+        if (t > 0)
+            pthread_create(&tid[t], NULL, boruvkaWorker, &args[t]);
+    }
+    boruvkaWorker(&args[0]);
+    for (int t = 1; t < threads; t++)
+        pthread_join(tid[t], NULL);
+
+    pthread_barrier_destroy(&b.barrier);
+    free(tid);
+    free(args);
+    free(b.e);
+    free(b.parent);
+    free(b.label);
+    free(b.best);
+    free(b.kept);
+    return b.count;
+}
+
+int64_t forestCost(const CgEdge* mst, long count) {
+    int64_t cost = 0;
+    for (long i = 0; i < count; i++)
+        cost += mst[i].w;
+    return cost;
+}
+
+void boruvkaBenchmark(const char* arg, int maxThreads) {
+    int n;
+    long m;
+    CgEdge* edges;
+    char* end;
+    long nv = strtol(arg, &end, 10);
+    if (*end == '\0' && nv > 0) {
+        n = (int)nv;
+        m = 8 * nv;
+        edges = cg_random_edges(n, &m, 1000000, 42);
+    } else if ((edges = cg_read_edge_file(arg, &n, &m)) == NULL) {
+        printf("Cannot read edge file %s\n", arg);
+        return;
+    }
+    printf("%d vertices, %ld edges\n", n, m);
+    CgEdge* work = (CgEdge*)malloc((size_t)(m > 0 ? m : 1) * sizeof(CgEdge));
+    CgEdge* mst = (CgEdge*)malloc((size_t)(n > 1 ? n - 1 : 1) * sizeof(CgEdge));
+
+    memcpy(work, edges, (size_t)m * sizeof(CgEdge));
+    Forest f;
+    forestInit(&f, n);
+    double t = wallTime();
+    kruskal(&f, work, m, 0);
+    printf("%-16s %2d thread  %8.3f s  cost %lld, %ld edges\n", "Kruskal (radix)", 1, wallTime() - t,
+           (long long)f.cost, f.count);
+    free(work);
+
+    for (int threads = 1; threads <= maxThreads; threads *= 2) {
+        t = wallTime();
+        long count = boruvka(n, edges, m, threads, mst);
+        if (count < 0) {
+            printf("Too many edges for Boruvka\n");
+            break;
+        }
+        t = wallTime() - t;
+        int64_t cost = forestCost(mst, count);
+        printf("%-16s %2d thread%s %8.3f s  cost %lld, %ld edges%s\n", "Boruvka", threads, threads > 1 ? "s" : " ",
+               t, (long long)cost, count, cost != f.cost || count != f.count ? "  MISMATCH" : "");
+    }
+    forestFree(&f);
+    free(mst);
+    free(edges);
+}
+
+int main(int argc, char** argv) {
+    int cores = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    if (argc > 2 && strcmp(argv[1], "--bench") == 0) {
+        int threads = argc > 3 ? atoi(argv[3]) : cores;
+        boruvkaBenchmark(argv[2], threads > 0 ? threads : 1);
+        return 0;
+    }
+
+    int n, e;
+
+    printf("Enter number of vertices: ");
+    scanf("%d", &n);
+
+    printf("Enter number of edges: ");
+    scanf("%d", &e);
+
+    CgEdge* edges = (CgEdge*)malloc((size_t)(e > 0 ? e : 1) * sizeof(CgEdge));
+    long m = 0;
+    printf("\nEnter edges (u v w):\n");
+    for (int i = 0; i < e; i++) {
+        CgEdge x;
+        scanf("%d %d %d", &x.u, &x.v, &x.w);
+        if (x.u < 0 || x.v < 0 || x.u >= n || x.v >= n)
+            printf("Edge %d - %d skipped: no such vertex\n", x.u, x.v);
+        else
+            edges[m++] = x;
+    }
+
+    CgEdge* mst = (CgEdge*)malloc((size_t)(n > 1 ? n - 1 : 1) * sizeof(CgEdge));
+    long count = boruvka(n, edges, m, cores, mst);
+    printf("\nBoruvka's MST:\n");
+    for (long i = 0; i < count; i++)
+        printf("Edge: %d - %d  Cost: %d\n", mst[i].u, mst[i].v, mst[i].w);
+    printf("Total MST Cost = %lld\n", (long long)forestCost(mst, count));
+    if (count < n - 1)
+        printf("The graph is not connected: this is a spanning forest of %ld trees\n", n - count);
+    free(mst);
+    free(edges);
+    return 0;
+}
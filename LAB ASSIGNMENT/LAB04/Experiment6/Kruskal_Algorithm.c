@@ -1,55 +1,348 @@
 // ======= Kruskal's Algorithm - Minimum Spanning Tree =======
-// Graph input: number of vertices, number of edges, then edges (u v w)
+// Graph input: number of vertices, number of edges, then edges (u v w),
+// or a binary edge file (common/csr_graph.h) for large graphs.
+//
+// Edges are sorted with an LSD radix sort on the weight, and components are
+// tracked with a union-find using union by rank and path halving, so the
+// whole algorithm is O(E) for the sort plus O(E alpha(V)) for the scan.
+// If the graph is not connected the result is a minimum spanning forest.
+//
+// Filter-Kruskal (Osipov, Sanders, Singler) avoids sorting most edges:
+// it splits the edges around a pivot weight, solves the light half first,
+// then drops every heavy edge whose ends are already in one component
+// before recursing on the rest. The filter only reads the union-find, so
+// it runs on several threads at once.
+//
+// Usage:
+//     gcc -O2 Kruskal_Algorithm.c -o kruskal -pthread
+//     ./kruskal                                interactive
+//     ./kruskal --gen file.bin N M [maxW]      random connected graph with
+//                                              N vertices and M edges
+//     ./kruskal --bench file.bin|N [threads]   edge file, or a random graph
+//                                              with N vertices and 8N edges:
+//                                              qsort vs radix Kruskal vs
+//                                              Filter-Kruskal
 
 #include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include <unistd.h>
+#include "../../common/csr_graph.h"
 
-struct Edge {
-    int u, v, w;
-};
+#define RADIX_BITS 11
+#define FILTER_BASE (1L << 18)       // below this many edges, sort and scan
+#define PARALLEL_FILTER_MIN (1L << 18)
+#define QSORT_LIMIT 20000000L        // the qsort baseline is skipped above this
 
-int parent[100];
+/* ---------- Union-find ---------- */
+typedef struct {
+    int* parent;
+    unsigned char* rank;    // upper bound on the height, at most log2 V
+} DisjointSet;
 
-int find(int x) {
-    if (parent[x] == x) return x;
-    return parent[x] = find(parent[x]); // Path compression
+void dsInit(DisjointSet* ds, int n) {
+    ds->parent = (int*)malloc((size_t)(n > 0 ? n : 1) * sizeof(int));
+    ds->rank = (unsigned char*)calloc(n > 0 ? n : 1, 1);
+    for (int i = 0; i < n; i++)
+        ds->parent[i] = i;
 }
 
-void union_set(int a, int b) {
-    parent[find(a)] = find(b);
+void dsFree(DisjointSet* ds) {
+    free(ds->parent);
+    free(ds->rank);
 }
 
-void kruskal(struct Edge edges[], int n, int e) {
-    int i, j, totalCost = 0;
+int find(DisjointSet* ds, int x) {
+    while (ds->parent[x] != x) {
+        ds->parent[x] = ds->parent[ds->parent[x]];  // Path halving
+        x = ds->parent[x];
+    }
+    return x;
+}
 
-    // Initialize parent array
-    for (i = 0; i < n; i++)
-        parent[i] = i;
+// Read-only find: several threads may call it while nobody unites
+int findRoot(const DisjointSet* ds, int x) {
+    while (ds->parent[x] != x)
+        x = ds->parent[x];
+    return x;
+}
 
-    // Sort edges (Bubble sort by weight)
-    for (i = 0; i < e - 1; i++)
-        for (j = 0; j < e - i - 1; j++)
-            if (edges[j].w > edges[j + 1].w) {
-                struct Edge temp = edges[j];
-                edges[j] = edges[j + 1];
-                edges[j + 1] = temp;
-            }
+// Merges the sets of a and b; returns 0 if they were already one set
+int union_set(DisjointSet* ds, int a, int b) {
+    a = find(ds, a);
+    b = find(ds, b);
+    if (a == b)
+        return 0;
+    if (ds->rank[a] < ds->rank[b]) {
+        int t = a;
+        a = b;
+        b = t;
+    }
+    ds->parent[b] = a;
+    if (ds->rank[a] == ds->rank[b])
+        ds->rank[a]++;
+    return 1;
+}
 
-    printf("\nKruskal's MST:\n");
+/* ---------- Sorting ---------- */
+static unsigned weightKey(int w) {
+    return (unsigned)w ^ 0x80000000u;  // negative weights sort first
+}
 
-    for (i = 0; i < e; i++) {
-        if (find(edges[i].u) != find(edges[i].v)) {
-            printf("Edge: %d - %d  Cost: %d\n", edges[i].u, edges[i].v, edges[i].w);
-            totalCost += edges[i].w;
-            union_set(edges[i].u, edges[i].v);
+int compareEdges(const void* a, const void* b) {
+    int x = ((const CgEdge*)a)->w, y = ((const CgEdge*)b)->w;
+    return (x > y) - (x < y);
+}
+
+// LSD radix sort by weight, RADIX_BITS per pass; a pass where every edge
+// has the same digit is skipped, so small weights take one or two passes
+void sortByWeight(CgEdge* e, long m) {
+    enum { BUCKETS = 1 << RADIX_BITS, PASSES = (32 + RADIX_BITS - 1) / RADIX_BITS };
+    CgEdge* tmp = (CgEdge*)malloc((size_t)(m > 0 ? m : 1) * sizeof(CgEdge));
+    if (tmp == NULL) {
+        qsort(e, m, sizeof(CgEdge), compareEdges);
+        return;
+    }
+    long(*count)[BUCKETS] = calloc(PASSES, sizeof(*count));
+    for (long i = 0; i < m; i++) {
+        unsigned k = weightKey(e[i].w);
+        for (int p = 0; p < PASSES; p++)
+            count[p][(k >> (p * RADIX_BITS)) & (BUCKETS - 1)]++;
+    }
+    CgEdge *src = e, *dst = tmp;
+    for (int p = 0; p < PASSES; p++) {
+        int shift = p * RADIX_BITS;
+        if (m == 0 || count[p][(weightKey(src[0].w) >> shift) & (BUCKETS - 1)] == m)
+            continue;
+        long sum = 0;
+        for (int b = 0; b < BUCKETS; b++) {
+            long c = count[p][b];
+            count[p][b] = sum;
+            sum += c;
         }
+        for (long i = 0; i < m; i++)
+            dst[count[p][(weightKey(src[i].w) >> shift) & (BUCKETS - 1)]++] = src[i];
+        CgEdge* t = src;
+        src = dst;
+        dst = t;
     }
+    if (src != e)
+        memcpy(e, src, (size_t)m * sizeof(CgEdge));
+    free(count);
+    free(tmp);
+}
+
+/* ---------- Kruskal ---------- */
+typedef struct {
+    int n;
+    DisjointSet ds;
+    CgEdge* mst;        // at most n - 1 edges
+    long count;
+    int64_t cost;
+} Forest;
 
-    printf("Total MST Cost = %d\n", totalCost);
+void forestInit(Forest* f, int n) {
+    f->n = n;
+    dsInit(&f->ds, n);
+    f->mst = (CgEdge*)malloc((size_t)(n > 1 ? n - 1 : 1) * sizeof(CgEdge));
+    f->count = 0;
+    f->cost = 0;
 }
 
-int main() {
+void forestFree(Forest* f) {
+    dsFree(&f->ds);
+    free(f->mst);
+}
+
+// Adds the sorted edges that join two trees
+void scanEdges(Forest* f, const CgEdge* e, long m) {
+    for (long i = 0; i < m && f->count < f->n - 1; i++)
+        if (union_set(&f->ds, e[i].u, e[i].v)) {
+            f->mst[f->count++] = e[i];
+            f->cost += e[i].w;
+        }
+}
+
+// Sorts the edges in place (radix, or qsort for comparison)
+void kruskal(Forest* f, CgEdge* edges, long e, int useQsort) {
+    if (useQsort)
+        qsort(edges, e, sizeof(CgEdge), compareEdges);
+    else
+        sortByWeight(edges, e);
+    scanEdges(f, edges, e);
+}
+
+/* ---------- Filter-Kruskal ---------- */
+typedef struct {
+    const DisjointSet* ds;
+    CgEdge* e;
+    long lo, hi, kept;
+} FilterTask;
+
+// Keeps, at the front of its chunk, the edges joining two components
+void* filterChunk(void* arg) {
+    FilterTask* t = (FilterTask*)arg;
+    long k = t->lo;
+    for (long i = t->lo; i < t->hi; i++)
+        if (findRoot(t->ds, t->e[i].u) != findRoot(t->ds, t->e[i].v))
+            t->e[k++] = t->e[i];
+    t->kept = k - t->lo;
+    return NULL;
+}
+
+// Drops edges inside one component; returns how many are left
+long filterEdges(DisjointSet* ds, int n, CgEdge* e, long m, int threads) {
+    // point every vertex straight at its root first, so the filter reads
+    // one parent per endpoint instead of walking up the tree
+    if (m >= n)
+        for (int x = 0; x < n; x++)
+            ds->parent[x] = findRoot(ds, x);
+    if (m < PARALLEL_FILTER_MIN || threads < 2)
+        threads = 1;
+    FilterTask* task = (FilterTask*)malloc(threads * sizeof(FilterTask));
+    pthread_t* tid = (pthread_t*)malloc(threads * sizeof(pthread_t));
+    for (int t = 0; t < threads; t++) {
+        task[t] = (FilterTask){ ds, e, m * t / threads, m * (t + 1) / threads, 0 };
+        if (t > 0 && pthread_create(&tid[t], NULL, filterChunk, &task[t]) != 0)
+            task[t].ds = NULL;  // could not start: run it below
+    }
+    filterChunk(&task[0]);
+    long kept = task[0].kept;
+    for (int t = 1; t < threads; t++) {
+        if (task[t].ds == NULL) {
+            task[t].ds = ds;
+            filterChunk(&task[t]);
+        } else {
+            pthread_join(tid[t], NULL);
+        }
+        memmove(e + kept, e + task[t].lo, (size_t)task[t].kept * sizeof(CgEdge));
+        kept += task[t].kept;
+    }
+    free(task);
+    free(tid);
+    return kept;
+}
+
+// Moves edges with weight <= pivot to the front; returns their count
+long partitionEdges(CgEdge* e, long m, int pivot) {
+    long i = 0, j = m - 1;
+    while (1) {
+        while (i <= j && e[i].w <= pivot)
+            i++;
+        while (i <= j && e[j].w > pivot)
+            j--;
+        if (i >= j)
+            return i;
+        CgEdge t = e[i];
+        e[i] = e[j];
+        e[j] = t;
+    }
+}
+
+void filterKruskal(Forest* f, CgEdge* e, long m, int threads, unsigned long long* seed) {
+    while (m > 0 && f->count < f->n - 1) {
+        if (m <= FILTER_BASE) {
+            kruskal(f, e, m, 0);
+            return;
+        }
+        // median of three random weights
+        int a = e[cg_rand(seed) % m].w, b = e[cg_rand(seed) % m].w, c = e[cg_rand(seed) % m].w;
+        int pivot = a < b ? (b < c ? b : (a < c ? c : a)) : (a < c ? a : (b < c ? c : b));
+        long light = partitionEdges(e, m, pivot);
+        if (light == m) {  // every weight <= pivot: no progress possible
+            kruskal(f, e, m, 0);
+            return;
+        }
+        filterKruskal(f, e, light, threads, seed);
+        m -= light;
+        e += light;
+        m = filterEdges(&f->ds, f->n, e, m, threads);
+    }
+}
+
+/* ---------- Benchmark ---------- */
+double wallTime(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+void printMst(const Forest* f) {
+    printf("\nKruskal's MST:\n");
+    for (long i = 0; i < f->count; i++)
+        printf("Edge: %d - %d  Cost: %d\n", f->mst[i].u, f->mst[i].v, f->mst[i].w);
+    printf("Total MST Cost = %lld\n", (long long)f->cost);
+    if (f->count < f->n - 1)
+        printf("The graph is not connected: this is a spanning forest of %ld trees\n", f->n - f->count);
+}
+
+void benchmark(const char* arg, int threads) {
+    int n;
+    long m;
+    CgEdge* edges;
+    char* end;
+    long nv = strtol(arg, &end, 10);
+    if (*end == '\0' && nv > 0) {
+        n = (int)nv;
+        m = 8 * nv;
+        edges = cg_random_edges(n, &m, 1000000, 42);
+    } else if ((edges = cg_read_edge_file(arg, &n, &m)) == NULL) {
+        printf("Cannot read edge file %s\n", arg);
+        return;
+    }
+    printf("%d vertices, %ld edges, %d threads\n", n, m, threads);
+    CgEdge* work = (CgEdge*)malloc((size_t)(m > 0 ? m : 1) * sizeof(CgEdge));
+
+    const char* names[] = { "Kruskal (qsort)", "Kruskal (radix)", "Filter-Kruskal", "Filter-Kruskal" };
+    int64_t cost[4];
+    for (int run = 0; run < 4; run++) {
+        if (run == 0 && m > QSORT_LIMIT) {
+            cost[0] = -1;
+            continue;
+        }
+        int runThreads = run == 3 ? threads : 1;
+        if (run == 3 && threads < 2)
+            break;
+        memcpy(work, edges, (size_t)m * sizeof(CgEdge));
+        Forest f;
+        forestInit(&f, n);
+        unsigned long long seed = 7;
+        double t = wallTime();
+        if (run < 2)
+            kruskal(&f, work, m, run == 0);
+        else
+            filterKruskal(&f, work, m, runThreads, &seed);
+        t = wallTime() - t;
+        cost[run] = f.cost;
+        printf("%-16s %2d thread%s %8.3f s  cost %lld, %ld edges%s\n", names[run], runThreads,
+               runThreads > 1 ? "s" : " ", t, (long long)f.cost, f.count,
+               run > 1 && cost[1] != f.cost ? "  MISMATCH" : "");
+        forestFree(&f);
+    }
+    free(work);
+    free(edges);
+}
+
+int main(int argc, char** argv) {
+    if (argc > 4 && strcmp(argv[1], "--gen") == 0) {
+        int n = atoi(argv[3]);
+        long m = atol(argv[4]);
+        CgEdge* e = cg_random_edges(n, &m, argc > 5 ? atoi(argv[5]) : 1000000, 42);
+        if (cg_write_edge_file(argv[2], n, m, e) != 0)
+            printf("Cannot write %s\n", argv[2]);
+        free(e);
+        return 0;
+    }
+    if (argc > 2 && strcmp(argv[1], "--bench") == 0) {
+        int threads = argc > 3 ? atoi(argv[3]) : (int)sysconf(_SC_NPROCESSORS_ONLN);
+        benchmark(argv[2], threads > 0 ? threads : 1);
+        return 0;
+    }
+
     int n, e;
-    struct Edge edges[100];
 
     printf("Enter number of vertices: ");
     scanf("%d", &n);
@@ -57,10 +350,23 @@ int main() {
     printf("Enter number of edges: ");
     scanf("%d", &e);
 
+    CgEdge* edges = (CgEdge*)malloc((size_t)(e > 0 ? e : 1) * sizeof(CgEdge));
+    long m = 0;
     printf("\nEnter edges (u v w):\n");
-    for (int i = 0; i < e; i++)
-        scanf("%d %d %d", &edges[i].u, &edges[i].v, &edges[i].w);
+    for (int i = 0; i < e; i++) {
+        CgEdge x;
+        scanf("%d %d %d", &x.u, &x.v, &x.w);
+        if (x.u < 0 || x.v < 0 || x.u >= n || x.v >= n)
+            printf("Edge %d - %d skipped: no such vertex\n", x.u, x.v);
+        else
+            edges[m++] = x;
+    }
 
-    kruskal(edges, n, e);
+    Forest f;
+    forestInit(&f, n);
+    kruskal(&f, edges, m, 0);
+    printMst(&f);
+    forestFree(&f);
+    free(edges);
     return 0;
 }
@@ -1,45 +1,114 @@
 // ======= Prim's Algorithm - Minimum Spanning Tree =======
-// Graph input: number of vertices, number of edges, then edges (u v w)
+// Graph input: number of vertices, number of edges, then edges (u v w),
+// or a binary edge file as written by ./kruskal --gen.
+//
+// The graph is stored as CSR adjacency (common/csr_graph.h), every edge as
+// two arcs. best[v] is the lightest edge from the tree to v seen so far and
+// the vertices outside the tree wait in an indexed heap keyed by best[v]
+// (common/indexed_heap.h), so lowering best[v] is a decrease-key and the
+// whole run is O(E log V) instead of scanning every tree/non-tree pair.
+// When the heap runs dry the next vertex not yet in a tree starts a new
+// tree, so a disconnected graph gives a minimum spanning forest. Costs are
+// summed in 64 bits.
+//
+// Usage:
+//     gcc -O2 Prims_Algorithm.c -o prim -pthread
+//     ./prim                                interactive
+//     ./prim --bench file.bin|N             edge file, or a random graph
+//                                           with N vertices and 8N edges;
+//                                           checked against Kruskal
 
-#include <stdio.h>
-#define INF 999999
+#define main kruskalMain
+#include "Kruskal_Algorithm.c"
+#undef main
+#include "../../common/indexed_heap.h"
 
-void prim(int graph[100][100], int n) {
-    int selected[100] = {0};
-    int i, j, edgeCount = 0, totalCost = 0;
+// Minimum spanning forest of g into mst (n - 1 slots); returns its size
+long prim(const CsrGraph* g, CgEdge* mst, int64_t* totalCost) {
+    int n = g->n;
+    char* inTree = (char*)calloc(n > 0 ? n : 1, 1);
+    int* from = (int*)malloc((size_t)(n > 0 ? n : 1) * sizeof(int));
+    int64_t* best = (int64_t*)malloc((size_t)(n > 0 ? n : 1) * sizeof(int64_t));
+    IndexedHeap heap;
+    ih_init(&heap, n);
+    for (int v = 0; v < n; v++)
+        best[v] = INT64_MAX;
+    long count = 0;
+    *totalCost = 0;
 
-    selected[0] = 1; // Start from vertex 0
-
-    printf("\nPrim's MST:\n");
-
-    while (edgeCount < n - 1) {
-        int min = INF;
-        int x = 0, y = 0;
-
-        for (i = 0; i < n; i++) {
-            if (selected[i]) {
-                for (j = 0; j < n; j++) {
-                    if (!selected[j] && graph[i][j] < min) {
-                        min = graph[i][j];
-                        x = i;
-                        y = j;
-                    }
+    for (int root = 0; root < n; root++) {
+        if (inTree[root])
+            continue;
+        from[root] = -1;  // Start a new tree here
+        ih_push(&heap, root, 0);
+        while (!ih_empty(&heap)) {
+            int u = ih_pop(&heap);
+            inTree[u] = 1;
+            if (from[u] >= 0) {
+                mst[count++] = (CgEdge){ from[u], u, (int)best[u] };
+                *totalCost += best[u];
+            }
+            for (long a = g->offset[u]; a < g->offset[u + 1]; a++) {
+                int v = g->target[a];
+                if (!inTree[v] && g->weight[a] < best[v]) {
+                    best[v] = g->weight[a];
+                    from[v] = u;
+                    ih_push(&heap, v, best[v]);
                 }
             }
         }
+    }
+    ih_free(&heap);
+    free(inTree);
+    free(from);
+    free(best);
+    return count;
+}
 
-        printf("Edge: %d - %d  Cost: %d\n", x, y, graph[x][y]);
-        totalCost += graph[x][y];
-        selected[y] = 1;
-        edgeCount++;
+void primBenchmark(const char* arg) {
+    int n;
+    long m;
+    CgEdge* edges;
+    char* end;
+    long nv = strtol(arg, &end, 10);
+    if (*end == '\0' && nv > 0) {
+        n = (int)nv;
+        m = 8 * nv;
+        edges = cg_random_edges(n, &m, 1000000, 42);
+    } else if ((edges = cg_read_edge_file(arg, &n, &m)) == NULL) {
+        printf("Cannot read edge file %s\n", arg);
+        return;
     }
+    printf("%d vertices, %ld edges\n", n, m);
 
-    printf("Total MST Cost = %d\n", totalCost);
+    double t = wallTime();
+    CsrGraph g = cg_from_edges(n, m, edges, 1);
+    printf("%-16s %8.3f s\n", "CSR build", wallTime() - t);
+    CgEdge* mst = (CgEdge*)malloc((size_t)(n > 1 ? n - 1 : 1) * sizeof(CgEdge));
+    int64_t cost;
+    t = wallTime();
+    long count = prim(&g, mst, &cost);
+    printf("%-16s %8.3f s  cost %lld, %ld edges\n", "Prim", wallTime() - t, (long long)cost, count);
+    cg_free(&g);
+    free(mst);
+
+    Forest f;
+    forestInit(&f, n);
+    t = wallTime();
+    kruskal(&f, edges, m, 0);
+    printf("%-16s %8.3f s  cost %lld, %ld edges%s\n", "Kruskal (radix)", wallTime() - t, (long long)f.cost,
+           f.count, f.cost != cost || f.count != count ? "  MISMATCH" : "");
+    forestFree(&f);
+    free(edges);
 }
 
-int main() {
+int main(int argc, char** argv) {
+    if (argc > 2 && strcmp(argv[1], "--bench") == 0) {
+        primBenchmark(argv[2]);
+        return 0;
+    }
+
     int n, e;
-    int graph[100][100];
 
     printf("Enter number of vertices: ");
     scanf("%d", &n);
@@ -47,19 +116,31 @@ int main() {
     printf("Enter number of edges: ");
     scanf("%d", &e);
 
-    // Initialize graph with INF
-    for (int i = 0; i < n; i++)
-        for (int j = 0; j < n; j++)
-            graph[i][j] = INF;
-
+    CgEdge* edges = (CgEdge*)malloc((size_t)(e > 0 ? e : 1) * sizeof(CgEdge));
+    long m = 0;
     printf("\nEnter edges (u v w):\n");
     for (int i = 0; i < e; i++) {
-        int u, v, w;
-        scanf("%d %d %d", &u, &v, &w);
-        graph[u][v] = w;
-        graph[v][u] = w;
+        CgEdge x;
+        scanf("%d %d %d", &x.u, &x.v, &x.w);
+        if (x.u < 0 || x.v < 0 || x.u >= n || x.v >= n)
+            printf("Edge %d - %d skipped: no such vertex\n", x.u, x.v);
+        else
+            edges[m++] = x;
     }
+    CsrGraph graph = cg_from_edges(n, m, edges, 1);
+    free(edges);
+
+    CgEdge* mst = (CgEdge*)malloc((size_t)(n > 1 ? n - 1 : 1) * sizeof(CgEdge));
+    int64_t totalCost;
+    long count = prim(&graph, mst, &totalCost);
 
-    prim(graph, n);
+    printf("\nPrim's MST:\n");
+    for (long i = 0; i < count; i++)
+        printf("Edge: %d - %d  Cost: %d\n", mst[i].u, mst[i].v, mst[i].w);
+    printf("Total MST Cost = %lld\n", (long long)totalCost);
+    if (count < n - 1)
+        printf("The graph is not connected: this is a spanning forest of %ld trees\n", n - count);
+    free(mst);
+    cg_free(&graph);
     return 0;
 }
@@ -1,24 +1,248 @@
 #include <stdio.h>
+#include <stdlib.h>
 #include <stdbool.h>
 #include <string.h>
+#include <time.h>
+#include "../common/csr_graph.h"
 
-#define MAX 100
+/*
+   Maximum bipartite matching with Hopcroft-Karp.
 
-int graph[MAX][MAX];   // adjacency matrix
-int matchR[MAX];       // match result for right set
-bool seen[MAX];
+   The graph is CSR adjacency from the left vertices 0 .. nL-1 to the
+   right vertices 0 .. nR-1. The matching is first seeded with Karp-Sipser:
+   a vertex with one free neighbour left is matched to it (that is always
+   safe), and only when there is no such vertex is an arbitrary edge
+   taken. On sparse graphs this alone matches nearly everything.
 
-int nL, nR;            // sizes of left and right sets
+   Each Hopcroft-Karp phase then runs a BFS from all free left vertices,
+   layering the graph by the length of alternating paths, and stops at the
+   layer where the first free right vertex appears. A DFS along the layers
+   finds a maximal set of vertex-disjoint shortest augmenting paths; dead
+   ends are cut off so every arc is tried at most once per phase. There
+   are O(sqrt V) phases, so the whole run is O(E sqrt V). The DFS keeps
+   its own stack, so long augmenting paths cannot overflow the C stack.
 
-// DFS to find augmenting path
-bool bpm(int u) {
-    for (int v = 0; v < nR; v++) {
-        if (graph[u][v] && !seen[v]) {
+   Usage:
+       gcc -O2 Maximum_Bipartite_Matching.c -o matching
+       ./matching                           interactive (adjacency matrix)
+       ./matching --bench nL nR [degree]    random graph, each left vertex
+                                            with 1 .. 2*degree - 1 random
+                                            neighbours (default 3)
+*/
+
+#define NOT_LAYERED -1
+#define SIMPLE_LIMIT 5000   // largest side checked with the simple DFS
+
+typedef struct {
+    int nL, nR;
+    const CsrGraph* g;      // left -> right
+    int* matchL;            // right partner of each left vertex, -1 if free
+    int* matchR;            // left partner of each right vertex, -1 if free
+    int* dist;              // BFS layer of each left vertex
+    int freeLayer;          // layer whose vertices reach a free right vertex
+    int* queue;
+    long* next;             // next arc the DFS tries from each left vertex
+    int* stack;
+    int phases;
+} Matching;
+
+void matchingInit(Matching* M, const CsrGraph* g, int nR) {
+    int nL = g->n;
+    M->nL = nL;
+    M->nR = nR;
+    M->g = g;
+    M->matchL = (int*)malloc((size_t)(nL > 0 ? nL : 1) * sizeof(int));
+    M->matchR = (int*)malloc((size_t)(nR > 0 ? nR : 1) * sizeof(int));
+    M->dist = (int*)malloc((size_t)(nL > 0 ? nL : 1) * sizeof(int));
+    M->queue = (int*)malloc((size_t)(nL > 0 ? nL : 1) * sizeof(int));
+    M->next = (long*)malloc((size_t)(nL > 0 ? nL : 1) * sizeof(long));
+    M->stack = (int*)malloc((size_t)(nL > 0 ? nL : 1) * sizeof(int));
+    memset(M->matchL, -1, (size_t)nL * sizeof(int));
+    memset(M->matchR, -1, (size_t)nR * sizeof(int));
+    M->phases = 0;
+}
+
+void matchingFree(Matching* M) {
+    free(M->matchL);
+    free(M->matchR);
+    free(M->dist);
+    free(M->queue);
+    free(M->next);
+    free(M->stack);
+}
+
+/* ---------- Karp-Sipser initialization ---------- */
+// Vertices are numbered 0 .. nL-1 (left) and nL .. nL+nR-1 (right) here
+static void removeVertex(Matching* M, const CsrGraph* adjL, const CsrGraph* adjR, int x, int* deg, int* queue,
+                         int* tail) {
+    int nL = M->nL;
+    const CsrGraph* adj = x < nL ? adjL : adjR;
+    int self = x < nL ? x : x - nL;
+    for (long a = adj->offset[self]; a < adj->offset[self + 1]; a++) {
+        int y = x < nL ? nL + adj->target[a] : adj->target[a];
+        bool free = y < nL ? M->matchL[y] < 0 : M->matchR[y - nL] < 0;
+        if (free && --deg[y] == 1)
+            queue[(*tail)++] = y;
+    }
+}
+
+static void matchPair(Matching* M, const CsrGraph* adjR, int u, int v, int* deg, int* queue, int* tail) {
+    M->matchL[u] = v;
+    M->matchR[v] = u;
+    removeVertex(M, M->g, adjR, u, deg, queue, tail);
+    removeVertex(M, M->g, adjR, M->nL + v, deg, queue, tail);
+}
+
+// Returns the number of pairs matched
+int karpSipser(Matching* M) {
+    const CsrGraph* g = M->g;
+    int nL = M->nL, nR = M->nR, matched = 0;
+    CgEdge* rev = (CgEdge*)malloc((size_t)(g->m > 0 ? g->m : 1) * sizeof(CgEdge));
+    for (int u = 0; u < nL; u++)
+        for (long a = g->offset[u]; a < g->offset[u + 1]; a++)
+            rev[a] = (CgEdge){ g->target[a], u, 0 };
+    CsrGraph adjR = cg_from_edges(nR, g->m, rev, 0);
+    free(rev);
+
+    // each vertex enters the queue at most once per degree drop, and a
+    // degree drops once per arc, so V + 2E slots are enough
+    long cap = (long)nL + nR + 2 * g->m;
+    int* deg = (int*)malloc((size_t)(nL + nR > 0 ? nL + nR : 1) * sizeof(int));
+    int* queue = (int*)malloc((size_t)(cap > 0 ? cap : 1) * sizeof(int));
+    int head = 0, tail = 0, scan = 0;
+    for (int x = 0; x < nL + nR; x++) {
+        deg[x] = (int)(x < nL ? g->offset[x + 1] - g->offset[x] : adjR.offset[x - nL + 1] - adjR.offset[x - nL]);
+        if (deg[x] == 1)
+            queue[tail++] = x;
+    }
+
+    for (;;) {
+        int x = -1;
+        if (head < tail) {
+            x = queue[head++];
+        } else {
+            // no degree-1 vertex: take any free left vertex with a free neighbour
+            while (scan < nL && (M->matchL[scan] >= 0 || deg[scan] == 0))
+                scan++;
+            if (scan == nL)
+                break;
+            x = scan;
+        }
+        bool isLeft = x < nL;
+        int self = isLeft ? x : x - nL;
+        if ((isLeft ? M->matchL[self] : M->matchR[self]) >= 0 || deg[x] == 0)
+            continue;
+        const CsrGraph* adj = isLeft ? g : &adjR;
+        for (long a = adj->offset[self]; a < adj->offset[self + 1]; a++) {
+            int y = adj->target[a];
+            if ((isLeft ? M->matchR[y] : M->matchL[y]) < 0) {
+                if (isLeft)
+                    matchPair(M, &adjR, self, y, deg, queue, &tail);
+                else
+                    matchPair(M, &adjR, y, self, deg, queue, &tail);
+                matched++;
+                break;
+            }
+        }
+    }
+    free(deg);
+    free(queue);
+    cg_free(&adjR);
+    return matched;
+}
+
+/* ---------- Hopcroft-Karp ---------- */
+// Layers the left vertices from the free ones, up to the first layer that
+// reaches a free right vertex; returns true if there is one
+bool bfs(Matching* M) {
+    const CsrGraph* g = M->g;
+    int head = 0, tail = 0, found = NOT_LAYERED;
+    for (int u = 0; u < M->nL; u++) {
+        if (M->matchL[u] < 0) {
+            M->dist[u] = 0;
+            M->queue[tail++] = u;
+        } else {
+            M->dist[u] = NOT_LAYERED;
+        }
+    }
+    while (head < tail) {
+        int u = M->queue[head++];
+        if (found != NOT_LAYERED && M->dist[u] >= found)
+            break;  // deeper layers cannot hold a shortest augmenting path
+        for (long a = g->offset[u]; a < g->offset[u + 1]; a++) {
+            int w = M->matchR[g->target[a]];
+            if (w < 0) {
+                found = M->dist[u];
+            } else if (found == NOT_LAYERED && M->dist[w] == NOT_LAYERED) {
+                M->dist[w] = M->dist[u] + 1;
+                M->queue[tail++] = w;
+            }
+        }
+    }
+    M->freeLayer = found;
+    return found != NOT_LAYERED;
+}
+
+// Looks for a shortest augmenting path from the free left vertex root along
+// the layers and flips it; vertices found to be dead ends leave the layering
+bool augment(Matching* M, int root) {
+    const CsrGraph* g = M->g;
+    int top = 0;
+    M->stack[top++] = root;
+    while (top > 0) {
+        int u = M->stack[top - 1];
+        if (M->next[u] == g->offset[u + 1]) {
+            M->dist[u] = NOT_LAYERED;  // dead end
+            if (--top > 0)
+                M->next[M->stack[top - 1]]++;
+            continue;
+        }
+        int v = g->target[M->next[u]];
+        int w = M->matchR[v];
+        if (w < 0 && M->dist[u] == M->freeLayer) {
+            // stack[0] .. stack[top-1] each take the right vertex they point at
+            for (int i = top - 1; i >= 0; i--) {
+                int x = M->stack[i], y = g->target[M->next[x]];
+                M->matchR[y] = x;
+                M->matchL[x] = y;
+                M->dist[x] = NOT_LAYERED;  // vertex-disjoint paths per phase
+            }
+            return true;
+        }
+        if (w >= 0 && M->dist[u] < M->freeLayer && M->dist[w] == M->dist[u] + 1)
+            M->stack[top++] = w;
+        else
+            M->next[u]++;
+    }
+    return false;
+}
+
+// Maximum matching size, starting from whatever matching M holds
+int hopcroftKarp(Matching* M) {
+    int size = 0;
+    for (int u = 0; u < M->nL; u++)
+        size += M->matchL[u] >= 0;
+    while (bfs(M)) {
+        M->phases++;
+        for (int u = 0; u < M->nL; u++)
+            M->next[u] = M->g->offset[u];
+        for (int u = 0; u < M->nL; u++)
+            if (M->matchL[u] < 0 && M->dist[u] == 0 && augment(M, u))
+                size++;
+    }
+    return size;
+}
+
+/* ---------- Simple DFS (the original algorithm), for checking ---------- */
+bool bpm(const CsrGraph* g, int u, int* matchR, bool* seen) {
+    for (long a = g->offset[u]; a < g->offset[u + 1]; a++) {
+        int v = g->target[a];
+        if (!seen[v]) {
             seen[v] = true;
 
             // If right vertex is not assigned or previous left
-            // vertex for right vertex has alternate match 
-            if (matchR[v] < 0 || bpm(matchR[v])) {
+            // vertex for right vertex has alternate match
+            if (matchR[v] < 0 || bpm(g, matchR[v], matchR, seen)) {
                 matchR[v] = u;
                 return true;
             }
@@ -27,44 +251,133 @@ bool bpm(int u) {
     return false;
 }
 
-int maxBPM() {
-    // Initialize all right vertices as unmatched
-    memset(matchR, -1, sizeof(matchR));
+int maxBPM(const CsrGraph* g, int nR) {
+    int* matchR = (int*)malloc((size_t)(nR > 0 ? nR : 1) * sizeof(int));
+    bool* seen = (bool*)malloc((size_t)(nR > 0 ? nR : 1) * sizeof(bool));
+    memset(matchR, -1, (size_t)nR * sizeof(int));
     int result = 0;
+    for (int u = 0; u < g->n; u++) {
+        memset(seen, 0, (size_t)nR * sizeof(bool));
+        if (bpm(g, u, matchR, seen))
+            result++;
+    }
+    free(matchR);
+    free(seen);
+    return result;
+}
 
-    // Try to match each vertex in left set
-    for (int u = 0; u < nL; u++) {
-        memset(seen, 0, sizeof(seen));
+/* ---------- Benchmark ---------- */
+double wallTime(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
 
-        if (bpm(u)) {
-            result++;
+// Every matched pair must be an edge, and the two match arrays must agree
+bool validMatching(const Matching* M) {
+    for (int u = 0; u < M->nL; u++) {
+        int v = M->matchL[u];
+        if (v < 0)
+            continue;
+        if (M->matchR[v] != u)
+            return false;
+        bool edge = false;
+        for (long a = M->g->offset[u]; a < M->g->offset[u + 1] && !edge; a++)
+            edge = M->g->target[a] == v;
+        if (!edge)
+            return false;
+    }
+    return true;
+}
+
+void benchmark(int nL, int nR, int degree) {
+    unsigned long long seed = 2024;
+    long m = 0, cap = (long)nL * degree;
+    CgEdge* e = (CgEdge*)malloc((size_t)(cap > 0 ? cap : 1) * sizeof(CgEdge));
+    for (int u = 0; u < nL; u++) {
+        int d = 1 + (int)(cg_rand(&seed) % (2 * degree - 1));
+        for (int i = 0; i < d; i++) {
+            if (m == cap) {
+                cap *= 2;
+                e = (CgEdge*)realloc(e, (size_t)cap * sizeof(CgEdge));
+            }
+            e[m++] = (CgEdge){ u, (int)(cg_rand(&seed) % nR), 0 };
         }
     }
-    return result;
+    CsrGraph g = cg_from_edges(nL, m, e, 0);
+    free(e);
+    printf("%d + %d vertices, %ld edges\n", nL, nR, m);
+
+    int sizes[2];
+    for (int init = 0; init < 2; init++) {
+        Matching M;
+        matchingInit(&M, &g, nR);
+        double t = wallTime();
+        int seeded = init ? karpSipser(&M) : 0;
+        double tInit = wallTime() - t;
+        int size = sizes[init] = hopcroftKarp(&M);
+        t = wallTime() - t;
+        printf("%-24s %8.3f s (init %.3f s, %d pairs), %d phases, matching %d%s%s\n",
+               init ? "Karp-Sipser + HK" : "Hopcroft-Karp", t, tInit, seeded, M.phases, size,
+               validMatching(&M) ? "" : "  INVALID", init && size != sizes[0] ? "  MISMATCH" : "");
+        matchingFree(&M);
+    }
+    if (nL <= SIMPLE_LIMIT && nR <= SIMPLE_LIMIT) {
+        double t = wallTime();
+        int size = maxBPM(&g, nR);
+        printf("%-24s %8.3f s, matching %d%s\n", "simple DFS", wallTime() - t, size,
+               size != sizes[0] || size != sizes[1] ? "  MISMATCH" : "");
+    }
+    cg_free(&g);
 }
 
-int main() {
+int main(int argc, char** argv) {
+    if (argc > 3 && strcmp(argv[1], "--bench") == 0) {
+        int nL = atoi(argv[2]), nR = atoi(argv[3]), degree = argc > 4 ? atoi(argv[4]) : 3;
+        if (nL > 0 && nR > 0 && degree > 0)
+            benchmark(nL, nR, degree);
+        return 0;
+    }
+
+    int nL, nR;
     printf("Enter number of vertices in Left set: ");
     scanf("%d", &nL);
     printf("Enter number of vertices in Right set: ");
     scanf("%d", &nR);
 
+    long m = 0, cap = 16;
+    CgEdge* edges = (CgEdge*)malloc(cap * sizeof(CgEdge));
     printf("\nEnter adjacency matrix (%d x %d):\n", nL, nR);
     for (int i = 0; i < nL; i++) {
         for (int j = 0; j < nR; j++) {
-            scanf("%d", &graph[i][j]);
+            int x;
+            scanf("%d", &x);
+            if (!x)
+                continue;
+            if (m == cap) {
+                cap *= 2;
+                edges = (CgEdge*)realloc(edges, cap * sizeof(CgEdge));
+            }
+            edges[m++] = (CgEdge){ i, j, 1 };
         }
     }
+    CsrGraph graph = cg_from_edges(nL, m, edges, 0);
+    free(edges);
 
-    int result = maxBPM();
+    Matching M;
+    matchingInit(&M, &graph, nR);
+    karpSipser(&M);
+    int result = hopcroftKarp(&M);
     printf("\nMaximum Bipartite Matching = %d\n", result);
 
     printf("\nMatched pairs (Left -> Right):\n");
     for (int v = 0; v < nR; v++) {
-        if (matchR[v] != -1) {
-            printf("L%d -> R%d\n", matchR[v], v);
+        if (M.matchR[v] != -1) {
+            printf("L%d -> R%d\n", M.matchR[v], v);
         }
     }
 
+    matchingFree(&M);
+    cg_free(&graph);
     return 0;
 }
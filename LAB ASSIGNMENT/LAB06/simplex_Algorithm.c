@@ -2,6 +2,7 @@
 #include <stdlib.h>
 #include <float.h>
 #include <math.h>
+#include "../common/dense_kernels.h"
 
 #define EPS 1e-9
 
@@ -16,15 +17,16 @@ void print_tableau(double **T, int rows, int cols) {
     printf("\n");
 }
 
-/* Allocate 2D array */
+/* Allocate 2D array: one contiguous block with row pointers */
 double **alloc_tableau(int rows, int cols) {
     double **T = malloc(rows * sizeof(double *));
-    for (int i = 0; i < rows; ++i) T[i] = calloc(cols, sizeof(double));
+    T[0] = calloc((size_t)rows * cols, sizeof(double));
+    for (int i = 1; i < rows; ++i) T[i] = T[0] + (size_t)i * cols;
     return T;
 }
 
-void free_tableau(double **T, int rows) {
-    for (int i = 0; i < rows; ++i) free(T[i]);
+void free_tableau(double **T) {
+    free(T[0]);
     free(T);
 }
 
@@ -67,15 +69,17 @@ void pivot(double **T, int rows, int cols, int r, int c) {
     double pivot = T[r][c];
     // normalize pivot row
     for (int j = 0; j < cols; ++j) T[r][j] /= pivot;
-    // eliminate other rows
+    // eliminate other rows: T -= f * T[r], a rank-1 update with f[r] = 0
+    double *f = malloc(rows * sizeof(double));
     for (int i = 0; i < rows; ++i) {
-        if (i == r) continue;
         double factor = T[i][c];
-        if (fabs(factor) < EPS) continue;
-        for (int j = 0; j < cols; ++j) {
-            T[i][j] -= factor * T[r][j];
-        }
+        f[i] = (i == r || fabs(factor) < EPS) ? 0.0 : factor;
     }
+    double *pivotRow = malloc(cols * sizeof(double));
+    for (int j = 0; j < cols; ++j) pivotRow[j] = T[r][j];
+    dk_dger(rows, cols, -1.0, f, pivotRow, T[0], cols);
+    free(pivotRow);
+    free(f);
 }
 
 /* Simplex main routine. T is tableau with rows = m+1, cols = n+m+1
@@ -204,7 +208,7 @@ int main() {
     // cleanup
     for (int i = 0; i < m; ++i) free(A[i]);
     free(A); free(b); free(c); free(basicVars);
-    free_tableau(T, rows);
+    free_tableau(T);
 
     return 0;
 }
@@ -13,6 +13,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <math.h>
+#include "../../common/dense_kernels.h"
 
 #define EPS     1e-6
 #define MAX_IT  2000
@@ -26,24 +27,26 @@ double dot(double *a, double *b, int n) {
     return r;
 }
 
-/* Matrix-vector multiplication: y = M * x */
+/* Matrix-vector multiplication: y = M * x (M from alloc_mat) */
 void mat_vec(double **M, double *x, double *y, int n) {
-    for (int i = 0; i < n; i++) {
-        y[i] = dot(M[i], x, n);
-    }
+    dk_dgemv(n, n, 1.0, M[0], n, x, 0.0, y);
 }
 
-/* Allocate matrix */
-double **alloc_mat(int n) {
-    double **M = (double**)malloc(n * sizeof(double*));
-    for (int i = 0; i < n; i++)
-        M[i] = (double*)calloc(n, sizeof(double));
+/* Allocate rows x cols matrix: one contiguous block with row pointers */
+double **alloc_rect(int rows, int cols) {
+    double **M = (double**)malloc(rows * sizeof(double*));
+    M[0] = (double*)calloc((size_t)rows * cols, sizeof(double));
+    for (int i = 1; i < rows; i++)
+        M[i] = M[0] + (size_t)i * cols;
     return M;
 }
 
-void free_mat(double **M, int n) {
-    for (int i = 0; i < n; i++)
-        free(M[i]);
+double **alloc_mat(int n) {
+    return alloc_rect(n, n);
+}
+
+void free_mat(double **M) {
+    free(M[0]);
     free(M);
 }
 
@@ -86,11 +89,11 @@ int ellipsoid_feasible(double **A, double *b, int m, int n,
 
         // update ellipsoid matrix E = (n^2 / (n^2 - 1)) * (E - (2/(n+1)) * Eg*Eg^T/gtEg)
         double factor = 2.0 / ((double)n + 1);
+        double scale = (double)n * n / (n * n - 1.0);
 
-        for (int i = 0; i < n; i++)
-            for (int j = 0; j < n; j++)
-                E[i][j] = ((double)n * n / (n * n - 1.0)) *
-                          (E[i][j] - factor * (Eg[i] * Eg[j]) / gtEg);
+        dk_dger(n, n, -factor / gtEg, Eg, Eg, E[0], n);
+        for (int i = 0; i < n * n; i++)
+            E[0][i] *= scale;
 
         free(Eg);
     }
@@ -110,7 +113,7 @@ void ellipsoid_lp(double **A, double *b, double *c, int m, int n) {
         double mid = (low + high) / 2.0;
 
         // Convert optimization to feasibility: A x <= b and c^T x >= mid
-        double **A2 = alloc_mat(m + 1);
+        double **A2 = (double**)malloc((m + 1) * sizeof(double*));
         double *b2 = malloc((m + 1) * sizeof(double));
 
         for (int i = 0; i < m; i++) {
@@ -133,7 +136,7 @@ void ellipsoid_lp(double **A, double *b, double *c, int m, int n) {
 
         int feasible = ellipsoid_feasible(A2, b2, m+1, n, x, E);
 
-        free_mat(E, n);
+        free_mat(E);
         free(b2);
         free(A2[m]);
         free(A2);
@@ -167,7 +170,7 @@ int main() {
     printf("Enter number of variables (n): ");
     scanf("%d", &n);
 
-    double **A = alloc_mat(m);
+    double **A = alloc_rect(m, n);
     double *b = malloc(m * sizeof(double));
     double *c = malloc(n * sizeof(double));
 
@@ -186,7 +189,7 @@ int main() {
 
     ellipsoid_lp(A, b, c, m, n);
 
-    free_mat(A, m);
+    free_mat(A);
     free(b);
     free(c);
 
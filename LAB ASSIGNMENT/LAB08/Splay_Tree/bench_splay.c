@@ -0,0 +1,66 @@
+/*
+   Ordered index benchmark for the splay tree (see common/index_bench.h).
+   Lookups splay the key to the root; a range scan splays its lower bound
+   and then walks the keys that follow it.
+
+   Usage:
+       gcc -O2 bench_splay.c -o bench_splay -pthread -lm
+       ./bench_splay [--n 1000,100000,1000000] [--ops N] [--workload ...]
+*/
+#define main splay_main
+#include "splay_tree.c"
+#undef main
+#include "../../common/index_bench.h"
+
+Node* root = NULL;
+
+void ib_reset(void) {
+    np_destroy(&pool);
+    np_init(&pool, 0);
+    root = NULL;
+}
+
+void ib_insert(int key) { root = insert(root, key); }
+
+void ib_erase(int key) { root = delete(root, key); }
+
+int ib_find(int key) {
+    root = splay(root, key);
+    return root != NULL && root->key == key;
+}
+
+long ib_range(int lo, int hi) {
+    static Node** stack = NULL;
+    static int cap = 0;
+    int top = 0;
+    long count = 0;
+    root = splay(root, lo);
+    Node* n = root;
+    while (1) {
+        while (n != NULL) {
+            if (n->key < lo) {
+                n = n->right;
+                continue;
+            }
+            if (top == cap) {
+                cap = cap ? 2 * cap : 64;
+                stack = (Node**)realloc(stack, cap * sizeof(Node*));
+            }
+            stack[top++] = n;
+            n = n->left;
+        }
+        if (top == 0)
+            break;
+        n = stack[--top];
+        if (n->key >= hi)
+            break;
+        count++;
+        n = n->right;
+    }
+    return count;
+}
+
+int main(int argc, char** argv) {
+    np_init(&pool, 0);
+    return ib_main(argc, argv, "splay", 0);
+}
@@ -1,24 +1,75 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <limits.h>
+#include <pthread.h>
+#include "../../common/node_pool.h"
 
 typedef struct node {
     int key;
+    int size;       // nodes in this subtree, for rank / select
     struct node *left, *right;
 } Node;
 
+/* Nodes are carved from slabs and recycled through the pool's free list */
+NodePool pool;
+
+/* ---------- Access policy and statistics ---------- */
+// search() restructures the tree only on every splayEvery-th call; the
+// other calls use the read-only find(). semiSplay selects semi-splaying.
+int splayEvery = 1;
+int semiSplay = 0;
+long accessCount = 0;
+
+typedef struct {
+    long ops;         // accesses (search / insert / delete)
+    long depthSum;    // nodes on the access paths
+    long maxDepth;
+    long rotations;
+    long writes;      // child pointers written while restructuring
+} SplayStats;
+
+_Thread_local SplayStats stats;
+
+void recordDepth(long depth) {
+    stats.ops++;
+    stats.depthSum += depth;
+    if (depth > stats.maxDepth)
+        stats.maxDepth = depth;
+}
+
 /* ---------- Utility Function ---------- */
 Node* newNode(int key) {
-    Node* n = (Node*)malloc(sizeof(Node));
+    Node* n = (Node*)np_alloc(&pool, sizeof(Node));
+    if (n == NULL) {
+        printf("Memory allocation failed\n");
+        exit(1);
+    }
     n->key = key;
+    n->size = 1;
     n->left = n->right = NULL;
     return n;
 }
 
+int size(Node* n) {
+    return n ? n->size : 0;
+}
+
+void update(Node* n) {
+    n->size = size(n->left) + size(n->right) + 1;
+}
+
 /* ---------- Rotations ---------- */
 Node* rightRotate(Node* x) {
     Node* y = x->left;
     x->left = y->right;
     y->right = x;
+    update(x);
+    update(y);
+    stats.rotations++;
+    stats.writes += 2;
     return y;
 }
 
@@ -26,53 +77,148 @@ Node* leftRotate(Node* x) {
     Node* y = x->right;
     x->right = y->left;
     y->left = x;
+    update(x);
+    update(y);
+    stats.rotations++;
+    stats.writes += 2;
     return y;
 }
 
 /* ---------- Splay Operation ---------- */
+// Top-down splay (Sleator and Tarjan). Walking down from the root, nodes
+// smaller than key are hung off the right end of a left tree and larger
+// nodes off the left end of a right tree; a zig-zig does one rotation
+// first. When the walk stops, the node reached becomes the root with the
+// two trees as its subtrees. No recursion, so deep trees are fine.
+// Sizes of the linked nodes are only known at the end; lsize / rsize
+// count the left and right trees and are handed down their spines.
 Node* splay(Node* root, int key) {
-    if (root == NULL || root->key == key)
-        return root;
+    if (root == NULL)
+        return NULL;
 
-    /* Key in left subtree */
-    if (key < root->key) {
-        if (root->left == NULL) 
-            return root;
+    Node header = { 0, 0, NULL, NULL };
+    Node *l = &header, *r = &header, *t = root;
+    long depth = 1;
+    int lsize = 0, rsize = 0;
 
-        // Zig-Zig (LL)
-        if (key < root->left->key) {
-            root->left->left = splay(root->left->left, key);
-            root = rightRotate(root);
-        }
-        // Zig-Zag (LR)
-        else if (key > root->left->key) {
-            root->left->right = splay(root->left->right, key);
-            if (root->left->right != NULL)
-                root->left = leftRotate(root->left);
+    while (1) {
+        if (key < t->key) {
+            if (t->left == NULL)
+                break;
+            if (key < t->left->key) {          // zig-zig: rotate right first
+                t = rightRotate(t);
+                depth++;
+                if (t->left == NULL)
+                    break;
+            }
+            r->left = t;                       // link t into the right tree
+            r = t;
+            t = t->left;
+            rsize += 1 + size(r->right);
+        } else if (key > t->key) {
+            if (t->right == NULL)
+                break;
+            if (key > t->right->key) {         // zig-zig: rotate left first
+                t = leftRotate(t);
+                depth++;
+                if (t->right == NULL)
+                    break;
+            }
+            l->right = t;                      // link t into the left tree
+            l = t;
+            t = t->right;
+            lsize += 1 + size(l->left);
+        } else {
+            break;
         }
+        depth++;
+        stats.writes++;
+    }
 
-        return (root->left == NULL) ? root : rightRotate(root);
+    // fix sizes down the right spine of the left tree and the left spine
+    // of the right tree; t's subtrees end up at the bottom of each spine
+    lsize += size(t->left);
+    rsize += size(t->right);
+    t->size = lsize + rsize + 1;
+    l->right = r->left = NULL;
+    for (Node* y = header.right; y != NULL; y = y->right) {
+        y->size = lsize;
+        lsize -= 1 + size(y->left);
     }
+    for (Node* y = header.left; y != NULL; y = y->left) {
+        y->size = rsize;
+        rsize -= 1 + size(y->right);
+    }
+
+    // reassemble
+    l->right = t->left;
+    r->left = t->right;
+    t->left = header.right;
+    t->right = header.left;
+    stats.writes += 4;
+    recordDepth(depth);
+    return t;
+}
 
-    /* Key in right subtree */
-    else {
-        if (root->right == NULL) 
-            return root;
+// Path of child links for semiSplayAccess, kept between calls
+Node*** pathLinks = NULL;
+int pathCap = 0;
 
-        // Zig-Zig (RR)
-        if (key > root->right->key) {
-            root->right->right = splay(root->right->right, key);
-            root = leftRotate(root);
+// Semi-splay: at a zig-zig only the parent is rotated up and the walk
+// continues from the parent, so the accessed node moves about halfway to
+// the root and the tree changes much less than with a full splay.
+// A zig-zag is the same double rotation as in a splay.
+Node* semiSplayAccess(Node* root, int key) {
+    if (root == NULL)
+        return NULL;
+
+    int n = 0;
+    Node** link = &root;
+    while (1) {
+        if (n == pathCap) {
+            pathCap = pathCap ? 2 * pathCap : 64;
+            pathLinks = (Node***)realloc(pathLinks, pathCap * sizeof(Node**));
         }
-        // Zig-Zag (RL)
-        else if (key < root->right->key) {
-            root->right->left = splay(root->right->left, key);
-            if (root->right->left != NULL)
-                root->right = rightRotate(root->right);
+        pathLinks[n++] = link;
+        Node* cur = *link;
+        if (key == cur->key)
+            break;
+        Node** next = key < cur->key ? &cur->left : &cur->right;
+        if (*next == NULL)
+            break;
+        link = next;
+    }
+    recordDepth(n);
+
+    int i = n - 1;
+    while (i >= 2) {
+        Node *x = *pathLinks[i], *p = *pathLinks[i - 1], *g = *pathLinks[i - 2];
+        if ((p->left == x) == (g->left == p)) {
+            // zig-zig: rotate p over g, continue from p
+            *pathLinks[i - 2] = g->left == p ? rightRotate(g) : leftRotate(g);
+        } else {
+            // zig-zag: x goes above p and g
+            *pathLinks[i - 1] = p->left == x ? rightRotate(p) : leftRotate(p);
+            *pathLinks[i - 2] = g->left == x ? rightRotate(g) : leftRotate(g);
+            stats.writes++;
         }
+        stats.writes++;
+        i -= 2;
+    }
+    return root;
+}
 
-        return (root->right == NULL) ? root : leftRotate(root);
+// Read-only lookup: does not change the tree, so readers can share it
+Node* find(Node* root, int key) {
+    long depth = 0;
+    while (root != NULL) {
+        depth++;
+        if (key == root->key)
+            break;
+        root = key < root->key ? root->left : root->right;
     }
+    recordDepth(depth);
+    return root;
 }
 
 /* ---------- Insert ---------- */
@@ -96,13 +242,26 @@ Node* insert(Node* root, int key) {
         n->right = root->right;
         root->right = NULL;
     }
+    update(root);
+    update(n);
 
     return n;
 }
 
 /* ---------- Search ---------- */
+// Restructures the tree on every splayEvery-th call only
 Node* search(Node* root, int key) {
-    return splay(root, key);
+    if (++accessCount % splayEvery != 0) {
+        find(root, key);
+        return root;
+    }
+    return semiSplay ? semiSplayAccess(root, key) : splay(root, key);
+}
+
+int contains(Node* root, int key) {
+    while (root != NULL && root->key != key)
+        root = key < root->key ? root->left : root->right;
+    return root != NULL;
 }
 
 /* ---------- Delete ---------- */
@@ -124,32 +283,334 @@ Node* delete(Node* root, int key) {
         temp = root;
         root = splay(root->left, key);  // Splay max of left subtree
         root->right = temp->right;
+        update(root);
     }
 
-    free(temp);
+    np_free(&pool, temp, sizeof(Node));
     return root;
 }
 
+/* ---------- Split / Join ---------- */
+// Splits into keys < key (*l) and keys >= key (*r)
+void split(Node* root, int key, Node** l, Node** r) {
+    if (root == NULL) {
+        *l = *r = NULL;
+        return;
+    }
+    root = splay(root, key);
+    if (root->key < key) {
+        *r = root->right;
+        root->right = NULL;
+        *l = root;
+    } else {
+        *l = root->left;
+        root->left = NULL;
+        *r = root;
+    }
+    update(root);
+}
+
+// Joins two trees where every key of l is smaller than every key of r
+Node* join(Node* l, Node* r) {
+    if (l == NULL)
+        return r;
+    l = splay(l, INT_MAX);  // max of l to the root, so l->right is empty
+    l->right = r;
+    update(l);
+    return l;
+}
+
+/* ---------- Range Operations ---------- */
+// Cuts the keys in [lo, hi] out of the tree and returns them as a tree
+Node* extractRange(Node** root, int lo, int hi) {
+    Node *a, *mid, *c = NULL;
+    if (lo > hi)
+        return NULL;
+    split(*root, lo, &a, &mid);
+    if (hi < INT_MAX)
+        split(mid, hi + 1, &mid, &c);
+    *root = join(a, c);
+    return mid;
+}
+
+// Frees a whole subtree in O(n) without a stack: a node with a left child
+// is rotated right until the current node has none, then freed
+void freeTree(Node* n) {
+    while (n != NULL) {
+        if (n->left != NULL) {
+            Node* l = n->left;
+            n->left = l->right;
+            l->right = n;
+            n = l;
+        } else {
+            Node* r = n->right;
+            np_free(&pool, n, sizeof(Node));
+            n = r;
+        }
+    }
+}
+
+// Deletes every key in [lo, hi]; returns how many were removed
+int deleteRange(Node** root, int lo, int hi) {
+    Node* cut = extractRange(root, lo, hi);
+    int removed = size(cut);
+    freeTree(cut);
+    return removed;
+}
+
+/* ---------- Rank / Select ---------- */
+// Number of keys smaller than key (read-only)
+int rank(Node* root, int key) {
+    int r = 0;
+    while (root != NULL) {
+        if (key <= root->key) {
+            root = root->left;
+        } else {
+            r += size(root->left) + 1;
+            root = root->right;
+        }
+    }
+    return r;
+}
+
+// Splays the k-th smallest key (0-based) to the root; the tree is
+// unchanged if k is out of range
+Node* selectKth(Node* root, int k) {
+    if (k < 0 || k >= size(root))
+        return root;
+    Node* n = root;
+    while (k != size(n->left)) {
+        if (k < size(n->left)) {
+            n = n->left;
+        } else {
+            k -= size(n->left) + 1;
+            n = n->right;
+        }
+    }
+    return splay(root, n->key);
+}
+
 /* ---------- Display (Inorder) ---------- */
+// Iterative, with an explicit stack, since a splay tree can be a long path
 void inorder(Node* root) {
-    if (root == NULL) return;
-    inorder(root->left);
-    printf("%d ", root->key);
-    inorder(root->right);
+    int cap = 64, top = 0;
+    Node** stack = (Node**)malloc(cap * sizeof(Node*));
+    Node* cur = root;
+    while (cur != NULL || top > 0) {
+        while (cur != NULL) {
+            if (top == cap) {
+                cap *= 2;
+                stack = (Node**)realloc(stack, cap * sizeof(Node*));
+            }
+            stack[top++] = cur;
+            cur = cur->left;
+        }
+        cur = stack[--top];
+        printf("%d ", cur->key);
+        cur = cur->right;
+    }
+    free(stack);
+}
+
+/* ---------- Shared tree with a concurrent read path ---------- */
+// Most searches only read the tree and run in parallel under the read
+// lock. Every splayEvery-th search tries to take the write lock and
+// splays; if another thread holds the lock it just reads instead.
+typedef struct {
+    Node* root;
+    pthread_rwlock_t lock;
+    long accesses;
+} SharedSplay;
+
+int sharedSearch(SharedSplay* s, int key) {
+    long a = __atomic_add_fetch(&s->accesses, 1, __ATOMIC_RELAXED);
+    int found;
+    if (a % splayEvery == 0 && pthread_rwlock_trywrlock(&s->lock) == 0) {
+        s->root = semiSplay ? semiSplayAccess(s->root, key) : splay(s->root, key);
+        found = contains(s->root, key);
+        pthread_rwlock_unlock(&s->lock);
+        return found;
+    }
+    pthread_rwlock_rdlock(&s->lock);
+    found = find(s->root, key) != NULL;
+    pthread_rwlock_unlock(&s->lock);
+    return found;
+}
+
+/* ---------- Zipfian trace replay ---------- */
+double wallTime(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+unsigned long long nextRandom(unsigned long long* s) {
+    *s ^= *s << 13;
+    *s ^= *s >> 7;
+    *s ^= *s << 17;
+    return *s;
+}
+
+// ops accesses to n keys; rank r is drawn with probability ~ 1 / r^theta
+// and mapped to a random key, so hot keys are spread over the key space
+int* zipfTrace(int n, long ops, double theta, int* keys) {
+    double* cdf = (double*)malloc(n * sizeof(double));
+    double sum = 0;
+    for (int i = 0; i < n; i++)
+        cdf[i] = sum += 1 / pow(i + 1.0, theta);
+    int* trace = (int*)malloc(ops * sizeof(int));
+    unsigned long long seed = 42;
+    for (long i = 0; i < ops; i++) {
+        double u = (nextRandom(&seed) >> 11) * (1.0 / 9007199254740992.0) * sum;
+        int lo = 0, hi = n - 1;
+        while (lo < hi) {
+            int mid = (lo + hi) / 2;
+            if (cdf[mid] < u) lo = mid + 1;
+            else hi = mid;
+        }
+        trace[i] = keys[lo];
+    }
+    free(cdf);
+    return trace;
+}
+
+typedef struct {
+    SharedSplay* tree;
+    const int* trace;
+    long from, to, found;
+    SplayStats stats;
+} ReplayArg;
+
+void* replayWorker(void* p) {
+    ReplayArg* a = (ReplayArg*)p;
+    memset(&stats, 0, sizeof(stats));
+    for (long i = a->from; i < a->to; i++)
+        a->found += sharedSearch(a->tree, a->trace[i]);
+    a->stats = stats;
+    return NULL;
+}
+
+// Replays a Zipfian trace under each access policy and reports the cost
+void replay(int n, long ops, double theta, int threads) {
+    int* keys = (int*)malloc(n * sizeof(int));
+    unsigned long long seed = 7;
+    for (int i = 0; i < n; i++)
+        keys[i] = 2 * i;
+    for (int i = n - 1; i > 0; i--) {
+        int j = (int)(nextRandom(&seed) % (unsigned)(i + 1)), tmp = keys[i];
+        keys[i] = keys[j];
+        keys[j] = tmp;
+    }
+    int* trace = zipfTrace(n, ops, theta, keys);
+
+    struct { const char* name; int every, semi; } policies[] = {
+        { "splay every access", 1, 0 }, { "splay every 4th", 4, 0 }, { "splay every 16th", 16, 0 },
+        { "semi-splay", 1, 1 }, { "semi-splay every 4th", 4, 1 }, { "never splay", 1 << 30, 0 },
+    };
+
+    printf("%d keys, %ld accesses, Zipf theta %.2f, %d thread(s)\n", n, ops, theta, threads);
+    printf("%-22s %8s %10s %10s %11s %10s\n", "policy", "time(s)", "avg depth", "max depth", "rotations", "writes");
+    for (int p = 0; p < 6; p++) {
+        SharedSplay tree = { NULL, PTHREAD_RWLOCK_INITIALIZER, 0 };
+        np_init(&pool, 0);
+        for (int i = 0; i < n; i++)
+            tree.root = insert(tree.root, keys[i]);
+        splayEvery = policies[p].every;
+        semiSplay = policies[p].semi;
+
+        ReplayArg args[64];
+        pthread_t tid[64];
+        int t = threads < 64 ? threads : 64;
+        double s = wallTime();
+        for (int i = 0; i < t; i++) {
+            args[i] = (ReplayArg){ &tree, trace, ops * i / t, ops * (i + 1) / t, 0, { 0 } };
+            pthread_create(&tid[i], NULL, replayWorker, &args[i]);
+        }
+        SplayStats total = { 0 };
+        long found = 0;
+        for (int i = 0; i < t; i++) {
+            pthread_join(tid[i], NULL);
+            found += args[i].found;
+            total.ops += args[i].stats.ops;
+            total.depthSum += args[i].stats.depthSum;
+            total.rotations += args[i].stats.rotations;
+            total.writes += args[i].stats.writes;
+            if (args[i].stats.maxDepth > total.maxDepth)
+                total.maxDepth = args[i].stats.maxDepth;
+        }
+        s = wallTime() - s;
+        printf("%-22s %8.3f %10.2f %10ld %11.2f %10.2f%s\n", policies[p].name, s,
+               (double)total.depthSum / total.ops, total.maxDepth,
+               (double)total.rotations / ops, (double)total.writes / ops, found == ops ? "" : "  (MISSED KEYS)");
+        np_destroy(&pool);
+    }
+    splayEvery = 1;
+    semiSplay = 0;
+    free(pathLinks);
+    pathLinks = NULL;
+    pathCap = 0;
+    free(trace);
+    free(keys);
+}
+
+// Sliding window: each round inserts `batch` new keys and evicts the
+// `batch` oldest ones, one key at a time or with a single deleteRange
+void evictBench(int window, int batch, int rounds) {
+    for (int mode = 0; mode < 2; mode++) {
+        np_init(&pool, 0);
+        Node* root = NULL;
+        int next = 0, oldest = 0;
+        for (; next < window; next++)
+            root = insert(root, next);
+        double s = wallTime(), evict = 0;
+        for (int r = 0; r < rounds; r++) {
+            for (int i = 0; i < batch; i++, next++)
+                root = insert(root, next);
+            double e = wallTime();
+            if (mode == 0) {
+                for (int i = 0; i < batch; i++)
+                    root = delete(root, oldest + i);
+            } else {
+                deleteRange(&root, oldest, oldest + batch - 1);
+            }
+            evict += wallTime() - e;
+            oldest += batch;
+        }
+        s = wallTime() - s;
+        printf("%-18s total %.3f s, eviction %.3f s (%.1f ns per evicted key), size %d %s\n",
+               mode == 0 ? "delete per key" : "deleteRange", s, evict, evict * 1e9 / ((double)rounds * batch),
+               size(root), size(root) == window && rank(root, oldest) == 0 ? "ok" : "WRONG");
+        np_destroy(&pool);
+    }
 }
 
 /* ---------- MAIN (Menu + User input) ---------- */
-int main() {
+int main(int argc, char** argv) {
     Node* root = NULL;
     int choice, key;
 
+    if (argc > 3 && strcmp(argv[1], "--zipf") == 0) {
+        replay(atoi(argv[2]), atol(argv[3]), argc > 4 ? atof(argv[4]) : 0.99, argc > 5 ? atoi(argv[5]) : 1);
+        return 0;
+    }
+    if (argc > 1 && strcmp(argv[1], "--evict") == 0) {
+        evictBench(argc > 2 ? atoi(argv[2]) : 1000000, argc > 3 ? atoi(argv[3]) : 10000,
+                   argc > 4 ? atoi(argv[4]) : 200);
+        return 0;
+    }
+
+    np_init(&pool, 0);
+
     while (1) {
         printf("\n\n===== SPLAY TREE MENU =====\n");
         printf("1. Insert\n");
         printf("2. Search\n");
         printf("3. Delete\n");
         printf("4. Display (Inorder)\n");
-        printf("5. Exit\n");
+        printf("5. Delete Range\n");
+        printf("6. Rank / Select\n");
+        printf("7. Access Policy / Statistics\n");
+        printf("8. Exit\n");
         printf("Enter your choice: ");
         scanf("%d", &choice);
 
@@ -165,7 +626,7 @@ int main() {
                 printf("Enter key to search: ");
                 scanf("%d", &key);
                 root = search(root, key);
-                printf("Searched (Splayed) %d\n", key);
+                printf("%d %s\n", key, contains(root, key) ? "found" : "not found");
                 break;
 
             case 3:
@@ -181,8 +642,38 @@ int main() {
                 printf("\n");
                 break;
 
-            case 5:
+            case 5: {
+                int lo, hi;
+                printf("Enter range (lo hi): ");
+                scanf("%d %d", &lo, &hi);
+                printf("Deleted %d keys\n", deleteRange(&root, lo, hi));
+                break;
+            }
+
+            case 6:
+                printf("Enter key for rank, then k for select (0-based): ");
+                scanf("%d", &key);
+                printf("%d keys are smaller than %d\n", rank(root, key), key);
+                scanf("%d", &key);
+                root = selectKth(root, key);
+                if (key >= 0 && key < size(root))
+                    printf("Key of rank %d: %d\n", key, root->key);
+                else
+                    printf("Rank out of range (tree has %d keys)\n", size(root));
+                break;
+
+            case 7:
+                printf("Accesses: %ld, avg depth %.2f, max depth %ld, rotations %ld, pointer writes %ld\n",
+                       stats.ops, stats.ops ? (double)stats.depthSum / stats.ops : 0.0, stats.maxDepth,
+                       stats.rotations, stats.writes);
+                printf("Splay every k-th search (k >= 1) and semi-splay (0/1): ");
+                if (scanf("%d %d", &splayEvery, &semiSplay) != 2 || splayEvery < 1)
+                    splayEvery = 1;
+                break;
+
+            case 8:
                 printf("Exiting...\n");
+                np_destroy(&pool);
                 exit(0);
 
             default:
@@ -0,0 +1,204 @@
+/*
+   csr_graph.h - weighted directed graphs in compressed sparse row form.
+
+   The arcs leaving vertex u are target[offset[u] .. offset[u+1]-1], with
+   the matching weight[] entries, so a vertex's neighbours sit next to each
+   other in memory and a graph with n vertices and m arcs takes
+   8(n + 1) + 8m bytes. An undirected edge is stored as two arcs.
+
+   Graphs are built from an edge list (cg_from_edges), read from a DIMACS
+   shortest-path file (cg_read_dimacs, the format of the 9th DIMACS
+   challenge road networks: "p sp n m" and "a u v w" lines, 1-based), or
+   generated: cg_grid makes a road-like grid, cg_random a sparse random
+   graph. Weights are non-negative ints unless a program says otherwise.
+
+   Edge lists can also be kept in binary edge files: "EDGE", int n, long
+   m, then m CgEdge records (u, v, w as native ints). cg_write_edge_file
+   and cg_read_edge_file move them in large blocks, so 10^8 edges load
+   in seconds.
+*/
+#ifndef CSR_GRAPH_H
+#define CSR_GRAPH_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct {
+    int u, v, w;
+} CgEdge;
+
+typedef struct {
+    int n;          // vertices 0 .. n-1
+    long m;         // arcs
+    long *offset;   // n + 1 entries
+    int *target;
+    int *weight;
+} CsrGraph;
+
+static inline void cg_free(CsrGraph *g) {
+    free(g->offset);
+    free(g->target);
+    free(g->weight);
+    memset(g, 0, sizeof(*g));
+}
+
+// Builds the graph with a counting sort on the source vertex; with
+// undirected set, every edge also gets its reverse arc
+static inline CsrGraph cg_from_edges(int n, long m, const CgEdge *e, int undirected) {
+    CsrGraph g;
+    g.n = n;
+    g.m = undirected ? 2 * m : m;
+    g.offset = (long *)calloc((size_t)n + 1, sizeof(long));
+    g.target = (int *)malloc((size_t)(g.m > 0 ? g.m : 1) * sizeof(int));
+    g.weight = (int *)malloc((size_t)(g.m > 0 ? g.m : 1) * sizeof(int));
+    for (long i = 0; i < m; i++) {
+        g.offset[e[i].u + 1]++;
+        if (undirected) g.offset[e[i].v + 1]++;
+    }
+    for (int u = 0; u < n; u++)
+        g.offset[u + 1] += g.offset[u];
+    long *next = (long *)malloc((size_t)(n > 0 ? n : 1) * sizeof(long));
+    memcpy(next, g.offset, (size_t)n * sizeof(long));
+    for (long i = 0; i < m; i++) {
+        long a = next[e[i].u]++;
+        g.target[a] = e[i].v;
+        g.weight[a] = e[i].w;
+        if (undirected) {
+            a = next[e[i].v]++;
+            g.target[a] = e[i].u;
+            g.weight[a] = e[i].w;
+        }
+    }
+    free(next);
+    return g;
+}
+
+// The graph with every arc reversed (for backward searches)
+static inline CsrGraph cg_reverse(const CsrGraph *g) {
+    CgEdge *e = (CgEdge *)malloc((size_t)(g->m > 0 ? g->m : 1) * sizeof(CgEdge));
+    for (int u = 0; u < g->n; u++)
+        for (long a = g->offset[u]; a < g->offset[u + 1]; a++)
+            e[a] = (CgEdge){ g->target[a], u, g->weight[a] };
+    CsrGraph r = cg_from_edges(g->n, g->m, e, 0);
+    free(e);
+    return r;
+}
+
+// Reads a DIMACS .gr file; returns 0 on success
+static inline int cg_read_dimacs(const char *path, CsrGraph *g) {
+    FILE *f = fopen(path, "r");
+    if (f == NULL) return -1;
+    char line[256];
+    int n = -1;
+    long m = 0, cap = 0;
+    CgEdge *e = NULL;
+    while (fgets(line, sizeof(line), f) != NULL) {
+        int u, v, w;
+        if (line[0] == 'p') {
+            long arcs;
+            if (sscanf(line, "p sp %d %ld", &n, &arcs) == 2 && arcs > cap) {
+                cap = arcs;
+                e = (CgEdge *)realloc(e, (size_t)cap * sizeof(CgEdge));
+            }
+        } else if (line[0] == 'a' && sscanf(line, "a %d %d %d", &u, &v, &w) == 3) {
+            if (n < 0 || u < 1 || v < 1 || u > n || v > n || w < 0) break;
+            if (m == cap) {
+                cap = cap ? 2 * cap : 1024;
+                e = (CgEdge *)realloc(e, (size_t)cap * sizeof(CgEdge));
+            }
+            e[m++] = (CgEdge){ u - 1, v - 1, w };
+        }
+    }
+    int bad = n < 0 || !feof(f);
+    fclose(f);
+    if (!bad)
+        *g = cg_from_edges(n, m, e, 0);
+    free(e);
+    return bad ? -1 : 0;
+}
+
+static inline unsigned long long cg_rand(unsigned long long *s) {
+    *s ^= *s << 13;
+    *s ^= *s >> 7;
+    *s ^= *s << 17;
+    return *s;
+}
+
+// rows x cols grid, undirected, weights in [1, maxW]: a stand-in for a
+// road network (planar, degree <= 4, large diameter)
+static inline CsrGraph cg_grid(int rows, int cols, int maxW, unsigned long long seed) {
+    long m = 0, cap = 2L * rows * cols;
+    CgEdge *e = (CgEdge *)malloc((size_t)(cap > 0 ? cap : 1) * sizeof(CgEdge));
+    for (int r = 0; r < rows; r++)
+        for (int c = 0; c < cols; c++) {
+            int u = r * cols + c;
+            if (c + 1 < cols) e[m++] = (CgEdge){ u, u + 1, 1 + (int)(cg_rand(&seed) % maxW) };
+            if (r + 1 < rows) e[m++] = (CgEdge){ u, u + cols, 1 + (int)(cg_rand(&seed) % maxW) };
+        }
+    CsrGraph g = cg_from_edges(rows * cols, m, e, 1);
+    free(e);
+    return g;
+}
+
+// n vertices, a random Hamiltonian cycle (so the graph is strongly
+// connected) plus random edges up to m in total, weights in [1, maxW];
+// m is raised to n if smaller
+static inline CgEdge *cg_random_edges(int n, long *m_, int maxW, unsigned long long seed) {
+    long m = *m_ < n ? n : *m_;
+    *m_ = m;
+    CgEdge *e = (CgEdge *)malloc((size_t)m * sizeof(CgEdge));
+    int *perm = (int *)malloc((size_t)n * sizeof(int));
+    for (int i = 0; i < n; i++) perm[i] = i;
+    for (int i = n - 1; i > 0; i--) {
+        int j = (int)(cg_rand(&seed) % (unsigned long long)(i + 1)), t = perm[i];
+        perm[i] = perm[j];
+        perm[j] = t;
+    }
+    for (int i = 0; i < n; i++)
+        e[i] = (CgEdge){ perm[i], perm[(i + 1) % n], 1 + (int)(cg_rand(&seed) % maxW) };
+    for (long i = n; i < m; i++)
+        e[i] = (CgEdge){ (int)(cg_rand(&seed) % n), (int)(cg_rand(&seed) % n), 1 + (int)(cg_rand(&seed) % maxW) };
+    free(perm);
+    return e;
+}
+
+static inline CsrGraph cg_random(int n, long m, int maxW, unsigned long long seed) {
+    CgEdge *e = cg_random_edges(n, &m, maxW, seed);
+    CsrGraph g = cg_from_edges(n, m, e, 0);
+    free(e);
+    return g;
+}
+
+// Writes a binary edge file; returns 0 on success
+static inline int cg_write_edge_file(const char *path, int n, long m, const CgEdge *e) {
+    FILE *f = fopen(path, "wb");
+    if (f == NULL) return -1;
+    int ok = fwrite("EDGE", 1, 4, f) == 4 && fwrite(&n, sizeof(int), 1, f) == 1 &&
+             fwrite(&m, sizeof(long), 1, f) == 1 && fwrite(e, sizeof(CgEdge), (size_t)m, f) == (size_t)m;
+    return fclose(f) == 0 && ok ? 0 : -1;
+}
+
+// Reads a binary edge file into a malloc'd array; NULL if the file is
+// missing, truncated or names a vertex outside 0 .. n-1
+static inline CgEdge *cg_read_edge_file(const char *path, int *n, long *m) {
+    FILE *f = fopen(path, "rb");
+    if (f == NULL) return NULL;
+    char magic[4];
+    CgEdge *e = NULL;
+    if (fread(magic, 1, 4, f) == 4 && memcmp(magic, "EDGE", 4) == 0 && fread(n, sizeof(int), 1, f) == 1 &&
+        fread(m, sizeof(long), 1, f) == 1 && *n >= 0 && *m >= 0) {
+        e = (CgEdge *)malloc((size_t)(*m > 0 ? *m : 1) * sizeof(CgEdge));
+        int bad = e == NULL || fread(e, sizeof(CgEdge), (size_t)*m, f) != (size_t)*m;
+        for (long i = 0; i < *m && !bad; i++)
+            bad = e[i].u < 0 || e[i].v < 0 || e[i].u >= *n || e[i].v >= *n;
+        if (bad) {
+            free(e);
+            e = NULL;
+        }
+    }
+    fclose(f);
+    return e;
+}
+
+#endif /* CSR_GRAPH_H */
@@ -0,0 +1,455 @@
+/*
+   dense_kernels.h - shared dense linear-algebra kernels for the lab programs.
+
+   Header-only: every program that includes it still builds from one file,
+   e.g.  gcc -O2 StressensMatrix.c -o strassen -pthread
+
+   All matrices are row-major with a leading dimension (row stride).
+
+     dk_dgemm   C = alpha*A*B + beta*C      packed panels, 4x8 FMA micro-kernel
+     dk_sgemm   float  C (+)= A*B            cache-blocked
+     dk_igemm   int    C (+)= A*B            cache-blocked
+     dk_lgemm   int64  C (+)= A*B            cache-blocked, wrapping arithmetic
+     dk_dgemv   y = alpha*A*x + beta*y
+     dk_dger    A += alpha * x * y^T         rank-1 update
+     dk_dtrsm   solve T X = B in place       T lower/upper, unit/non-unit
+
+   The AVX2/FMA code paths are compiled with target attributes and chosen
+   at run time from the CPU's feature bits. Large calls are split by rows
+   (or columns) across threads. Set DK_NUM_THREADS to change the count.
+*/
+#ifndef DENSE_KERNELS_H
+#define DENSE_KERNELS_H
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <unistd.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define DK_X86 1
+#define DK_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#else
+#define DK_X86 0
+#define DK_TARGET_AVX2
+#endif
+
+#define DK_MR 4      // micro-tile rows
+#define DK_NR 8      // micro-tile columns
+#define DK_MC 96     // rows of A per packed block
+#define DK_KC 256    // depth of a packed panel
+#define DK_NC 2048   // columns of B per packed block
+#define DK_BLOCK 64  // tile for the simple blocked kernels
+#define DK_PARALLEL_WORK (1L << 21)   // flops below which calls stay single-threaded
+
+/* ---------- Runtime configuration ---------- */
+
+static inline int dk_num_threads(void) {
+    static int threads = 0;
+    if (threads == 0) {
+        const char *env = getenv("DK_NUM_THREADS");
+        threads = env ? atoi(env) : (int)sysconf(_SC_NPROCESSORS_ONLN);
+        if (threads < 1) threads = 1;
+    }
+    return threads;
+}
+
+static inline int dk_has_avx2(void) {
+#if DK_X86
+    static int cached = -1;
+    if (cached < 0) {
+        __builtin_cpu_init();
+        cached = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+    }
+    return cached;
+#else
+    return 0;
+#endif
+}
+
+/* ---------- Parallel loop over [0, n) ---------- */
+
+typedef void (*dk_range_fn)(void *ctx, int lo, int hi);
+
+typedef struct {
+    dk_range_fn fn;
+    void *ctx;
+    int lo, hi;
+} dk_range_task;
+
+static inline void *dk_range_run(void *arg) {
+    dk_range_task *t = (dk_range_task *)arg;
+    t->fn(t->ctx, t->lo, t->hi);
+    return NULL;
+}
+
+// Splits [0, n) into chunks (multiples of align) and runs fn on each chunk.
+// Runs inline when the work is small or only one thread is configured.
+static inline void dk_parallel_for(int n, int align, double work, dk_range_fn fn, void *ctx) {
+    int threads = dk_num_threads();
+    int chunks = (n + align - 1) / align;
+    if (threads > chunks) threads = chunks;
+    if (threads <= 1 || work < DK_PARALLEL_WORK) {
+        fn(ctx, 0, n);
+        return;
+    }
+
+    pthread_t *tid = (pthread_t *)malloc(threads * sizeof(pthread_t));
+    dk_range_task *tasks = (dk_range_task *)malloc(threads * sizeof(dk_range_task));
+    int *started = (int *)calloc(threads, sizeof(int));
+    int per = (chunks + threads - 1) / threads * align;
+    for (int t = 0; t < threads; t++) {
+        tasks[t].fn = fn;
+        tasks[t].ctx = ctx;
+        tasks[t].lo = t * per < n ? t * per : n;
+        tasks[t].hi = (t + 1) * per < n ? (t + 1) * per : n;
+        if (t > 0)
+            started[t] = pthread_create(&tid[t], NULL, dk_range_run, &tasks[t]) == 0;
+    }
+    dk_range_run(&tasks[0]);
+    for (int t = 1; t < threads; t++) {
+        if (started[t]) pthread_join(tid[t], NULL);
+        else dk_range_run(&tasks[t]);
+    }
+    free(tid);
+    free(tasks);
+    free(started);
+}
+
+/* ---------- DGEMM: packing and micro-kernels ---------- */
+
+// Packs an mc x kc block of A into MR-row panels: panel[p*MR + i]
+static inline void dk_pack_a(int mc, int kc, const double *A, int lda, double *Ap) {
+    for (int i0 = 0; i0 < mc; i0 += DK_MR) {
+        int mr = mc - i0 < DK_MR ? mc - i0 : DK_MR;
+        for (int p = 0; p < kc; p++) {
+            for (int i = 0; i < mr; i++) Ap[i] = A[(size_t)(i0 + i) * lda + p];
+            for (int i = mr; i < DK_MR; i++) Ap[i] = 0.0;
+            Ap += DK_MR;
+        }
+    }
+}
+
+// Packs a kc x nc block of B into NR-column panels: panel[p*NR + j]
+static inline void dk_pack_b(int kc, int nc, const double *B, int ldb, double *Bp) {
+    for (int j0 = 0; j0 < nc; j0 += DK_NR) {
+        int nr = nc - j0 < DK_NR ? nc - j0 : DK_NR;
+        for (int p = 0; p < kc; p++) {
+            const double *b = B + (size_t)p * ldb + j0;
+            for (int j = 0; j < nr; j++) Bp[j] = b[j];
+            for (int j = nr; j < DK_NR; j++) Bp[j] = 0.0;
+            Bp += DK_NR;
+        }
+    }
+}
+
+// acc[MR][NR] = sum over p of a[p] (column) times b[p] (row)
+static inline void dk_kernel_4x8_scalar(int kc, const double *a, const double *b, double *acc) {
+    double c[DK_MR][DK_NR] = {{0}};
+    for (int p = 0; p < kc; p++, a += DK_MR, b += DK_NR)
+        for (int i = 0; i < DK_MR; i++)
+            for (int j = 0; j < DK_NR; j++)
+                c[i][j] += a[i] * b[j];
+    memcpy(acc, c, sizeof(c));
+}
+
+#if DK_X86
+DK_TARGET_AVX2
+static inline void dk_kernel_4x8_avx2(int kc, const double *a, const double *b, double *acc) {
+    __m256d c00 = _mm256_setzero_pd(), c01 = _mm256_setzero_pd();
+    __m256d c10 = _mm256_setzero_pd(), c11 = _mm256_setzero_pd();
+    __m256d c20 = _mm256_setzero_pd(), c21 = _mm256_setzero_pd();
+    __m256d c30 = _mm256_setzero_pd(), c31 = _mm256_setzero_pd();
+    for (int p = 0; p < kc; p++, a += DK_MR, b += DK_NR) {
+        __m256d b0 = _mm256_loadu_pd(b), b1 = _mm256_loadu_pd(b + 4);
+        __m256d ai = _mm256_broadcast_sd(a);
+        c00 = _mm256_fmadd_pd(ai, b0, c00); c01 = _mm256_fmadd_pd(ai, b1, c01);
+        ai = _mm256_broadcast_sd(a + 1);
+        c10 = _mm256_fmadd_pd(ai, b0, c10); c11 = _mm256_fmadd_pd(ai, b1, c11);
+        ai = _mm256_broadcast_sd(a + 2);
+        c20 = _mm256_fmadd_pd(ai, b0, c20); c21 = _mm256_fmadd_pd(ai, b1, c21);
+        ai = _mm256_broadcast_sd(a + 3);
+        c30 = _mm256_fmadd_pd(ai, b0, c30); c31 = _mm256_fmadd_pd(ai, b1, c31);
+    }
+    _mm256_storeu_pd(acc + 0, c00);  _mm256_storeu_pd(acc + 4, c01);
+    _mm256_storeu_pd(acc + 8, c10);  _mm256_storeu_pd(acc + 12, c11);
+    _mm256_storeu_pd(acc + 16, c20); _mm256_storeu_pd(acc + 20, c21);
+    _mm256_storeu_pd(acc + 24, c30); _mm256_storeu_pd(acc + 28, c31);
+}
+#endif
+
+typedef void (*dk_kernel_fn)(int, const double *, const double *, double *);
+
+static inline dk_kernel_fn dk_select_kernel(void) {
+#if DK_X86
+    if (dk_has_avx2()) return dk_kernel_4x8_avx2;
+#endif
+    return dk_kernel_4x8_scalar;
+}
+
+// Single-threaded packed GEMM
+static inline void dk_dgemm_serial(int m, int n, int k, double alpha, const double *A, int lda,
+                                   const double *B, int ldb, double beta, double *C, int ldc) {
+    if (k <= 0 || alpha == 0.0) {
+        for (int i = 0; i < m; i++)
+            for (int j = 0; j < n; j++)
+                C[(size_t)i * ldc + j] = beta == 0.0 ? 0.0 : beta * C[(size_t)i * ldc + j];
+        return;
+    }
+
+    dk_kernel_fn kernel = dk_select_kernel();
+    int kcMax = k < DK_KC ? k : DK_KC;
+    int ncMax = n < DK_NC ? n : DK_NC;
+    int mcMax = m < DK_MC ? m : DK_MC;
+    double *Bp = (double *)malloc((size_t)kcMax * ((ncMax + DK_NR - 1) / DK_NR * DK_NR) * sizeof(double));
+    double *Ap = (double *)malloc((size_t)kcMax * ((mcMax + DK_MR - 1) / DK_MR * DK_MR) * sizeof(double));
+    double acc[DK_MR * DK_NR];
+
+    for (int jc = 0; jc < n; jc += DK_NC) {
+        int nc = n - jc < DK_NC ? n - jc : DK_NC;
+        for (int pc = 0; pc < k; pc += DK_KC) {
+            int kc = k - pc < DK_KC ? k - pc : DK_KC;
+            double b = pc == 0 ? beta : 1.0;   // beta is applied once
+            dk_pack_b(kc, nc, B + (size_t)pc * ldb + jc, ldb, Bp);
+
+            for (int ic = 0; ic < m; ic += DK_MC) {
+                int mc = m - ic < DK_MC ? m - ic : DK_MC;
+                dk_pack_a(mc, kc, A + (size_t)ic * lda + pc, lda, Ap);
+
+                for (int jr = 0; jr < nc; jr += DK_NR) {
+                    int nr = nc - jr < DK_NR ? nc - jr : DK_NR;
+                    for (int ir = 0; ir < mc; ir += DK_MR) {
+                        int mr = mc - ir < DK_MR ? mc - ir : DK_MR;
+                        kernel(kc, Ap + (size_t)ir * kc, Bp + (size_t)jr * kc, acc);
+                        double *c = C + (size_t)(ic + ir) * ldc + jc + jr;
+                        for (int i = 0; i < mr; i++)
+                            for (int j = 0; j < nr; j++) {
+                                double v = alpha * acc[i * DK_NR + j];
+                                c[(size_t)i * ldc + j] = b == 0.0 ? v : v + b * c[(size_t)i * ldc + j];
+                            }
+                    }
+                }
+            }
+        }
+    }
+    free(Ap);
+    free(Bp);
+}
+
+typedef struct {
+    int m, n, k, byRows;
+    double alpha, beta;
+    const double *A, *B;
+    double *C;
+    int lda, ldb, ldc;
+} dk_gemm_args;
+
+static inline void dk_dgemm_range(void *ctx, int lo, int hi) {
+    dk_gemm_args *g = (dk_gemm_args *)ctx;
+    if (lo >= hi) return;
+    if (g->byRows)
+        dk_dgemm_serial(hi - lo, g->n, g->k, g->alpha, g->A + (size_t)lo * g->lda, g->lda,
+                        g->B, g->ldb, g->beta, g->C + (size_t)lo * g->ldc, g->ldc);
+    else
+        dk_dgemm_serial(g->m, hi - lo, g->k, g->alpha, g->A, g->lda,
+                        g->B + lo, g->ldb, g->beta, g->C + lo, g->ldc);
+}
+
+// C = alpha * A * B + beta * C;  A is m x k, B is k x n, C is m x n
+static inline void dk_dgemm(int m, int n, int k, double alpha, const double *A, int lda,
+                            const double *B, int ldb, double beta, double *C, int ldc) {
+    if (m <= 0 || n <= 0) return;
+    dk_gemm_args g = { m, n, k, m >= n, alpha, beta, A, B, C, lda, ldb, ldc };
+    double work = 2.0 * m * n * (double)k;
+    if (g.byRows) dk_parallel_for(m, DK_MR, work, dk_dgemm_range, &g);
+    else dk_parallel_for(n, DK_NR, work, dk_dgemm_range, &g);
+}
+
+/* ---------- Blocked kernels for float, int and int64 ---------- */
+
+// C (+)= A * B in cache tiles with a unit-stride inner loop the compiler
+// vectorizes. An AVX2 copy of the same body is selected at run time.
+#define DK_BLOCKED_BODY(T, MULADD)                                               \
+    for (int i = 0; i < m; i++)                                                  \
+        if (!accumulate) memset(C + (size_t)i * ldc, 0, n * sizeof(T));          \
+    for (int kk = 0; kk < k; kk += DK_BLOCK) {                                   \
+        int kend = kk + DK_BLOCK < k ? kk + DK_BLOCK : k;                        \
+        for (int jj = 0; jj < n; jj += DK_BLOCK) {                               \
+            int jend = jj + DK_BLOCK < n ? jj + DK_BLOCK : n;                    \
+            for (int i = 0; i < m; i++) {                                        \
+                T *c = C + (size_t)i * ldc;                                      \
+                for (int t = kk; t < kend; t++) {                                \
+                    T a = A[(size_t)i * lda + t];                                \
+                    const T *b = B + (size_t)t * ldb;                            \
+                    for (int j = jj; j < jend; j++) c[j] = MULADD(c[j], a, b[j]); \
+                }                                                                \
+            }                                                                    \
+        }                                                                        \
+    }
+
+#define DK_MULADD_PLAIN(c, a, b) ((c) + (a) * (b))
+#define DK_MULADD_WRAP64(c, a, b) ((int64_t)((uint64_t)(c) + (uint64_t)(a) * (uint64_t)(b)))
+
+#define DK_DEFINE_BLOCKED(NAME, T, MULADD)                                       \
+static inline void NAME##_plain(int m, int n, int k, const T *A, int lda,        \
+                                const T *B, int ldb, T *C, int ldc,              \
+                                int accumulate) {                                \
+    DK_BLOCKED_BODY(T, MULADD)                                                   \
+}                                                                                \
+DK_TARGET_AVX2                                                                   \
+static inline void NAME##_avx2(int m, int n, int k, const T *A, int lda,         \
+                               const T *B, int ldb, T *C, int ldc,               \
+                               int accumulate) {                                 \
+    DK_BLOCKED_BODY(T, MULADD)                                                   \
+}                                                                                \
+typedef struct {                                                                 \
+    int n, k, lda, ldb, ldc, accumulate;                                         \
+    const T *A, *B;                                                              \
+    T *C;                                                                        \
+} NAME##_args;                                                                   \
+static inline void NAME##_range(void *ctx, int lo, int hi) {                     \
+    NAME##_args *g = (NAME##_args *)ctx;                                         \
+    if (lo >= hi) return;                                                        \
+    const T *A = g->A + (size_t)lo * g->lda;                                     \
+    T *C = g->C + (size_t)lo * g->ldc;                                           \
+    if (dk_has_avx2())                                                           \
+        NAME##_avx2(hi - lo, g->n, g->k, A, g->lda, g->B, g->ldb, C, g->ldc, g->accumulate); \
+    else                                                                         \
+        NAME##_plain(hi - lo, g->n, g->k, A, g->lda, g->B, g->ldb, C, g->ldc, g->accumulate); \
+}                                                                                \
+/* C = A*B, or C += A*B when accumulate is non-zero */                           \
+static inline void NAME(int m, int n, int k, const T *A, int lda, const T *B,    \
+                        int ldb, T *C, int ldc, int accumulate) {                \
+    NAME##_args g = { n, k, lda, ldb, ldc, accumulate, A, B, C };                \
+    dk_parallel_for(m, 1, 2.0 * m * n * (double)k, NAME##_range, &g);            \
+}
+
+DK_DEFINE_BLOCKED(dk_sgemm, float, DK_MULADD_PLAIN)
+DK_DEFINE_BLOCKED(dk_igemm, int, DK_MULADD_PLAIN)
+DK_DEFINE_BLOCKED(dk_lgemm, int64_t, DK_MULADD_WRAP64)
+
+/* ---------- Level-2 kernels ---------- */
+
+static inline double dk_ddot_plain(int n, const double *x, const double *y) {
+    double s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+    int j = 0;
+    for (; j + 4 <= n; j += 4) {
+        s0 += x[j] * y[j];
+        s1 += x[j + 1] * y[j + 1];
+        s2 += x[j + 2] * y[j + 2];
+        s3 += x[j + 3] * y[j + 3];
+    }
+    for (; j < n; j++) s0 += x[j] * y[j];
+    return (s0 + s1) + (s2 + s3);
+}
+
+#if DK_X86
+DK_TARGET_AVX2
+static inline double dk_ddot_avx2(int n, const double *x, const double *y) {
+    __m256d s0 = _mm256_setzero_pd(), s1 = _mm256_setzero_pd();
+    int j = 0;
+    for (; j + 8 <= n; j += 8) {
+        s0 = _mm256_fmadd_pd(_mm256_loadu_pd(x + j), _mm256_loadu_pd(y + j), s0);
+        s1 = _mm256_fmadd_pd(_mm256_loadu_pd(x + j + 4), _mm256_loadu_pd(y + j + 4), s1);
+    }
+    double t[4];
+    _mm256_storeu_pd(t, _mm256_add_pd(s0, s1));
+    double s = (t[0] + t[1]) + (t[2] + t[3]);
+    for (; j < n; j++) s += x[j] * y[j];
+    return s;
+}
+#endif
+
+static inline double dk_ddot(int n, const double *x, const double *y) {
+#if DK_X86
+    if (dk_has_avx2()) return dk_ddot_avx2(n, x, y);
+#endif
+    return dk_ddot_plain(n, x, y);
+}
+
+typedef struct {
+    int n, lda;
+    double alpha, beta;
+    const double *A, *x, *y;
+    double *Y, *Aout;
+} dk_level2_args;
+
+static inline void dk_dgemv_range(void *ctx, int lo, int hi) {
+    dk_level2_args *g = (dk_level2_args *)ctx;
+    for (int i = lo; i < hi; i++) {
+        double v = g->alpha * dk_ddot(g->n, g->A + (size_t)i * g->lda, g->x);
+        g->Y[i] = g->beta == 0.0 ? v : v + g->beta * g->Y[i];
+    }
+}
+
+// y = alpha * A * x + beta * y;  A is m x n
+static inline void dk_dgemv(int m, int n, double alpha, const double *A, int lda,
+                            const double *x, double beta, double *y) {
+    dk_level2_args g = { n, lda, alpha, beta, A, x, NULL, y, NULL };
+    dk_parallel_for(m, 1, 2.0 * m * (double)n, dk_dgemv_range, &g);
+}
+
+static inline void dk_dger_range(void *ctx, int lo, int hi) {
+    dk_level2_args *g = (dk_level2_args *)ctx;
+    for (int i = lo; i < hi; i++) {
+        double a = g->alpha * g->x[i];
+        if (a == 0.0) continue;
+        double *row = g->Aout + (size_t)i * g->lda;
+        for (int j = 0; j < g->n; j++) row[j] += a * g->y[j];
+    }
+}
+
+// A += alpha * x * y^T;  A is m x n
+static inline void dk_dger(int m, int n, double alpha, const double *x, const double *y,
+                           double *A, int lda) {
+    dk_level2_args g = { n, lda, alpha, 0.0, NULL, x, y, NULL, A };
+    dk_parallel_for(m, 1, 2.0 * m * (double)n, dk_dger_range, &g);
+}
+
+/* ---------- Triangular solve ---------- */
+
+#define DK_TRSM_NB 64
+
+// Solves T * X = B in place (B becomes X). T is m x m; uplo 'L' or 'U';
+// diag 'U' for an implied unit diagonal, 'N' otherwise. B is m x n.
+// Diagonal blocks are solved directly, the rest is updated with dk_dgemm.
+static inline void dk_dtrsm(char uplo, char diag, int m, int n, const double *T, int ldt,
+                            double *B, int ldb) {
+    int lower = (uplo == 'L' || uplo == 'l');
+    int unit = (diag == 'U' || diag == 'u');
+
+    for (int step = 0; step < m; step += DK_TRSM_NB) {
+        int nb = m - step < DK_TRSM_NB ? m - step : DK_TRSM_NB;
+        int r0 = lower ? step : m - step - nb;   // first row of this block
+
+        // solve the diagonal block
+        for (int ii = 0; ii < nb; ii++) {
+            int i = lower ? r0 + ii : r0 + nb - 1 - ii;
+            double *bi = B + (size_t)i * ldb;
+            int jlo = lower ? r0 : i + 1;
+            int jhi = lower ? i : r0 + nb;
+            for (int j = jlo; j < jhi; j++) {
+                double t = T[(size_t)i * ldt + j];
+                if (t == 0.0) continue;
+                const double *bj = B + (size_t)j * ldb;
+                for (int c = 0; c < n; c++) bi[c] -= t * bj[c];
+            }
+            if (!unit) {
+                double d = 1.0 / T[(size_t)i * ldt + i];
+                for (int c = 0; c < n; c++) bi[c] *= d;
+            }
+        }
+
+        // update the rows that are still unsolved
+        if (lower && r0 + nb < m)
+            dk_dgemm(m - r0 - nb, n, nb, -1.0, T + (size_t)(r0 + nb) * ldt + r0, ldt,
+                     B + (size_t)r0 * ldb, ldb, 1.0, B + (size_t)(r0 + nb) * ldb, ldb);
+        if (!lower && r0 > 0)
+            dk_dgemm(r0, n, nb, -1.0, T + r0, ldt,
+                     B + (size_t)r0 * ldb, ldb, 1.0, B, ldb);
+    }
+}
+
+#endif /* DENSE_KERNELS_H */
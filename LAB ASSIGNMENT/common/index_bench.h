@@ -0,0 +1,340 @@
+/*
+   index_bench.h - benchmark driver shared by the ordered index programs.
+
+   A program includes its tree, then defines the five adapter functions
+   declared below and calls ib_main from its own main:
+
+       void ib_reset(void);            empty the index and release its memory
+       void ib_insert(int key);        key is never already present
+       int  ib_find(int key);          1 if present
+       void ib_erase(int key);         key is always present
+       long ib_range(int lo, int hi);  visits the keys in [lo, hi), returns how many
+
+   Keys are the odd numbers 1, 3, ..., 2n - 1. Besides the lookups of
+   present keys ("find"), the uniform, sequential and zipf workloads time
+   as many lookups of the even key just below ("miss"), which is never present.
+   Workloads:
+     uniform     load in random order, lookups / scans at uniform keys
+     sequential  load, look up and erase in ascending order
+     zipf        like uniform, but lookups and scans follow a Zipfian
+                 distribution (YCSB generator, hot keys scattered)
+     sliding     a window of n keys slides forward: each step inserts the
+                 next key, erases the oldest and looks up a key in the window;
+                 every 10th step also scans 100 keys
+
+   For every operation the driver reports throughput, p50 / p99 latency
+   (each operation is timed with clock_gettime; at most 2^20 latencies
+   are kept per operation), last-level cache misses per operation from
+   perf_event_open when the kernel allows it, and heap bytes per key
+   (growth of the malloc heap while loading, from mallinfo2).
+
+   Usage: <program> [--n 1000,100000,1000000] [--ops N] [--theta T]
+                    [--workload uniform,sequential,zipf,sliding]
+   The YCSB Zipfian generator needs 0 < T < 1 (default 0.99).
+*/
+#ifndef INDEX_BENCH_H
+#define INDEX_BENCH_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
+void ib_reset(void);
+void ib_insert(int key);
+int ib_find(int key);
+void ib_erase(int key);
+long ib_range(int lo, int hi);
+
+#define IB_SAMPLES   (1 << 20)   // latencies kept per operation
+#define IB_SCAN_KEYS 100         // keys per range scan
+
+static inline double ib_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static inline unsigned long long ib_rand(unsigned long long *s) {
+    *s ^= *s << 13;
+    *s ^= *s >> 7;
+    *s ^= *s << 17;
+    return *s;
+}
+
+static inline int ib_key(long i) { return (int)(2 * i + 1); }
+
+/* ---------- Zipfian ranks (YCSB generator) ---------- */
+typedef struct {
+    long n;
+    double theta, alpha, zetan, eta;
+} IbZipf;
+
+static inline void ib_zipf_init(IbZipf *z, long n, double theta) {
+    double zeta2 = 1 + pow(0.5, theta);
+    z->n = n;
+    z->theta = theta;
+    z->zetan = 0;
+    for (long i = 1; i <= n; i++)
+        z->zetan += 1 / pow((double)i, theta);
+    z->alpha = 1 / (1 - theta);
+    z->eta = (1 - pow(2.0 / n, 1 - theta)) / (1 - zeta2 / z->zetan);
+}
+
+static inline long ib_zipf_next(IbZipf *z, unsigned long long *seed) {
+    double u = (ib_rand(seed) >> 11) * (1.0 / 9007199254740992.0);
+    double uz = u * z->zetan;
+    if (uz < 1) return 0;
+    if (uz < 1 + pow(0.5, z->theta)) return 1;
+    long r = (long)(z->n * pow(z->eta * u - z->eta + 1, z->alpha));
+    return r < z->n ? r : z->n - 1;
+}
+
+/* ---------- Measurements ---------- */
+// Counts last-level cache misses of this thread in user space; -1 if the
+// kernel does not allow it (perf_event_paranoid, containers)
+static int ib_perf_fd = -2;
+
+static inline long long ib_misses(void) {
+    if (ib_perf_fd == -2) {
+        struct perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.size = sizeof(attr);
+        attr.config = PERF_COUNT_HW_CACHE_MISSES;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        ib_perf_fd = (int)syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+    }
+    long long count;
+    if (ib_perf_fd < 0 || read(ib_perf_fd, &count, sizeof(count)) != sizeof(count))
+        return -1;
+    return count;
+}
+
+static inline long ib_heap_bytes(void) {
+#ifdef __GLIBC__
+    struct mallinfo2 mi = mallinfo2();
+    return (long)(mi.uordblks + mi.hblkhd);
+#else
+    return -1;
+#endif
+}
+
+typedef struct {
+    const char *op;
+    long count, stride, kept;
+    double total;
+    double *lat;
+    long long misses;   // -1 when not measured separately
+} IbStat;
+
+static inline void ib_stat_init(IbStat *s, const char *op, long expected) {
+    s->op = op;
+    s->count = s->kept = 0;
+    s->stride = expected / IB_SAMPLES + 1;
+    s->total = 0;
+    s->lat = (double *)malloc(IB_SAMPLES * sizeof(double));
+    s->misses = -1;
+}
+
+static inline void ib_stat_add(IbStat *s, double t) {
+    s->total += t;
+    if (s->count++ % s->stride == 0 && s->kept < IB_SAMPLES)
+        s->lat[s->kept++] = t;
+}
+
+static int ib_cmp_double(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+static inline void ib_stat_print(IbStat *s, const char *name, const char *workload, long n, double bytesPerKey) {
+    if (s->count == 0) {
+        free(s->lat);
+        return;
+    }
+    qsort(s->lat, s->kept, sizeof(double), ib_cmp_double);
+    char misses[32] = "n/a";
+    if (s->misses >= 0)
+        snprintf(misses, sizeof(misses), "%.2f", (double)s->misses / s->count);
+    printf("%-12s %-10s %10ld %-7s %12.0f %9.0f %9.0f %10s %10.1f\n", name, workload, n, s->op,
+           s->count / s->total, s->lat[s->kept / 2] * 1e9, s->lat[(long)(s->kept * 0.99)] * 1e9,
+           misses, bytesPerKey);
+    free(s->lat);
+}
+
+/* ---------- Workloads ---------- */
+enum { IB_UNIFORM, IB_SEQUENTIAL, IB_ZIPF, IB_SLIDING };
+static const char *ib_workloads[] = { "uniform", "sequential", "zipf", "sliding" };
+
+static inline void ib_shuffle(int *a, long n, unsigned long long *seed) {
+    for (long i = n - 1; i > 0; i--) {
+        long j = (long)(ib_rand(seed) % (unsigned long long)(i + 1));
+        int t = a[i];
+        a[i] = a[j];
+        a[j] = t;
+    }
+}
+
+// Times `expr` as one operation of stat `s`
+#define IB_TIME(s, expr) do {                \
+        double ib_t0 = ib_now();             \
+        expr;                                \
+        ib_stat_add((s), ib_now() - ib_t0);  \
+    } while (0)
+
+// Runs one workload at size n and prints one line per operation
+static inline void ib_run(const char *name, int w, long n, long ops, double theta) {
+    unsigned long long seed = 0x9E3779B97F4A7C15ull ^ (unsigned long long)n;
+    long long m0;
+    long hits = 0, falseHits = 0, scanned = 0;
+    int *order = (int *)malloc(n * sizeof(int));
+    for (long i = 0; i < n; i++)
+        order[i] = ib_key(i);
+    if (w == IB_UNIFORM || w == IB_ZIPF)
+        ib_shuffle(order, n, &seed);
+
+    IbZipf zipf;
+    if (w == IB_ZIPF)
+        ib_zipf_init(&zipf, n, theta);
+    // index of the next lookup / scan start; zipf ranks map through the
+    // shuffled load order so the hot keys are spread over the key space
+#define IB_NEXT(i) (w == IB_UNIFORM ? (long)(ib_rand(&seed) % n) : \
+                    w == IB_ZIPF ? (long)(order[ib_zipf_next(&zipf, &seed)] / 2) : (long)((i) % n))
+
+    IbStat ins, fnd, mis, rng, ers;
+    ib_stat_init(&ins, "insert", w == IB_SLIDING ? n + ops : n);
+    ib_stat_init(&fnd, "find", ops);
+    ib_stat_init(&mis, "miss", ops);
+    ib_stat_init(&rng, "range", ops / 10);
+    ib_stat_init(&ers, "erase", w == IB_SLIDING ? ops : n);
+    ib_reset();
+    long heap0 = ib_heap_bytes();
+
+    m0 = ib_misses();
+    for (long i = 0; i < n; i++)
+        IB_TIME(&ins, ib_insert(order[i]));
+    if (m0 >= 0) ins.misses = ib_misses() - m0;
+    long heap1 = ib_heap_bytes();
+    double bytesPerKey = heap0 >= 0 ? (double)(heap1 - heap0) / n : -1;
+
+    if (w != IB_SLIDING) {
+        m0 = ib_misses();
+        for (long i = 0; i < ops; i++) {
+            int key = ib_key(IB_NEXT(i));
+            IB_TIME(&fnd, hits += ib_find(key));
+        }
+        if (m0 >= 0) fnd.misses = ib_misses() - m0;
+
+        // the same key distribution, one below each key: never present
+        m0 = ib_misses();
+        for (long i = 0; i < ops; i++) {
+            int key = ib_key(IB_NEXT(i)) - 1;
+            IB_TIME(&mis, falseHits += ib_find(key));
+        }
+        if (m0 >= 0) mis.misses = ib_misses() - m0;
+
+        m0 = ib_misses();
+        for (long i = 0; i < ops / 10; i++) {
+            int key = ib_key(IB_NEXT(i * IB_SCAN_KEYS));
+            IB_TIME(&rng, scanned += ib_range(key, key + 2 * IB_SCAN_KEYS));
+        }
+        if (m0 >= 0) rng.misses = ib_misses() - m0;
+
+        if (w != IB_SEQUENTIAL)
+            ib_shuffle(order, n, &seed);
+        m0 = ib_misses();
+        for (long i = 0; i < n; i++)
+            IB_TIME(&ers, ib_erase(order[i]));
+        if (m0 >= 0) ers.misses = ib_misses() - m0;
+    } else {
+        // one miss count for the whole step, reported on the "step" line
+        IbStat step;
+        ib_stat_init(&step, "step", ops);
+        m0 = ib_misses();
+        for (long i = 0; i < ops; i++) {
+            double t0 = ib_now();
+            IB_TIME(&ins, ib_insert(ib_key(n + i)));
+            IB_TIME(&ers, ib_erase(ib_key(i)));
+            int key = ib_key(i + 1 + (long)(ib_rand(&seed) % n));
+            IB_TIME(&fnd, hits += ib_find(key));
+            if (i % 10 == 0)
+                IB_TIME(&rng, scanned += ib_range(key, key + 2 * IB_SCAN_KEYS));
+            ib_stat_add(&step, ib_now() - t0);
+        }
+        if (m0 >= 0) step.misses = ib_misses() - m0;
+        ib_stat_print(&step, name, ib_workloads[w], n, bytesPerKey);
+    }
+#undef IB_NEXT
+
+    ib_stat_print(&ins, name, ib_workloads[w], n, bytesPerKey);
+    ib_stat_print(&fnd, name, ib_workloads[w], n, bytesPerKey);
+    ib_stat_print(&mis, name, ib_workloads[w], n, bytesPerKey);
+    ib_stat_print(&rng, name, ib_workloads[w], n, bytesPerKey);
+    ib_stat_print(&ers, name, ib_workloads[w], n, bytesPerKey);
+    if (hits != ops || falseHits != 0 || scanned <= 0)
+        printf("%-12s %-10s %10ld WRONG: %ld of %ld lookups hit, %ld absent keys found, %ld keys scanned\n",
+               name, ib_workloads[w], n, hits, ops, falseHits, scanned);
+    ib_reset();
+    free(order);
+}
+
+// maxSorted > 0 limits the sequential and sliding workloads, which load
+// keys in ascending order, to that many keys (for unbalanced trees)
+static inline int ib_main(int argc, char **argv, const char *name, long maxSorted) {
+    long sizes[16] = { 1000, 100000, 1000000 };
+    int nsizes = 3, run[4] = { 1, 1, 1, 1 };
+    long ops = 1000000;
+    double theta = 0.99;
+
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (strcmp(argv[i], "--n") == 0) {
+            nsizes = 0;
+            for (char *p = argv[i + 1]; *p != '\0' && nsizes < 16; p += *p == ',') {
+                char *end;
+                sizes[nsizes++] = (long)strtod(p, &end);   // accepts 1e6
+                p = end;
+            }
+        } else if (strcmp(argv[i], "--ops") == 0) {
+            ops = (long)strtod(argv[i + 1], NULL);
+        } else if (strcmp(argv[i], "--theta") == 0) {
+            theta = atof(argv[i + 1]);
+            if (!(theta > 0 && theta < 1)) {
+                fprintf(stderr, "--theta must be between 0 and 1 (exclusive)\n");
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--workload") == 0) {
+            for (int w = 0; w < 4; w++)
+                run[w] = strstr(argv[i + 1], ib_workloads[w]) != NULL;
+        } else {
+            fprintf(stderr, "unknown option %s\n", argv[i]);
+            return 1;
+        }
+    }
+
+    printf("%-12s %-10s %10s %-7s %12s %9s %9s %10s %10s\n", "index", "workload", "n", "op",
+           "ops/s", "p50(ns)", "p99(ns)", "LLC-miss", "bytes/key");
+    for (int s = 0; s < nsizes; s++)
+        for (int w = 0; w < 4; w++) {
+            if (!run[w]) continue;
+            if (maxSorted > 0 && (w == IB_SEQUENTIAL || w == IB_SLIDING) && sizes[s] > maxSorted) {
+                printf("%-12s %-10s %10ld skipped: ascending keys degrade this tree to a list\n",
+                       name, ib_workloads[w], sizes[s]);
+                continue;
+            }
+            ib_run(name, w, sizes[s], ops, theta);
+            fflush(stdout);
+        }
+    return 0;
+}
+
+#endif /* INDEX_BENCH_H */
@@ -0,0 +1,134 @@
+/*
+   indexed_heap.h - 4-ary min-heap of vertices with decrease-key.
+
+   Each entry holds a vertex and its 64-bit key side by side, so a sift
+   compares keys that share cache lines, and pos[v] records where vertex v
+   sits (-1 when it is not in the heap). With four children per node the
+   heap is half as deep as a binary heap. An entry is 16 bytes and the
+   children of slot i are 4i+1 .. 4i+4, so the array is 64-byte aligned
+   and starts three entries into its line: every group of four siblings
+   then fills exactly one cache line.
+
+   ih_push inserts a vertex or lowers its key, ih_update also raises it,
+   and ih_pop removes the minimum.
+*/
+#ifndef INDEXED_HEAP_H
+#define INDEXED_HEAP_H
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct {
+    int64_t key;
+    int v;
+} IhEntry;
+
+#define IH_LINE 64
+#define IH_SKEW 3       // slots before a[0], so a[4i+1] starts a line
+
+typedef struct {
+    IhEntry *a;     // heap slots, a = mem + IH_SKEW
+    IhEntry *mem;
+    int *pos;       // slot of each vertex, -1 if absent
+    int size, n;
+} IndexedHeap;
+
+static inline void ih_init(IndexedHeap *h, int n) {
+    size_t bytes = ((size_t)(n > 0 ? n : 1) + IH_SKEW) * sizeof(IhEntry);
+    bytes = (bytes + IH_LINE - 1) / IH_LINE * IH_LINE;  // aligned_alloc wants a multiple
+    h->mem = (IhEntry *)aligned_alloc(IH_LINE, bytes);
+    h->a = h->mem + IH_SKEW;
+    h->pos = (int *)malloc((size_t)(n > 0 ? n : 1) * sizeof(int));
+    memset(h->pos, 0xFF, (size_t)n * sizeof(int));
+    h->size = 0;
+    h->n = n;
+}
+
+static inline void ih_free(IndexedHeap *h) {
+    free(h->mem);
+    free(h->pos);
+}
+
+static inline int ih_empty(const IndexedHeap *h) { return h->size == 0; }
+
+static inline int ih_contains(const IndexedHeap *h, int v) { return h->pos[v] >= 0; }
+
+// Empties the heap in O(size), leaving pos[] ready for reuse
+static inline void ih_clear(IndexedHeap *h) {
+    for (int i = 0; i < h->size; i++)
+        h->pos[h->a[i].v] = -1;
+    h->size = 0;
+}
+
+static inline void ih_sift_up(IndexedHeap *h, int i) {
+    IhEntry x = h->a[i];
+    while (i > 0) {
+        int p = (i - 1) >> 2;
+        if (h->a[p].key <= x.key) break;
+        h->a[i] = h->a[p];
+        h->pos[h->a[i].v] = i;
+        i = p;
+    }
+    h->a[i] = x;
+    h->pos[x.v] = i;
+}
+
+static inline void ih_sift_down(IndexedHeap *h, int i) {
+    IhEntry x = h->a[i];
+    for (;;) {
+        int c = 4 * i + 1;
+        if (c >= h->size) break;
+        int end = c + 4 < h->size ? c + 4 : h->size, best = c;
+        for (int j = c + 1; j < end; j++)
+            if (h->a[j].key < h->a[best].key) best = j;
+        if (h->a[best].key >= x.key) break;
+        h->a[i] = h->a[best];
+        h->pos[h->a[i].v] = i;
+        i = best;
+    }
+    h->a[i] = x;
+    h->pos[x.v] = i;
+}
+
+// Inserts v with key, or lowers v's key; a larger key is ignored
+static inline void ih_push(IndexedHeap *h, int v, int64_t key) {
+    int i = h->pos[v];
+    if (i < 0) {
+        i = h->size++;
+        h->a[i] = (IhEntry){ key, v };
+    } else if (key < h->a[i].key) {
+        h->a[i].key = key;
+    } else {
+        return;
+    }
+    ih_sift_up(h, i);
+}
+
+// Sets v's key to any value, higher or lower (inserts v if absent)
+static inline void ih_update(IndexedHeap *h, int v, int64_t key) {
+    int i = h->pos[v];
+    if (i < 0) {
+        ih_push(h, v, key);
+        return;
+    }
+    int64_t old = h->a[i].key;
+    h->a[i].key = key;
+    if (key < old) ih_sift_up(h, i);
+    else ih_sift_down(h, i);
+}
+
+static inline int64_t ih_min_key(const IndexedHeap *h) { return h->a[0].key; }
+
+// Removes and returns the vertex with the smallest key
+static inline int ih_pop(IndexedHeap *h) {
+    int v = h->a[0].v;
+    h->pos[v] = -1;
+    if (--h->size > 0) {
+        h->a[0] = h->a[h->size];
+        ih_sift_down(h, 0);
+    }
+    return v;
+}
+
+#endif /* INDEXED_HEAP_H */
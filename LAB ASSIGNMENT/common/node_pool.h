@@ -0,0 +1,272 @@
+/*
+   node_pool.h - slab allocator for fixed-size tree nodes.
+
+   Requests are rounded up to a size class (multiples of 8 bytes, up to
+   NP_MAX_SIZE). Each class carves nodes out of slabs of NP_SLAB_SLOTS nodes,
+   so nodes allocated together sit next to each other in memory. Freed nodes
+   go onto a per-class free list threaded through the nodes themselves, and
+   np_destroy releases every slab at once, so trees do not need a recursive
+   free pass.
+
+   Every node also has a 32-bit handle (class | slab | slot). np_alloc_handle,
+   np_at and np_free_handle let a structure store 4-byte links instead of
+   8-byte pointers, which shrinks small nodes by a size class or more.
+
+   Pools are single-threaded by default. np_init(&pool, 1) makes them safe to
+   share: a mutex protects the slabs, and each thread keeps a small cache of
+   free nodes per class so most calls do not take the lock. A thread should
+   call np_thread_flush before it exits so its cached nodes go back to the pool.
+*/
+#ifndef NODE_POOL_H
+#define NODE_POOL_H
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <pthread.h>
+
+#define NP_ALIGN       8
+#define NP_MAX_SIZE    256                       // largest node size served
+#define NP_CLASSES     (NP_MAX_SIZE / NP_ALIGN)  // 32 size classes
+#define NP_SLOT_BITS   12
+#define NP_SLAB_SLOTS  (1u << NP_SLOT_BITS)      // 4096 nodes per slab
+#define NP_SLAB_BITS   15                        // up to 32768 slabs per class
+#define NP_CACHE_SIZE  64                        // per-thread cached nodes per class
+#define NP_NULL        0xFFFFFFFFu               // null handle
+
+typedef struct np_free_node {
+    struct np_free_node *next;
+} np_free_node;
+
+typedef struct {
+    size_t size;            // node size of this class
+    char **slabs;           // slab base pointers
+    uint32_t nslabs, cap;
+    uint32_t used;          // slots handed out from the newest slab
+    np_free_node *freeList;
+    uint32_t freeHandles;   // free list of handle-addressed nodes
+    size_t live;            // nodes handed out (thread caches count as live)
+} np_class;
+
+typedef struct {
+    np_class cls[NP_CLASSES];
+    int threadSafe;
+    pthread_mutex_t lock;
+    unsigned generation;    // changes on destroy so stale thread caches are dropped
+} NodePool;
+
+typedef struct {
+    NodePool *owner;
+    unsigned generation;
+    int count;
+    void *items[NP_CACHE_SIZE];
+} np_cache;
+
+static _Thread_local np_cache np_tcache[NP_CLASSES];
+
+static inline int np_class_of(size_t size) {
+    if (size < sizeof(np_free_node)) size = sizeof(np_free_node);
+    return (int)((size + NP_ALIGN - 1) / NP_ALIGN) - 1;
+}
+
+static inline void np_init(NodePool *pool, int threadSafe) {
+    static unsigned generations = 0;
+    memset(pool, 0, sizeof(*pool));
+    for (int c = 0; c < NP_CLASSES; c++) {
+        pool->cls[c].size = (size_t)(c + 1) * NP_ALIGN;
+        pool->cls[c].freeHandles = NP_NULL;
+    }
+    pool->threadSafe = threadSafe;
+    pool->generation = __atomic_add_fetch(&generations, 1, __ATOMIC_RELAXED);
+    if (threadSafe) pthread_mutex_init(&pool->lock, NULL);
+}
+
+// Takes one node from a class (caller holds the lock if the pool is shared)
+static inline void *np_class_take(np_class *cl, int c, uint32_t *handle) {
+    if (cl->freeList != NULL && handle == NULL) {
+        np_free_node *n = cl->freeList;
+        cl->freeList = n->next;
+        cl->live++;
+        return n;
+    }
+    if (cl->nslabs == 0 || cl->used == NP_SLAB_SLOTS) {
+        if (cl->nslabs == (1u << NP_SLAB_BITS) - 1) return NULL;  // keeps NP_NULL unused
+        if (cl->nslabs == cl->cap) {
+            uint32_t cap = cl->cap ? 2 * cl->cap : 8;
+            char **slabs = (char **)realloc(cl->slabs, cap * sizeof(char *));
+            if (slabs == NULL) return NULL;
+            cl->slabs = slabs;
+            cl->cap = cap;
+        }
+        char *slab = (char *)malloc(cl->size * NP_SLAB_SLOTS);
+        if (slab == NULL) return NULL;
+        cl->slabs[cl->nslabs++] = slab;
+        cl->used = 0;
+    }
+    uint32_t slab = cl->nslabs - 1, slot = cl->used++;
+    if (handle != NULL)
+        *handle = ((uint32_t)c << (NP_SLAB_BITS + NP_SLOT_BITS)) | (slab << NP_SLOT_BITS) | slot;
+    cl->live++;
+    return cl->slabs[slab] + (size_t)slot * cl->size;
+}
+
+// Allocates one node of `size` bytes (uninitialized)
+static inline void *np_alloc(NodePool *pool, size_t size) {
+    int c = np_class_of(size);
+    if (c >= NP_CLASSES) return malloc(size);
+    np_class *cl = &pool->cls[c];
+
+    if (!pool->threadSafe)
+        return np_class_take(cl, c, NULL);
+
+    // a cache left over from another pool is dropped (its nodes stay
+    // reserved until that pool is destroyed)
+    np_cache *tc = &np_tcache[c];
+    if (tc->owner != pool || tc->generation != pool->generation) {
+        tc->owner = pool;
+        tc->generation = pool->generation;
+        tc->count = 0;
+    }
+    if (tc->count == 0) {
+        // refill half of the cache under one lock
+        pthread_mutex_lock(&pool->lock);
+        while (tc->count < NP_CACHE_SIZE / 2) {
+            void *p = np_class_take(cl, c, NULL);
+            if (p == NULL) break;
+            tc->items[tc->count++] = p;
+        }
+        pthread_mutex_unlock(&pool->lock);
+        if (tc->count == 0) return NULL;
+    }
+    return tc->items[--tc->count];
+}
+
+// Returns a node to its class free list
+static inline void np_free(NodePool *pool, void *p, size_t size) {
+    if (p == NULL) return;
+    int c = np_class_of(size);
+    if (c >= NP_CLASSES) {
+        free(p);
+        return;
+    }
+    np_class *cl = &pool->cls[c];
+
+    if (pool->threadSafe) {
+        np_cache *tc = &np_tcache[c];
+        if (tc->owner != pool || tc->generation != pool->generation) {
+            tc->owner = pool;
+            tc->generation = pool->generation;
+            tc->count = 0;
+        }
+        if (tc->count < NP_CACHE_SIZE) {
+            tc->items[tc->count++] = p;
+            return;
+        }
+        // cache full: hand half of it back under one lock
+        pthread_mutex_lock(&pool->lock);
+        while (tc->count > NP_CACHE_SIZE / 2) {
+            np_free_node *n = (np_free_node *)tc->items[--tc->count];
+            n->next = cl->freeList;
+            cl->freeList = n;
+            cl->live--;
+        }
+        np_free_node *n = (np_free_node *)p;
+        n->next = cl->freeList;
+        cl->freeList = n;
+        cl->live--;
+        pthread_mutex_unlock(&pool->lock);
+        return;
+    }
+
+    np_free_node *n = (np_free_node *)p;
+    n->next = cl->freeList;
+    cl->freeList = n;
+    cl->live--;
+}
+
+// Returns this thread's cached nodes to the pool
+static inline void np_thread_flush(NodePool *pool) {
+    if (!pool->threadSafe) return;
+    pthread_mutex_lock(&pool->lock);
+    for (int c = 0; c < NP_CLASSES; c++) {
+        np_cache *tc = &np_tcache[c];
+        if (tc->owner != pool || tc->generation != pool->generation) continue;
+        while (tc->count > 0) {
+            np_free_node *n = (np_free_node *)tc->items[--tc->count];
+            n->next = pool->cls[c].freeList;
+            pool->cls[c].freeList = n;
+            pool->cls[c].live--;
+        }
+    }
+    pthread_mutex_unlock(&pool->lock);
+}
+
+// Pointer for a handle
+static inline void *np_at(NodePool *pool, uint32_t h) {
+    if (h == NP_NULL) return NULL;
+    np_class *cl = &pool->cls[h >> (NP_SLAB_BITS + NP_SLOT_BITS)];
+    uint32_t slab = (h >> NP_SLOT_BITS) & ((1u << NP_SLAB_BITS) - 1);
+    uint32_t slot = h & (NP_SLAB_SLOTS - 1);
+    return cl->slabs[slab] + (size_t)slot * cl->size;
+}
+
+// Allocates a node addressed by a 32-bit handle. Handle nodes have their
+// own free list, since a recycled pointer would not carry its handle.
+static inline uint32_t np_alloc_handle(NodePool *pool, size_t size) {
+    int c = np_class_of(size);
+    if (c >= NP_CLASSES) return NP_NULL;
+    np_class *cl = &pool->cls[c];
+    uint32_t h = NP_NULL;
+    if (pool->threadSafe) pthread_mutex_lock(&pool->lock);
+    if (cl->freeHandles != NP_NULL) {
+        h = cl->freeHandles;
+        cl->freeHandles = *(uint32_t *)np_at(pool, h);
+        cl->live++;
+    } else {
+        np_class_take(cl, c, &h);
+    }
+    if (pool->threadSafe) pthread_mutex_unlock(&pool->lock);
+    return h;
+}
+
+static inline void np_free_handle(NodePool *pool, uint32_t h) {
+    if (h == NP_NULL) return;
+    np_class *cl = &pool->cls[h >> (NP_SLAB_BITS + NP_SLOT_BITS)];
+    if (pool->threadSafe) pthread_mutex_lock(&pool->lock);
+    *(uint32_t *)np_at(pool, h) = cl->freeHandles;
+    cl->freeHandles = h;
+    cl->live--;
+    if (pool->threadSafe) pthread_mutex_unlock(&pool->lock);
+}
+
+// Bytes reserved in slabs, and number of live nodes
+static inline size_t np_reserved_bytes(const NodePool *pool) {
+    size_t total = 0;
+    for (int c = 0; c < NP_CLASSES; c++)
+        total += (size_t)pool->cls[c].nslabs * NP_SLAB_SLOTS * pool->cls[c].size;
+    return total;
+}
+
+static inline size_t np_live_nodes(const NodePool *pool) {
+    size_t total = 0;
+    for (int c = 0; c < NP_CLASSES; c++) total += pool->cls[c].live;
+    return total;
+}
+
+// Frees every slab at once; all nodes from the pool become invalid
+static inline void np_destroy(NodePool *pool) {
+    for (int c = 0; c < NP_CLASSES; c++) {
+        np_class *cl = &pool->cls[c];
+        for (uint32_t s = 0; s < cl->nslabs; s++) free(cl->slabs[s]);
+        free(cl->slabs);
+        cl->slabs = NULL;
+        cl->nslabs = cl->cap = cl->used = 0;
+        cl->freeList = NULL;
+        cl->freeHandles = NP_NULL;
+        cl->live = 0;
+    }
+    if (pool->threadSafe) pthread_mutex_destroy(&pool->lock);
+    pool->generation = 0;
+}
+
+#endif /* NODE_POOL_H */